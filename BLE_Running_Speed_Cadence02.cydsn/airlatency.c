@@ -0,0 +1,176 @@
+/*******************************************************************************
+* File Name: airlatency.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the histogram of the age of the RSC Measurement when
+*  its notification is handed to the stack.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "airlatency.h"
+
+#define DEBUG_MODULE_LEVEL      (RSCS_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Ages beyond the histogram are counted in the last bucket */
+#define AIRLATENCY_RANGE_MS                 (AIRLATENCY_BUCKET_MS * AIRLATENCY_BUCKETS)
+
+
+/***************************************
+*        Global Variables
+***************************************/
+AIRLATENCY_T            airLatency;
+
+
+/*******************************************************************************
+* Function Name: AirLatencyRecord
+********************************************************************************
+*
+* Summary:
+*  Counts the age of a measurement whose notification the stack accepted,
+*  and reports the percentiles every AIRLATENCY_REPORT_PERIOD notifications.
+*
+* Parameters:
+*  produced: Tick count when the measurement was produced.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AirLatencyRecord(uint32 produced)
+{
+    uint32 ticks = SwTimerGetTicks() - produced;
+    uint32 ms;
+    uint8 bucket;
+    uint8 i;
+
+    /* Keep the conversion in 32 bits */
+    if(ticks > SWTIMER_MS_TO_TICKS(AIRLATENCY_RANGE_MS))
+    {
+        ticks = SWTIMER_MS_TO_TICKS(AIRLATENCY_RANGE_MS);
+    }
+    ms = (ticks * 1000u) / SWTIMER_TICKS_PER_SEC;
+
+    bucket = (uint8) (ms / AIRLATENCY_BUCKET_MS);
+    if(bucket >= AIRLATENCY_BUCKETS)
+    {
+        bucket = AIRLATENCY_BUCKETS - 1u;
+    }
+    if(0xFFFFu == airLatency.buckets[bucket])
+    {
+        for(i = 0u; i < AIRLATENCY_BUCKETS; i++)
+        {
+            airLatency.buckets[i] >>= 1u;
+        }
+    }
+    airLatency.buckets[bucket]++;
+
+    if((airLatency.sumMs + ms) < airLatency.sumMs)
+    {
+        airLatency.sumMs >>= 1u;
+        airLatency.sumCount >>= 1u;
+    }
+    airLatency.sumMs += ms;
+    airLatency.sumCount++;
+
+    if(ms > airLatency.maxMs)
+    {
+        airLatency.maxMs = ms;
+    }
+
+    airLatency.count++;
+    if(0u == (airLatency.count % AIRLATENCY_REPORT_PERIOD))
+    {
+        AirLatencyReport();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: AirLatencyPercentile
+********************************************************************************
+*
+* Summary:
+*  Returns a percentile of the ages from the histogram.
+*
+* Parameters:
+*  percent: Percentile, 1 to 100.
+*
+* Return:
+*  Upper edge in ms of the bucket the percentile falls into, at most the
+*  maximum age, 0 before the first notification.
+*
+*******************************************************************************/
+uint32 AirLatencyPercentile(uint8 percent)
+{
+    uint32 total = 0u;
+    uint32 rank;
+    uint32 seen = 0u;
+    uint32 edge;
+    uint8 i;
+
+    for(i = 0u; i < AIRLATENCY_BUCKETS; i++)
+    {
+        total += airLatency.buckets[i];
+    }
+    if(0u == total)
+    {
+        return(0u);
+    }
+
+    /* Rank of the percentile, rounded up */
+    rank = ((total * percent) + 99u) / 100u;
+    for(i = 0u; i < (AIRLATENCY_BUCKETS - 1u); i++)
+    {
+        seen += airLatency.buckets[i];
+        if(seen >= rank)
+        {
+            break;
+        }
+    }
+    edge = ((uint32) i + 1u) * AIRLATENCY_BUCKET_MS;
+    return((edge < airLatency.maxMs) ? edge : airLatency.maxMs);
+}
+
+
+/*******************************************************************************
+* Function Name: AirLatencyReport
+********************************************************************************
+*
+* Summary:
+*  Writes the percentiles, the mean and the maximum age to the binary log.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void AirLatencyReport(void)
+{
+    if(0u != airLatency.count)
+    {
+        BINLOG_INFO(BINLOG_EVT_AIR_LATENCY, airLatency.count, AirLatencyPercentile(50u),
+            AirLatencyPercentile(90u), AirLatencyPercentile(99u));
+        BINLOG_INFO(BINLOG_EVT_AIR_LATENCY_MAX, airLatency.sumMs / airLatency.sumCount, airLatency.maxMs);
+    }
+}
+
+
+/* [] END OF FILE */
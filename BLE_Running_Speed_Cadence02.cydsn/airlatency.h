@@ -0,0 +1,70 @@
+/*******************************************************************************
+* File Name: airlatency.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the stride-to-air
+*  latency histogram. The RSC Measurement is stamped with the tick count
+*  when ProcessStride() or UpdatePace() change it, and the age of the value
+*  is taken when the stack accepts its notification. The link layer sends
+*  it at the next connection event the device attends.
+*
+*  The ages go into AIRLATENCY_BUCKETS buckets of AIRLATENCY_BUCKET_MS, the
+*  last one also takes the older values and the maximum stops at its upper
+*  edge. The percentiles are the upper edges of the buckets they fall into,
+*  at most the maximum. BINLOG_EVT_AIR_LATENCY and BINLOG_EVT_AIR_LATENCY_MAX
+*  report them every AIRLATENCY_REPORT_PERIOD notifications and when the
+*  Client disconnects.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+#define AIRLATENCY_BUCKET_MS                (50u)
+#define AIRLATENCY_BUCKETS                  (64u)
+
+/* Notifications between two reports, about five minutes */
+#define AIRLATENCY_REPORT_PERIOD            (100u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint32 count;
+    /* Sum of the ages in ms over sumCount values, both halved on overflow */
+    uint32 sumMs;
+    uint32 sumCount;
+    uint32 maxMs;
+    /* Halved all together when one of them overflows */
+    uint16 buckets[AIRLATENCY_BUCKETS];
+} AIRLATENCY_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void AirLatencyRecord(uint32 produced);
+uint32 AirLatencyPercentile(uint8 percent);
+void AirLatencyReport(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern AIRLATENCY_T             airLatency;
+
+
+/* [] END OF FILE */
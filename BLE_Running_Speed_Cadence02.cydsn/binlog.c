@@ -0,0 +1,278 @@
+/*******************************************************************************
+* File Name: binlog.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the binary debug log. Log sites store an event
+*  identifier and its arguments in a RAM ring buffer instead of formatting
+*  text, and the buffer is sent to UART_DEB in one burst every
+*  BINLOG_FLUSH_PERIOD_MS or when it fills up. The UART is therefore idle, and
+*  Deep Sleep allowed, on all the other connection events.
+*
+*  The log is not reentrant and must only be written from the main loop
+*  context (including the BLE event callbacks), not from interrupts.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+#define BINLOG_EVENT_ARGC(id, argc, format) argc,
+
+static const uint8  binLogArgc[BINLOG_EVT_COUNT] = { BINLOG_EVENT_TABLE(BINLOG_EVENT_ARGC) };
+
+static uint8        binLogBuffer[BINLOG_BUFFER_SIZE];
+static uint16       binLogHead = 0u;
+static uint16       binLogTail = 0u;
+static uint32       binLogBaseTick = 0u;
+static uint32       binLogLastTick = 0u;
+static uint32       binLogDropped = 0u;
+static uint8        binLogFlushDue = NO;
+
+
+/*******************************************************************************
+* Function Name: BinLogUsed
+********************************************************************************
+*
+* Summary:
+*  Returns the number of bytes waiting in the ring buffer.
+*
+*******************************************************************************/
+static uint16 BinLogUsed(void)
+{
+    return((uint16) ((binLogHead - binLogTail) & BINLOG_BUFFER_MASK));
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogPutVarint
+********************************************************************************
+*
+* Summary:
+*  Stores a value in the ring buffer as an LEB128 varint.
+*
+*******************************************************************************/
+static void BinLogPutVarint(uint32 value)
+{
+    while(value > BINLOG_VARINT_MASK)
+    {
+        binLogBuffer[binLogHead] = (uint8) ((value & BINLOG_VARINT_MASK) | BINLOG_VARINT_MORE);
+        binLogHead = (binLogHead + 1u) & BINLOG_BUFFER_MASK;
+        value >>= BINLOG_VARINT_SHIFT;
+    }
+    binLogBuffer[binLogHead] = (uint8) value;
+    binLogHead = (binLogHead + 1u) & BINLOG_BUFFER_MASK;
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogPutRecord
+********************************************************************************
+*
+* Summary:
+*  Stores a record without checking for free space.
+*
+*******************************************************************************/
+static void BinLogPutRecord(uint8 id, const uint32 *args)
+{
+    uint32 now = SwTimerGetTicks();
+    uint8 i;
+
+    if(0u == BinLogUsed())
+    {
+        binLogBaseTick = now;
+        binLogLastTick = now;
+    }
+
+    binLogBuffer[binLogHead] = id;
+    binLogHead = (binLogHead + 1u) & BINLOG_BUFFER_MASK;
+    BinLogPutVarint(now - binLogLastTick);
+    binLogLastTick = now;
+
+    for(i = 0u; i < binLogArgc[id]; i++)
+    {
+        BinLogPutVarint(args[i]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogFlushTimerCallback
+********************************************************************************
+*
+* Summary:
+*  Marks the periodic flush as due. The flush itself is done by
+*  BinLogProcess() from the main loop.
+*
+*******************************************************************************/
+static void BinLogFlushTimerCallback(void)
+{
+    binLogFlushDue = YES;
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogInit
+********************************************************************************
+*
+* Summary:
+*  Empties the log and starts the periodic flush timer. Must be called after
+*  SwTimerInit().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BinLogInit(void)
+{
+    binLogHead = 0u;
+    binLogTail = 0u;
+    binLogDropped = 0u;
+    binLogFlushDue = NO;
+
+    SwTimerStart(SWTIMER_LOG, SWTIMER_MS_TO_TICKS(BINLOG_FLUSH_PERIOD_MS), &BinLogFlushTimerCallback);
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogWrite
+********************************************************************************
+*
+* Summary:
+*  Appends a log record. Only the number of arguments listed for the event in
+*  BINLOG_EVENT_TABLE is stored. The record is dropped, and counted, when the
+*  buffer has no room for it. Use BINLOG(), or the BINLOG_<LEVEL>() macros
+*  of debug.h, rather than calling this function directly.
+*
+* Parameters:
+*  id:        Event identifier, BINLOG_EVT_*.
+*  arg0-arg3: Event arguments.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BinLogWrite(uint8 id, uint32 arg0, uint32 arg1, uint32 arg2, uint32 arg3)
+{
+    uint32 args[BINLOG_MAX_ARGS];
+
+    /* Keep room for the record that reports the dropped ones */
+    if((BINLOG_BUFFER_SIZE - 1u - BinLogUsed()) < (BINLOG_MAX_RECORD_SIZE + BINLOG_DROPPED_RECORD_SIZE))
+    {
+        binLogDropped++;
+        binLogFlushDue = YES;
+    }
+    else
+    {
+        args[0u] = arg0;
+        args[1u] = arg1;
+        args[2u] = arg2;
+        args[3u] = arg3;
+        BinLogPutRecord(id, args);
+
+        if(BinLogUsed() >= BINLOG_HIGH_WATER)
+        {
+            binLogFlushDue = YES;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogProcess
+********************************************************************************
+*
+* Summary:
+*  Flushes the log if a flush is due. Called from the main loop.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BinLogProcess(void)
+{
+    if(YES == binLogFlushDue)
+    {
+        BinLogFlush();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BinLogFlush
+********************************************************************************
+*
+* Summary:
+*  Sends the buffered records to UART_DEB as one frame.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void BinLogFlush(void)
+{
+    uint8 header[BINLOG_FRAME_HEADER_SIZE];
+    uint16 used;
+    uint16 chunk;
+
+    if(0u != binLogDropped)
+    {
+        BinLogPutRecord(BINLOG_EVT_DROPPED, &binLogDropped);
+        binLogDropped = 0u;
+    }
+
+    used = BinLogUsed();
+    if(0u != used)
+    {
+        header[0u] = BINLOG_SYNC0;
+        header[1u] = BINLOG_SYNC1;
+        header[2u] = LO8(used);
+        header[3u] = HI8(used);
+        header[4u] = LO8(LO16(binLogBaseTick));
+        header[5u] = HI8(LO16(binLogBaseTick));
+        header[6u] = LO8(HI16(binLogBaseTick));
+        header[7u] = HI8(HI16(binLogBaseTick));
+        UART_DEB_SpiUartPutArray(header, BINLOG_FRAME_HEADER_SIZE);
+
+        /* Send the ring contents in at most two contiguous pieces */
+        while(0u != used)
+        {
+            chunk = BINLOG_BUFFER_SIZE - binLogTail;
+            if(chunk > used)
+            {
+                chunk = used;
+            }
+            UART_DEB_SpiUartPutArray(&binLogBuffer[binLogTail], chunk);
+            binLogTail = (binLogTail + chunk) & BINLOG_BUFFER_MASK;
+            used -= chunk;
+        }
+    }
+
+    binLogFlushDue = NO;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* File Name: binlog.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the binary debug log.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+#include "binlog_defs.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Ring buffer size, must be a power of two */
+#define BINLOG_BUFFER_SIZE              (256u)
+#define BINLOG_BUFFER_MASK              (BINLOG_BUFFER_SIZE - 1u)
+
+/* Flush early once the buffer is three quarters full */
+#define BINLOG_HIGH_WATER               ((BINLOG_BUFFER_SIZE * 3u) / 4u)
+
+/* Event identifier plus the time delta and arguments as 32-bit varints */
+#define BINLOG_VARINT_MAX_SIZE          (5u)
+#define BINLOG_MAX_RECORD_SIZE          (1u + ((BINLOG_MAX_ARGS + 1u) * BINLOG_VARINT_MAX_SIZE))
+#define BINLOG_DROPPED_RECORD_SIZE      (1u + (2u * BINLOG_VARINT_MAX_SIZE))
+
+#define BINLOG_FLUSH_PERIOD_MS          (10000u)
+
+
+/***************************************
+*        Macros
+***************************************/
+/* BINLOG(id, args...) appends a record with up to BINLOG_MAX_ARGS arguments.
+* The missing arguments are passed as zero and are not stored. Log sites use
+* the level checked wrappers in debug.h.
+*/
+#define BINLOG(...)                     BINLOG_PAD(__VA_ARGS__, 0u, 0u, 0u, 0u, 0u)
+#define BINLOG_PAD(id, a0, a1, a2, a3, ...) \
+    BinLogWrite((id), (uint32) (a0), (uint32) (a1), (uint32) (a2), (uint32) (a3))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void BinLogInit(void);
+void BinLogWrite(uint8 id, uint32 arg0, uint32 arg1, uint32 arg2, uint32 arg3);
+void BinLogProcess(void);
+void BinLogFlush(void);
+
+
+/* [] END OF FILE */
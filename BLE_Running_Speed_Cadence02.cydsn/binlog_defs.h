@@ -0,0 +1,129 @@
+/*******************************************************************************
+* File Name: binlog_defs.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the binary debug log wire format and the table of log events. The
+*  firmware only uses the event identifiers and argument counts; the format
+*  strings are used by the host decoder (host/binlog_decode.c), so they don't
+*  take any flash on the device.
+*
+*  Frame on the UART:
+*   [BINLOG_SYNC0][BINLOG_SYNC1][length LSB][length MSB][base tick, 4 bytes LE]
+*   followed by "length" bytes of records. A record is the event identifier,
+*   the number of WDT ticks since the previous record (the first record is
+*   relative to the base tick) and the event arguments, all as LEB128 varints.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+
+/***************************************
+*          Constants
+***************************************/
+#define BINLOG_SYNC0                    (0xA5u)
+#define BINLOG_SYNC1                    (0x5Au)
+#define BINLOG_FRAME_HEADER_SIZE        (8u)
+#define BINLOG_MAX_ARGS                 (4u)
+#define BINLOG_TICKS_PER_SEC            (32768u)
+
+#define BINLOG_VARINT_MORE              (0x80u)
+#define BINLOG_VARINT_MASK              (0x7Fu)
+#define BINLOG_VARINT_SHIFT             (7u)
+
+
+/***************************************
+*        Log events
+***************************************/
+
+/* X(identifier, number of arguments, decoder format) */
+#define BINLOG_EVENT_TABLE(X) \
+    X(BINLOG_EVT_DROPPED,               1u, "%lu log records were dropped\r\n") \
+    X(BINLOG_EVT_NTF_ENABLED,           0u, "Notifications for RSC Measurement Characteristic are enabled\r\n") \
+    X(BINLOG_EVT_NTF_DISABLED,          0u, "Notifications for RSC Measurement Characteristic are disabled\r\n") \
+    X(BINLOG_EVT_IND_ENABLED,           0u, "Indications for SC Control point Characteristic are enabled\r\n") \
+    X(BINLOG_EVT_IND_DISABLED,          0u, "Indications for SC Control point Characteristic are disabled\r\n") \
+    X(BINLOG_EVT_IND_CONFIRMED,         0u, "Indication Confirmation for SC Control point was received\r\n") \
+    X(BINLOG_EVT_CP_WRITE,              3u, "Write to SC Control Point Characteristic occurred, " \
+                                            "length: %lu, op code: %lx, parameter: %08lx\r\n") \
+    X(BINLOG_EVT_CP_SET_CUMULATIVE,     0u, "Set cumulative value command was received.\r\n") \
+    X(BINLOG_EVT_CP_CALIBRATION,        0u, "Start Sensor calibration command was received.\r\n") \
+    X(BINLOG_EVT_CP_UPDATE_LOCATION,    0u, "Update sensor location command was received.\r\n") \
+    X(BINLOG_EVT_CP_LOCATION_SET,       0u, "New Sensor location was set.\r\n") \
+    X(BINLOG_EVT_CP_LOCATION_INVALID,   0u, "The requested sensor location is not supported.\r\n") \
+    X(BINLOG_EVT_CP_SUPPORTED_LOCATIONS,0u, "Supported sensor location command was received.\r\n") \
+    X(BINLOG_EVT_CP_NOT_SUPPORTED,      0u, "The procedure is not supported.\r\n") \
+    X(BINLOG_EVT_CP_UNKNOWN,            0u, "Unsupported command.\r\n") \
+    X(BINLOG_EVT_RSCS_UNKNOWN,          1u, "Unrecognised RSCS event: %lx\r\n") \
+    X(BINLOG_EVT_NTF_SENT_WALKING,      4u, "Notification is sent! Cadence: %lu, Speed: %lu, " \
+                                            "Stride length: %lu, Total distance: %lu, Status: Walking\r\n") \
+    X(BINLOG_EVT_NTF_SENT_RUNNING,      4u, "Notification is sent! Cadence: %lu, Speed: %lu, " \
+                                            "Stride length: %lu, Total distance: %lu, Status: Running\r\n") \
+    X(BINLOG_EVT_NTF_ERROR,             1u, "CyBle_RscssSendNotification() resulted with an error. " \
+                                            "Error code: %lx\r\n") \
+    X(BINLOG_EVT_IND_SENT,              2u, "CyBle_RscssSendIndication() succeeded, op code: %lx, " \
+                                            "response: %lx\r\n") \
+    X(BINLOG_EVT_IND_ERROR,             1u, "CyBle_RscssSendIndication() resulted with an error. " \
+                                            "Error code: %lx\r\n") \
+    X(BINLOG_EVT_PACE_UPDATED,          3u, "Pace updated. Cadence: %lu, Stride length: %lu, " \
+                                            "Pace: %lu s/km\r\n") \
+    X(BINLOG_EVT_CONN_PARAM,            3u, "Connection parameters: interval %lu x 1.25 ms, latency %lu, " \
+                                            "supervision timeout %lu x 10 ms\r\n") \
+    X(BINLOG_EVT_CONN_PARAM_REQ,        4u, "Connection parameter request: interval %lu-%lu x 1.25 ms, " \
+                                            "latency %lu, supervision timeout %lu x 10 ms\r\n") \
+    X(BINLOG_EVT_CONN_PARAM_REJECTED,   1u, "Connection parameter request was rejected, attempt %lu\r\n") \
+    X(BINLOG_EVT_CONN_PARAM_TIMEOUT,    1u, "Connection parameter request was not answered, attempt %lu\r\n") \
+    X(BINLOG_EVT_CONN_PARAM_ERROR,      1u, "CyBle_L2capLeConnectionParamUpdateRequest() resulted with an error. " \
+                                            "Error code: %lx\r\n") \
+    X(BINLOG_EVT_CONN_PARAM_GAVE_UP,    2u, "No more connection parameter requests, staying at interval " \
+                                            "%lu x 1.25 ms, latency %lu\r\n") \
+    X(BINLOG_EVT_CP_QUEUE_FULL,         1u, "SC Control Point response queue is full, op code %lx was " \
+                                            "not executed\r\n") \
+    X(BINLOG_EVT_IND_TIMEOUT,           0u, "Indication Confirmation for SC Control point timed out\r\n") \
+    X(BINLOG_EVT_ODOMETER_RESTORED,     2u, "Odometer restored: total distance %lu dm, record %lu\r\n") \
+    X(BINLOG_EVT_ODOMETER_SAVED,        2u, "Odometer saved: total distance %lu dm, row %lu\r\n") \
+    X(BINLOG_EVT_ODOMETER_SLOW,         1u, "Odometer row write stalled the CPU for %lu ms\r\n") \
+    X(BINLOG_EVT_ODOMETER_ERROR,        1u, "CySysFlashWriteRow() resulted with an error. Error code: %lx\r\n") \
+    X(BINLOG_EVT_WORKOUT_RESTORED,      2u, "Workout %lu is the newest, next page goes to row %lu\r\n") \
+    X(BINLOG_EVT_WORKOUT_STARTED,       2u, "Workout %lu started at row %lu\r\n") \
+    X(BINLOG_EVT_WORKOUT_STORED,        4u, "Workout %lu stored: %lu strides, %lu bytes in %lu pages\r\n") \
+    X(BINLOG_EVT_WORKOUT_ERROR,         1u, "Workout page write resulted with an error. Error code: %lx\r\n") \
+    X(BINLOG_EVT_TRANSFER_MTU,          2u, "MTU exchange: Client MTU %lu, using %lu\r\n") \
+    X(BINLOG_EVT_TRANSFER_STARTED,      2u, "Session transfer started at offset %lu, stored pages end at %lu\r\n") \
+    X(BINLOG_EVT_TRANSFER_DONE,         3u, "Session transfer done: %lu bytes in %lu notifications, " \
+                                            "next offset %lu\r\n") \
+    X(BINLOG_EVT_TRANSFER_STOPPED,      2u, "Session transfer stopped at offset %lu after %lu bytes\r\n") \
+    X(BINLOG_EVT_TRANSFER_ERROR,        1u, "CyBle_GattsNotification() resulted with an error. " \
+                                            "Error code: %lx\r\n") \
+    X(BINLOG_EVT_RECONNECT_BONDED,      1u, "Reconnect target is the bonded Client, address type %lu\r\n") \
+    X(BINLOG_EVT_RECONNECT_DIRECTED,    2u, "Directed advertising to the bonded Client, burst %lu of %lu\r\n") \
+    X(BINLOG_EVT_RECONNECT_UNDIRECTED,  0u, "No reconnection to directed advertising, advertising undirected\r\n") \
+    X(BINLOG_EVT_RECONNECTED,           2u, "Reconnected after %lu ms, directed %lu\r\n") \
+    X(BINLOG_EVT_MOTION_ADV,            4u, "Advertising round: motion level %lu, interval %lu-%lu x 0.625 ms, " \
+                                            "%lu s\r\n") \
+    X(BINLOG_EVT_MOTION_ARMED,          1u, "Motion interrupt armed at %lu mg\r\n") \
+    X(BINLOG_EVT_TXPOWER,               2u, "TX power %lu dB below the customizer's, average RSSI -%lu dBm\r\n") \
+    X(BINLOG_EVT_TXPOWER_ERROR,         2u, "Notification error %lx, TX power back to the customizer's, " \
+                                            "margin %lu dB\r\n") \
+    X(BINLOG_EVT_PROFILE,               4u, "Profile %lu: %lu calls, %lu-%lu cycles\r\n") \
+    X(BINLOG_EVT_PROFILE_MEAN,          2u, "Profile %lu: mean %lu cycles\r\n") \
+    X(BINLOG_EVT_PROFILE_BUCKET,        4u, "Profile %lu: %lu calls of %lu-%lu cycles\r\n") \
+    X(BINLOG_EVT_AIR_LATENCY,           4u, "Stride-to-air latency of %lu notifications: p50 %lu ms, " \
+                                            "p90 %lu ms, p99 %lu ms\r\n") \
+    X(BINLOG_EVT_AIR_LATENCY_MAX,       2u, "Stride-to-air latency: mean %lu ms, max %lu ms\r\n")
+
+#define BINLOG_EVENT_ID(id, argc, format)   id,
+
+typedef enum
+{
+    BINLOG_EVENT_TABLE(BINLOG_EVENT_ID)
+    BINLOG_EVT_COUNT
+} BINLOG_EVENT_T;
+
+
+/* [] END OF FILE */
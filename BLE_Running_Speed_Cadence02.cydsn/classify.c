@@ -0,0 +1,132 @@
+/*******************************************************************************
+* File Name: classify.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the walking/running classifier. It runs once a stride
+*  from the stride detection pipeline, takes a fixed number of operations and
+*  owns the profile and the Walking or Running Status flag.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "rscs.h"
+#include "stride.h"
+#include "classify.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+
+/* Score of the last stride, positive for running */
+int16                   classifyScore = 0;
+
+/* Strides in a row that voted against the current profile */
+static uint8            classifyPending;
+
+
+/*******************************************************************************
+* Function Name: ClassifyVote
+********************************************************************************
+*
+* Summary:
+*  Weighs one feature and limits the vote to CLASSIFY_VOTE_MAX.
+*
+*******************************************************************************/
+static int32 ClassifyVote(int32 vote)
+{
+    if(vote > CLASSIFY_VOTE_MAX)
+    {
+        vote = CLASSIFY_VOTE_MAX;
+    }
+    else if(vote < -CLASSIFY_VOTE_MAX)
+    {
+        vote = -CLASSIFY_VOTE_MAX;
+    }
+    return(vote);
+}
+
+
+/*******************************************************************************
+* Function Name: ClassifyInit
+********************************************************************************
+*
+* Summary:
+*  Starts with the walking profile.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ClassifyInit(void)
+{
+    classifyScore = 0;
+    classifyPending = 0u;
+    SetProfile(WALKING);
+}
+
+
+/*******************************************************************************
+* Function Name: ClassifyStride
+********************************************************************************
+*
+* Summary:
+*  Scores a stride and switches the profile after CLASSIFY_CONFIRM_STRIDES
+*  strides in a row outside the hysteresis band on the other side.
+*
+* Parameters:
+*  info: Features of the stride.
+*
+* Return:
+*  The profile, WALKING or RUNNING.
+*
+*******************************************************************************/
+uint8 ClassifyStride(const STRIDE_INFO_T * info)
+{
+    int32 score;
+    uint8 against;
+
+    score = ClassifyVote(((int32) info->cadence - (int32) CLASSIFY_CADENCE_SPLIT) * CLASSIFY_CADENCE_WEIGHT);
+    score += ClassifyVote(((int32) info->strideCm - (int32) CLASSIFY_STRIDE_SPLIT) * CLASSIFY_STRIDE_WEIGHT);
+    score += ClassifyVote((((int32) info->peak - CLASSIFY_PEAK_SPLIT) * CLASSIFY_PEAK_WEIGHT_MUL) >>
+                          CLASSIFY_PEAK_WEIGHT_SHIFT);
+    classifyScore = (int16) score;
+
+    if(WALKING == profile)
+    {
+        against = (score > CLASSIFY_RUN_SCORE) ? YES : NO;
+    }
+    else
+    {
+        against = (score < CLASSIFY_WALK_SCORE) ? YES : NO;
+    }
+
+    if(NO == against)
+    {
+        classifyPending = 0u;
+    }
+    else if(++classifyPending >= CLASSIFY_CONFIRM_STRIDES)
+    {
+        classifyPending = 0u;
+        SetProfile((WALKING == profile) ? RUNNING : WALKING);
+    }
+    else
+    {
+        /* Wait for the next stride to confirm */
+    }
+
+    return(profile);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: classify.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the walking/running
+*  classifier. Every stride the cadence, the stride length and the impact peak
+*  vote with fixed weights; the gait changes when the score leaves the
+*  hysteresis band for CLASSIFY_CONFIRM_STRIDES strides in a row.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Feature boundaries between walking and running: the middle of the gap
+* between the WALKING_ and RUNNING_ ranges, and 1.5 g above gravity for the
+* impact.
+*/
+#define CLASSIFY_CADENCE_SPLIT              ((WALKING_INST_CADENCE_MAX + RUNNING_INST_CADENCE_MIN) / 2u)
+#define CLASSIFY_STRIDE_SPLIT               ((WALKING_INST_STRIDE_LENGTH_MAX + RUNNING_INST_STRIDE_LENGTH_MIN) / 2u)
+#define CLASSIFY_PEAK_SPLIT                 (1500)
+
+/* Weights in 1/256 of a vote per unit: a feature at the edge of its range
+* (half the gap away from the split, or 600 mg for the impact) casts one vote.
+*/
+#define CLASSIFY_CADENCE_WEIGHT             (21)
+#define CLASSIFY_STRIDE_WEIGHT              (34)
+#define CLASSIFY_PEAK_WEIGHT_MUL            (7)
+#define CLASSIFY_PEAK_WEIGHT_SHIFT          (4u)
+
+/* A single feature can't outvote the other two on its own */
+#define CLASSIFY_VOTE_MAX                   (512)
+
+/* Hysteresis: half a vote either side of zero */
+#define CLASSIFY_RUN_SCORE                  (128)
+#define CLASSIFY_WALK_SCORE                 (-128)
+
+#define CLASSIFY_CONFIRM_STRIDES            (2u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void ClassifyInit(void);
+uint8 ClassifyStride(const STRIDE_INFO_T * info);
+
+
+/***************************************
+* External data references
+***************************************/
+extern int16                    classifyScore;
+
+
+/* [] END OF FILE */
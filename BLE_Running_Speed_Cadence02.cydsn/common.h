@@ -38,13 +38,92 @@
 /* Delay value to produce blinking LED */
 #define BLINK_DELAY                         (2000u)
 
-#define PACE_TIMER_VALUE                    (333u)
+/* Software timer periods in milliseconds */
+#define LED_BLINK_PERIOD_MS                 (500u)
 
-#define NOTIFICATION_TIMER_VALUE            (150u)
+#define PACE_PERIOD_MS                      (10000u)
 
+#define NOTIFICATION_PERIOD_MS              (3000u)
 
-#define WALKING_PROFILE_TIMER_VALUE         (33u)
-#define RUNNING_PROFILE_TIMER_VALUE         (17u)
+
+#define WALKING_PROFILE_PERIOD_MS           (1000u)
+#define RUNNING_PROFILE_PERIOD_MS           (500u)
+
+/* Take the strides from the accelerometer through the stride detection
+* pipeline instead of simulating them. The CY8CKIT-042 BLE has no
+* accelerometer, so the simulation is the default. Enabling it needs an
+* accelerometer driver, which this project doesn't have yet, to provide
+* StrideSensorRead() of stride.h and MotionSensorArm() of motion.h.
+*/
+#if !defined(STRIDE_SENSOR_ENABLED)
+    #define STRIDE_SENSOR_ENABLED           (0u)
+#endif /* !defined(STRIDE_SENSOR_ENABLED) */
+
+
+/* Let the link layer skip the idle connection events with slave latency and
+* send the notifications at the connection events it attends anyway.
+*/
+#if !defined(SLAVE_LATENCY_SCHEDULING)
+    #define SLAVE_LATENCY_SCHEDULING        (1u)
+#endif /* !defined(SLAVE_LATENCY_SCHEDULING) */
+
+
+/* After a disconnect, advertise directed at the bonded central first so it
+* reconnects within milliseconds of coming back in range.
+*/
+#if !defined(DIRECTED_RECONNECT)
+    #define DIRECTED_RECONNECT              (1u)
+#endif /* !defined(DIRECTED_RECONNECT) */
+
+
+/* Take the advertising interval from the recent motion instead of the fixed
+* fast and slow advertising of the BLE component, see motion.h.
+*/
+#if !defined(MOTION_ADAPTIVE_ADV)
+    #define MOTION_ADAPTIVE_ADV             (1u)
+#endif /* !defined(MOTION_ADAPTIVE_ADV) */
+
+
+/* Lower the TX power of the connection while the link has margin, see
+* txpower.h.
+*/
+#if !defined(ADAPTIVE_TX_POWER)
+    #define ADAPTIVE_TX_POWER               (1u)
+#endif /* !defined(ADAPTIVE_TX_POWER) */
+
+
+/* Count the cycles of the event handlers and the interrupt service routines,
+* see profiler.h.
+*/
+#if !defined(CYCLE_PROFILER)
+    #define CYCLE_PROFILER                  (0u)
+#endif /* !defined(CYCLE_PROFILER) */
+
+
+/* Write the BLE events that reach the handlers to UART_DEB for the host to
+* replay, see evtrace.h.
+*/
+#if !defined(EVENT_TRACE)
+    #define EVENT_TRACE                     (0u)
+#endif /* !defined(EVENT_TRACE) */
+
+
+/* Serve the stored workouts over the Session Transfer service, see
+* transfer.h. Needs the service in the BLE component's customizer, which
+* this project doesn't have yet; the host build defines its handles.
+*/
+#if !defined(SESSION_TRANSFER)
+    #define SESSION_TRANSFER                (0u)
+#endif /* !defined(SESSION_TRANSFER) */
+
+
+/* Let a Client read the low power statistics over the Power Statistics
+* service, see powerstats.h. The counters run either way. Needs the service
+* in the BLE component's customizer, like SESSION_TRANSFER.
+*/
+#if !defined(POWERSTATS_SERVICE)
+    #define POWERSTATS_SERVICE              (0u)
+#endif /* !defined(POWERSTATS_SERVICE) */
 
 
 #define WDT_COUNTER                 (CY_SYS_WDT_COUNTER1)
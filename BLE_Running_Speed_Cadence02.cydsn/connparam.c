@@ -0,0 +1,495 @@
+/*******************************************************************************
+* File Name: connparam.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the connection parameter manager. Some time after the
+*  connection, and whenever the profile changes, it sends an L2CAP connection
+*  parameter update request for the profile, or for the session download
+*  while one is in progress. A rejected or unanswered request
+*  is retried with a wider interval range. The parameters the link actually
+*  runs with are recorded in connParamCurrent.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "rscs.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "connparam.h"
+#include "transfer.h"
+
+#define DEBUG_MODULE_LEVEL      (CONN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Longest interval for a stride period, and the slave latency that stretches
+* it to one connection event per notification.
+*/
+#define CONNPARAM_INTERVAL_FOR(periodMs)    CONNPARAM_MS_TO_INTERVAL((periodMs) / CONNPARAM_STRIDE_DIVIDER)
+#define CONNPARAM_LATENCY_FOR(periodMs)     ((NOTIFICATION_PERIOD_MS / ((periodMs) / CONNPARAM_STRIDE_DIVIDER)) - 1u)
+#define CONNPARAM_TIMEOUT                   ((NOTIFICATION_PERIOD_MS * CONNPARAM_TIMEOUT_FACTOR) / \
+                                             CONNPARAM_TIMEOUT_UNIT_MS)
+
+/* Requested parameters, indexed by WALKING, RUNNING and
+* CONNPARAM_TARGET_TRANSFER
+*/
+static const CYBLE_GAP_CONN_UPDATE_PARAM_T connParamTargets[] =
+{
+    {
+        (CONNPARAM_INTERVAL_FOR(WALKING_PROFILE_PERIOD_MS) * CONNPARAM_RANGE_MUL) / CONNPARAM_RANGE_DIV,
+        CONNPARAM_INTERVAL_FOR(WALKING_PROFILE_PERIOD_MS),
+        CONNPARAM_LATENCY_FOR(WALKING_PROFILE_PERIOD_MS),
+        CONNPARAM_TIMEOUT
+    },
+    {
+        (CONNPARAM_INTERVAL_FOR(RUNNING_PROFILE_PERIOD_MS) * CONNPARAM_RANGE_MUL) / CONNPARAM_RANGE_DIV,
+        CONNPARAM_INTERVAL_FOR(RUNNING_PROFILE_PERIOD_MS),
+        CONNPARAM_LATENCY_FOR(RUNNING_PROFILE_PERIOD_MS),
+        CONNPARAM_TIMEOUT
+    },
+    {
+        CONNPARAM_TRANSFER_INTERVAL_MIN,
+        CONNPARAM_TRANSFER_INTERVAL_MAX,
+        0u,
+        CONNPARAM_TRANSFER_TIMEOUT
+    }
+};
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void ConnParamTimerCallback(void);
+
+
+/***************************************
+*        Global Variables
+***************************************/
+
+/* Parameters the link runs with */
+CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T connParamCurrent;
+
+uint8                   connParamState = CONNPARAM_STATE_IDLE;
+uint16                  connParamRequests = 0u;
+uint16                  connParamRejects = 0u;
+
+/* Last request and the target it was made for */
+static CYBLE_GAP_CONN_UPDATE_PARAM_T connParamRequested;
+static uint8            connParamTargetIndex;
+static uint8            connParamAttempt;
+
+/* The link layer is told to attend every connection event */
+static uint8            connParamQuickTransmit;
+
+
+/*******************************************************************************
+* Function Name: ConnParamSchedule
+********************************************************************************
+*
+* Summary:
+*  Waits before the next request.
+*
+*******************************************************************************/
+static void ConnParamSchedule(uint32 delayMs)
+{
+    connParamState = CONNPARAM_STATE_WAIT;
+    SwTimerStart(SWTIMER_CONN_PARAM, SWTIMER_MS_TO_TICKS(delayMs), &ConnParamTimerCallback);
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamIsAccepted
+********************************************************************************
+*
+* Summary:
+*  Checks whether the current parameters satisfy the last request: the
+*  interval is not longer than asked for, and with the slave latency the
+*  device wakes no more often than at the shortest interval of the request.
+*  A central that grants a longer interval but less latency is fine.
+*
+*******************************************************************************/
+static uint8 ConnParamIsAccepted(void)
+{
+    uint32 effective = (uint32) connParamCurrent.connIntv * (connParamCurrent.connLatency + 1u);
+    uint32 requested = (uint32) connParamRequested.connIntvMin * (connParamRequested.connLatency + 1u);
+
+    return(((connParamCurrent.connIntv <= connParamRequested.connIntvMax) && (effective >= requested)) ?
+           YES : NO);
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamTargetFor
+********************************************************************************
+*
+* Summary:
+*  Returns the index of the parameters that suit the link now: the ones of
+*  the download while one is in progress, else the ones of the profile.
+*
+*******************************************************************************/
+static uint8 ConnParamTargetFor(void)
+{
+    return((YES == TransferIsActive()) ? CONNPARAM_TARGET_TRANSFER : profile);
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamTarget
+********************************************************************************
+*
+* Summary:
+*  Sets up the parameters to request for the current target and attempt.
+*  Every retry halves the shortest acceptable interval.
+*
+*******************************************************************************/
+static void ConnParamTarget(void)
+{
+    connParamTargetIndex = ConnParamTargetFor();
+    connParamRequested = connParamTargets[connParamTargetIndex];
+    connParamRequested.connIntvMin >>= connParamAttempt;
+    if(connParamRequested.connIntvMin < CONNPARAM_INTERVAL_MIN)
+    {
+        connParamRequested.connIntvMin = CONNPARAM_INTERVAL_MIN;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamRetry
+********************************************************************************
+*
+* Summary:
+*  Schedules the next attempt or gives up after CONNPARAM_MAX_ATTEMPTS.
+*
+*******************************************************************************/
+static void ConnParamRetry(void)
+{
+    connParamAttempt++;
+    if(connParamAttempt < CONNPARAM_MAX_ATTEMPTS)
+    {
+        ConnParamSchedule(CONNPARAM_RETRY_DELAY_MS);
+    }
+    else
+    {
+        BINLOG_WARN(BINLOG_EVT_CONN_PARAM_GAVE_UP, connParamCurrent.connIntv, connParamCurrent.connLatency);
+        SwTimerStop(SWTIMER_CONN_PARAM);
+        connParamState = CONNPARAM_STATE_FAILED;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamRequest
+********************************************************************************
+*
+* Summary:
+*  Sends the connection parameter update request and waits for the answer.
+*
+*******************************************************************************/
+static void ConnParamRequest(void)
+{
+    CYBLE_API_RESULT_T apiResult;
+
+    ConnParamTarget();
+    if(YES == ConnParamIsAccepted())
+    {
+        SwTimerStop(SWTIMER_CONN_PARAM);
+        connParamState = CONNPARAM_STATE_DONE;
+        return;
+    }
+
+    apiResult = CyBle_L2capLeConnectionParamUpdateRequest(connectionHandle.bdHandle, &connParamRequested);
+    if(CYBLE_ERROR_OK == apiResult)
+    {
+        connParamRequests++;
+        BINLOG_INFO(BINLOG_EVT_CONN_PARAM_REQ, connParamRequested.connIntvMin, connParamRequested.connIntvMax,
+            connParamRequested.connLatency, connParamRequested.supervisionTO);
+        connParamState = CONNPARAM_STATE_PENDING;
+        SwTimerStart(SWTIMER_CONN_PARAM, SWTIMER_MS_TO_TICKS(CONNPARAM_RESPONSE_TIMEOUT_MS),
+            &ConnParamTimerCallback);
+    }
+    else
+    {
+        /* The stack is busy, try again later without counting an attempt */
+        BINLOG_WARN(BINLOG_EVT_CONN_PARAM_ERROR, apiResult);
+        ConnParamSchedule(CONNPARAM_RETRY_DELAY_MS);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamTimerCallback
+********************************************************************************
+*
+* Summary:
+*  Sends the scheduled request or handles a request that got no answer.
+*
+*******************************************************************************/
+void ConnParamTimerCallback(void)
+{
+    SwTimerStop(SWTIMER_CONN_PARAM);
+
+    if(CONNPARAM_STATE_WAIT == connParamState)
+    {
+        ConnParamRequest();
+    }
+    else if(CONNPARAM_STATE_PENDING == connParamState)
+    {
+        BINLOG_WARN(BINLOG_EVT_CONN_PARAM_TIMEOUT, connParamAttempt);
+        ConnParamRetry();
+    }
+    else
+    {
+        /* Nothing is scheduled */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamConnected
+********************************************************************************
+*
+* Summary:
+*  Records the parameters the central connected with and schedules the first
+*  request, unless they already suit the profile.
+*
+* Parameters:
+*  param: Parameters of the new connection.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ConnParamConnected(const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T * param)
+{
+    connParamCurrent = *param;
+    connParamAttempt = 0u;
+    connParamQuickTransmit = YES;
+    BINLOG_INFO(BINLOG_EVT_CONN_PARAM, connParamCurrent.connIntv, connParamCurrent.connLatency,
+        connParamCurrent.supervisionTO);
+
+    ConnParamTarget();
+    if(YES == ConnParamIsAccepted())
+    {
+        connParamState = CONNPARAM_STATE_DONE;
+    }
+    else
+    {
+        ConnParamSchedule(CONNPARAM_START_DELAY_MS);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamDisconnected
+********************************************************************************
+*
+* Summary:
+*  Stops the manager until the next connection.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ConnParamDisconnected(void)
+{
+    SwTimerStop(SWTIMER_CONN_PARAM);
+    connParamState = CONNPARAM_STATE_IDLE;
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamResponse
+********************************************************************************
+*
+* Summary:
+*  Handles the central's answer to the request. An accepted request is
+*  completed by the connection update event.
+*
+* Parameters:
+*  result: CYBLE_L2CAP_CONN_PARAM_ACCEPTED or CYBLE_L2CAP_CONN_PARAM_REJECTED.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ConnParamResponse(uint16 result)
+{
+    if((CONNPARAM_STATE_PENDING == connParamState) && (CYBLE_L2CAP_CONN_PARAM_ACCEPTED != result))
+    {
+        connParamRejects++;
+        BINLOG_WARN(BINLOG_EVT_CONN_PARAM_REJECTED, connParamAttempt);
+        ConnParamRetry();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamUpdated
+********************************************************************************
+*
+* Summary:
+*  Records the parameters after a connection update. When they don't satisfy
+*  the request, or the central changed them on its own later, the request is
+*  repeated.
+*
+* Parameters:
+*  param: Parameters of the updated connection.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ConnParamUpdated(const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T * param)
+{
+    if(0u != param->status)
+    {
+        return;
+    }
+
+    connParamCurrent = *param;
+    BINLOG_INFO(BINLOG_EVT_CONN_PARAM, connParamCurrent.connIntv, connParamCurrent.connLatency,
+        connParamCurrent.supervisionTO);
+
+    if((CONNPARAM_STATE_PENDING == connParamState) || (CONNPARAM_STATE_DONE == connParamState))
+    {
+        if(YES == ConnParamIsAccepted())
+        {
+            SwTimerStop(SWTIMER_CONN_PARAM);
+            connParamState = CONNPARAM_STATE_DONE;
+        }
+        else
+        {
+            ConnParamRetry();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamProcess
+********************************************************************************
+*
+* Summary:
+*  Asks for new parameters after the profile has changed or a download
+*  started or ended and, with
+*  SLAVE_LATENCY_SCHEDULING, lets the link layer use the slave latency while
+*  nothing waits for an answer from the central. Called from the main loop
+*  while connected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ConnParamProcess(void)
+{
+    uint8 quickTransmit;
+    uint8 target = ConnParamTargetFor();
+
+    if(((CONNPARAM_STATE_DONE == connParamState) || (CONNPARAM_STATE_FAILED == connParamState)) &&
+       (target != connParamTargetIndex))
+    {
+        connParamAttempt = 0u;
+        ConnParamTarget();
+        if(YES == ConnParamIsAccepted())
+        {
+            connParamState = CONNPARAM_STATE_DONE;
+        }
+        else if(CONNPARAM_TARGET_TRANSFER == target)
+        {
+            ConnParamRequest();
+        }
+        else
+        {
+            ConnParamSchedule(CONNPARAM_PROFILE_DELAY_MS);
+        }
+    }
+    else if((CONNPARAM_STATE_WAIT == connParamState) && (CONNPARAM_TARGET_TRANSFER == target) &&
+            (target != connParamTargetIndex))
+    {
+        /* A download doesn't wait for the start delay */
+        connParamAttempt = 0u;
+        ConnParamRequest();
+    }
+    else
+    {
+        /* The request for the target is made or on its way */
+    }
+
+#if (SLAVE_LATENCY_SCHEDULING)
+    /* Listen on every connection event while a parameter request, a Control
+    * Point procedure or an indication confirmation is outstanding, so the
+    * central's answer isn't held back by the slave latency.
+    */
+    quickTransmit = (((CONNPARAM_STATE_WAIT == connParamState) || (CONNPARAM_STATE_PENDING == connParamState) ||
+                      (YES == RscIsIndicationOutstanding())) ? YES : NO);
+#else
+    quickTransmit = YES;
+#endif /* (SLAVE_LATENCY_SCHEDULING) */
+
+    if(quickTransmit != connParamQuickTransmit)
+    {
+        if(CYBLE_ERROR_OK == CyBle_SetSlaveLatencyMode(connectionHandle.bdHandle, quickTransmit))
+        {
+            connParamQuickTransmit = quickTransmit;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ConnParamNotificationTicks
+********************************************************************************
+*
+* Summary:
+*  Returns the notification period for the current connection. With
+*  SLAVE_LATENCY_SCHEDULING and a slave latency it is the multiple of the
+*  effective interval closest to NOTIFICATION_PERIOD_MS.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Notification period in WDT ticks.
+*
+*******************************************************************************/
+uint32 ConnParamNotificationTicks(void)
+{
+    uint32 ticks = SWTIMER_MS_TO_TICKS(NOTIFICATION_PERIOD_MS);
+#if (SLAVE_LATENCY_SCHEDULING)
+    uint32 effective = (uint32) connParamCurrent.connIntv * (connParamCurrent.connLatency + 1u);
+    uint32 count;
+
+    if(0u != connParamCurrent.connLatency)
+    {
+        count = (CONNPARAM_NOTIFICATION_PERIOD + (effective >> 1u)) / effective;
+        if(0u == count)
+        {
+            count = 1u;
+        }
+        ticks = CONNPARAM_INTERVAL_TO_TICKS(effective * count);
+    }
+#endif /* (SLAVE_LATENCY_SCHEDULING) */
+
+    return(ticks);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: connparam.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the connection parameter
+*  manager. The peripheral asks the central for an interval and slave latency
+*  that fit the walking or running profile: the interval keeps the measurement
+*  fresh within a quarter of a stride and the slave latency lets the device
+*  skip the connection events between two notifications.
+*
+*  With SLAVE_LATENCY_SCHEDULING the notification period is rounded to a
+*  multiple of the effective interval, the interval times the slave latency
+*  plus one. Once the first notification has gone out, the following ones are
+*  queued just before a connection event that the link layer attends anyway,
+*  so notifying costs no extra wakeups.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Units of the connection parameters on the air */
+#define CONNPARAM_INTERVAL_UNIT_US          (1250u)
+#define CONNPARAM_TIMEOUT_UNIT_MS           (10u)
+#define CONNPARAM_MS_TO_INTERVAL(ms)        ((uint16) (((uint32) (ms) * 1000u) / CONNPARAM_INTERVAL_UNIT_US))
+#define CONNPARAM_INTERVAL_TO_MS(intv)      ((uint32) (((uint32) (intv) * CONNPARAM_INTERVAL_UNIT_US) / 1000u))
+/* 1.25 ms in 32.768 kHz ticks is 1024/25 */
+#define CONNPARAM_INTERVAL_TO_TICKS(intv)   ((uint32) (((uint32) (intv) * 1024u) / 25u))
+#define CONNPARAM_NOTIFICATION_PERIOD       (CONNPARAM_MS_TO_INTERVAL(NOTIFICATION_PERIOD_MS))
+
+/* Limits of the Bluetooth Core Specification */
+#define CONNPARAM_INTERVAL_MIN              (6u)
+#define CONNPARAM_INTERVAL_MAX              (3200u)
+#define CONNPARAM_LATENCY_MAX               (499u)
+#define CONNPARAM_TIMEOUT_MAX               (3200u)
+
+/* The longest interval asked for is this fraction of the stride period, the
+* shortest one is 4/5 of it to leave the central room to fit its schedule.
+*/
+#define CONNPARAM_STRIDE_DIVIDER            (4u)
+#define CONNPARAM_RANGE_MUL                 (4u)
+#define CONNPARAM_RANGE_DIV                 (5u)
+
+/* A session download asks for a short interval without slave latency, 15 ms
+* is the shortest iOS grants. The parameters follow WALKING and RUNNING in
+* the table of targets.
+*/
+#define CONNPARAM_TRANSFER_INTERVAL_MIN     (CONNPARAM_INTERVAL_MIN)
+#define CONNPARAM_TRANSFER_INTERVAL_MAX     (CONNPARAM_MS_TO_INTERVAL(15u))
+#define CONNPARAM_TRANSFER_TIMEOUT          (200u)
+#define CONNPARAM_TARGET_TRANSFER           (2u)
+
+/* Supervision timeout in multiples of the effective interval, the
+* specification requires more than two.
+*/
+#define CONNPARAM_TIMEOUT_FACTOR            (3u)
+
+/* Service discovery runs at the interval the central picked; ask after it */
+#define CONNPARAM_START_DELAY_MS            (5000u)
+#define CONNPARAM_RETRY_DELAY_MS            (5000u)
+#define CONNPARAM_PROFILE_DELAY_MS          (2000u)
+#define CONNPARAM_RESPONSE_TIMEOUT_MS       (30000u)
+
+/* Every retry halves the shortest acceptable interval. After the last one
+* the device keeps what it got until the profile changes or it reconnects.
+*/
+#define CONNPARAM_MAX_ATTEMPTS              (4u)
+
+/* Manager states */
+#define CONNPARAM_STATE_IDLE                (0u)
+#define CONNPARAM_STATE_WAIT                (1u)
+#define CONNPARAM_STATE_PENDING             (2u)
+#define CONNPARAM_STATE_DONE                (3u)
+#define CONNPARAM_STATE_FAILED              (4u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void ConnParamConnected(const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T * param);
+void ConnParamDisconnected(void);
+void ConnParamResponse(uint16 result);
+void ConnParamUpdated(const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T * param);
+void ConnParamProcess(void);
+uint32 ConnParamNotificationTicks(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern CYBLE_CONN_HANDLE_T      connectionHandle;
+extern CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T connParamCurrent;
+extern uint8                    connParamState;
+extern uint16                   connParamRequests;
+extern uint16                   connParamRejects;
+
+
+/* [] END OF FILE */
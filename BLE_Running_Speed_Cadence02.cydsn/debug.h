@@ -0,0 +1,112 @@
+/*******************************************************************************
+* File Name: debug.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the compile-time debug output levels. Every source file defines
+*  DEBUG_MODULE_LEVEL before including this header; log sites above that level
+*  expand to nothing, so neither the format strings nor the printf() formatter
+*  end up in the image when they are disabled.
+*
+*  Production builds define DEBUG_DEFAULT_LEVEL=DEBUG_LEVEL_NONE in the
+*  compiler preprocessor definitions. A single module can be made more or less
+*  verbose with MAIN_DEBUG_LEVEL, RSCS_DEBUG_LEVEL or CONN_DEBUG_LEVEL.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+
+/***************************************
+*          Constants
+***************************************/
+#define DEBUG_LEVEL_NONE                    (0u)
+#define DEBUG_LEVEL_ERROR                   (1u)
+#define DEBUG_LEVEL_WARN                    (2u)
+#define DEBUG_LEVEL_INFO                    (3u)
+#define DEBUG_LEVEL_TRACE                   (4u)
+
+#if !defined(DEBUG_DEFAULT_LEVEL)
+    #define DEBUG_DEFAULT_LEVEL             (DEBUG_LEVEL_TRACE)
+#endif /* !defined(DEBUG_DEFAULT_LEVEL) */
+
+/* Per module levels */
+#if !defined(MAIN_DEBUG_LEVEL)
+    #define MAIN_DEBUG_LEVEL                (DEBUG_DEFAULT_LEVEL)
+#endif /* !defined(MAIN_DEBUG_LEVEL) */
+
+#if !defined(RSCS_DEBUG_LEVEL)
+    #define RSCS_DEBUG_LEVEL                (DEBUG_DEFAULT_LEVEL)
+#endif /* !defined(RSCS_DEBUG_LEVEL) */
+
+#if !defined(CONN_DEBUG_LEVEL)
+    #define CONN_DEBUG_LEVEL                (DEBUG_DEFAULT_LEVEL)
+#endif /* !defined(CONN_DEBUG_LEVEL) */
+
+#if !defined(DEBUG_MODULE_LEVEL)
+    #define DEBUG_MODULE_LEVEL              (DEBUG_DEFAULT_LEVEL)
+#endif /* !defined(DEBUG_MODULE_LEVEL) */
+
+
+/***************************************
+*        Macros
+***************************************/
+
+/* Text output through printf() */
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_ERROR)
+    #define LOG_ERROR(...)                  printf(__VA_ARGS__)
+#else
+    #define LOG_ERROR(...)                  do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_ERROR) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_WARN)
+    #define LOG_WARN(...)                   printf(__VA_ARGS__)
+#else
+    #define LOG_WARN(...)                   do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_WARN) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_INFO)
+    #define LOG_INFO(...)                   printf(__VA_ARGS__)
+#else
+    #define LOG_INFO(...)                   do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_INFO) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE)
+    #define LOG_TRACE(...)                  printf(__VA_ARGS__)
+#else
+    #define LOG_TRACE(...)                  do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE) */
+
+/* Binary log records, see binlog.h. The arguments are the event identifier
+* followed by up to BINLOG_MAX_ARGS values.
+*/
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_ERROR)
+    #define BINLOG_ERROR(...)               BINLOG(__VA_ARGS__)
+#else
+    #define BINLOG_ERROR(...)               do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_ERROR) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_WARN)
+    #define BINLOG_WARN(...)                BINLOG(__VA_ARGS__)
+#else
+    #define BINLOG_WARN(...)                do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_WARN) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_INFO)
+    #define BINLOG_INFO(...)                BINLOG(__VA_ARGS__)
+#else
+    #define BINLOG_INFO(...)                do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_INFO) */
+
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE)
+    #define BINLOG_TRACE(...)               BINLOG(__VA_ARGS__)
+#else
+    #define BINLOG_TRACE(...)               do { } while(0)
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,159 @@
+/*******************************************************************************
+* File Name: evtqueue.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the event queue between the interrupt handlers and the
+*  main loop. EvtQueuePut() may only be called from one interrupt handler (or
+*  from handlers that can't preempt each other) and EvtQueueGet() only from
+*  the main loop. Neither masks interrupts: each side writes only its own
+*  index, and a uint8 store is atomic.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "evtqueue.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+static EVTQ_EVENT_T     evtQueue[EVTQ_SIZE];
+
+/* Written by the producer only */
+static volatile uint8   evtQueueHead = 0u;
+static volatile uint16  evtQueueDropped = 0u;
+
+/* Written by the consumer only */
+static volatile uint8   evtQueueTail = 0u;
+
+
+/*******************************************************************************
+* Function Name: EvtQueueInit
+********************************************************************************
+*
+* Summary:
+*  Empties the queue. Must be called before the producer interrupt is enabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void EvtQueueInit(void)
+{
+    evtQueueHead = 0u;
+    evtQueueTail = 0u;
+    evtQueueDropped = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: EvtQueuePut
+********************************************************************************
+*
+* Summary:
+*  Appends an event. The slot is written before the head index is published,
+*  so the consumer never sees a partially written event.
+*
+* Parameters:
+*  type:  Event type, one of EVTQ_EVT_.
+*  arg:   8-bit event argument.
+*  value: 16-bit event argument.
+*
+* Return:
+*  YES if the event was queued, NO if the queue is full and the event was
+*  dropped.
+*
+*******************************************************************************/
+uint8 EvtQueuePut(uint8 type, uint8 arg, uint16 value)
+{
+    uint8 head = evtQueueHead;
+    EVTQ_EVENT_T *slot;
+
+    if((uint8) (head - evtQueueTail) >= EVTQ_SIZE)
+    {
+        evtQueueDropped++;
+        return(NO);
+    }
+
+    /* The tail must be read before the slot it frees is overwritten */
+    EVTQ_BARRIER();
+
+    slot = &evtQueue[head & EVTQ_MASK];
+    slot->type = type;
+    slot->arg = arg;
+    slot->value = value;
+
+    EVTQ_BARRIER();
+    evtQueueHead = (uint8) (head + 1u);
+
+    return(YES);
+}
+
+
+/*******************************************************************************
+* Function Name: EvtQueueGet
+********************************************************************************
+*
+* Summary:
+*  Takes the oldest event. The slot is copied before the tail index releases
+*  it to the producer.
+*
+* Parameters:
+*  event: Receives the event.
+*
+* Return:
+*  YES if an event was taken, NO if the queue is empty.
+*
+*******************************************************************************/
+uint8 EvtQueueGet(EVTQ_EVENT_T * event)
+{
+    uint8 tail = evtQueueTail;
+
+    if(tail == evtQueueHead)
+    {
+        return(NO);
+    }
+
+    /* The head must be read before the slot it publishes */
+    EVTQ_BARRIER();
+
+    *event = evtQueue[tail & EVTQ_MASK];
+
+    EVTQ_BARRIER();
+    evtQueueTail = (uint8) (tail + 1u);
+
+    return(YES);
+}
+
+
+/*******************************************************************************
+* Function Name: EvtQueueGetDropped
+********************************************************************************
+*
+* Summary:
+*  Returns the number of events dropped because the queue was full.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Dropped event count, wraps at 65536.
+*
+*******************************************************************************/
+uint16 EvtQueueGetDropped(void)
+{
+    return(evtQueueDropped);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: evtqueue.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the event queue that
+*  passes the button events from the interrupt handler to the main loop. The
+*  queue has a single producer and a single consumer, so it needs no critical
+*  sections: the producer owns the head index and the consumer owns the tail
+*  index. The producer is ButtonPressInt(). Another interrupt handler that
+*  signals the main loop sets a volatile flag of its own, like MotionInt()
+*  does, unless it has the same priority as SW2_Interrupt.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Number of slots, a power of two that divides 256 so that the free-running
+* uint8 indices wrap consistently. One queue holds EVTQ_SIZE events.
+*/
+#define EVTQ_SIZE                           (16u)
+#define EVTQ_MASK                           (EVTQ_SIZE - 1u)
+
+/* Event types */
+#define EVTQ_EVT_BUTTON                     (0x01u)
+
+/* Orders the slot access against the index update. The Cortex-M0 has no
+* store buffer to drain, but the barrier also stops the compiler from
+* reordering the two stores.
+*/
+#define EVTQ_BARRIER()                      __DMB()
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint8 type;
+    uint8 arg;
+    uint16 value;
+} EVTQ_EVENT_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void EvtQueueInit(void);
+uint8 EvtQueuePut(uint8 type, uint8 arg, uint16 value);
+uint8 EvtQueueGet(EVTQ_EVENT_T * event);
+uint16 EvtQueueGetDropped(void);
+
+
+/* [] END OF FILE */
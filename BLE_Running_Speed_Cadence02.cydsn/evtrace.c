@@ -0,0 +1,214 @@
+/*******************************************************************************
+* File Name: evtrace.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the BLE event trace: it writes the events of the BLE
+*  component and their parameters to UART_DEB as they reach the handlers.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "evtrace.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* Time of the previous record, the first one is relative to the start */
+static uint32           evtTraceLastTick = 0u;
+
+
+/*******************************************************************************
+* Function Name: EvtTracePutVarint
+********************************************************************************
+*
+* Summary:
+*  Stores a value as an LEB128 varint and returns the number of bytes taken.
+*
+*******************************************************************************/
+static uint8 EvtTracePutVarint(uint8 *buff, uint32 value)
+{
+    uint8 len = 0u;
+
+    while(value > BINLOG_VARINT_MASK)
+    {
+        buff[len++] = (uint8) (value & BINLOG_VARINT_MASK) | BINLOG_VARINT_MORE;
+        value >>= BINLOG_VARINT_SHIFT;
+    }
+    buff[len++] = (uint8) value;
+
+    return(len);
+}
+
+
+/*******************************************************************************
+* Function Name: EvtTracePutValue
+********************************************************************************
+*
+* Summary:
+*  Stores an attribute value, cut to EVTRACE_VALUE_MAX bytes, and returns the
+*  number of bytes taken.
+*
+*******************************************************************************/
+static uint8 EvtTracePutValue(uint8 *buff, const CYBLE_GATT_VALUE_T *value)
+{
+    uint8 len = 0u;
+
+    if((NULL != value) && (NULL != value->val))
+    {
+        len = (value->len < EVTRACE_VALUE_MAX) ? (uint8) value->len : EVTRACE_VALUE_MAX;
+        memcpy(buff, value->val, len);
+    }
+
+    return(len);
+}
+
+
+/*******************************************************************************
+* Function Name: EvtTracePutParam
+********************************************************************************
+*
+* Summary:
+*  Stores the parameter of an event field by field and returns the number of
+*  bytes taken.
+*
+*******************************************************************************/
+static uint8 EvtTracePutParam(uint8 *buff, uint32 event, const void *eventParam)
+{
+    const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *connParam;
+    const CYBLE_GATTS_WRITE_REQ_PARAM_T *writeReq;
+    const CYBLE_RSCS_CHAR_VALUE_T *charValue;
+    uint32 value;
+    uint8 len = 0u;
+
+    if(NULL == eventParam)
+    {
+        return(0u);
+    }
+
+    switch(event)
+    {
+    case CYBLE_EVT_TIMEOUT:
+    case CYBLE_EVT_STACK_BUSY_STATUS:
+    case CYBLE_EVT_GAP_AUTH_FAILED:
+    case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+    case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+    case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
+        buff[len++] = *(const uint8 *) eventParam;
+        break;
+    case CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+        buff[len++] = LO8(*(const uint16 *) eventParam);
+        buff[len++] = HI8(*(const uint16 *) eventParam);
+        break;
+    case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
+        value = *(const uint32 *) eventParam;
+        buff[len++] = LO8(LO16(value));
+        buff[len++] = HI8(LO16(value));
+        buff[len++] = LO8(HI16(value));
+        buff[len++] = HI8(HI16(value));
+        break;
+    case CYBLE_EVT_GAP_AUTH_REQ:
+    case CYBLE_EVT_GAP_AUTH_COMPLETE:
+        buff[len++] = ((const CYBLE_GAP_AUTH_INFO_T *) eventParam)->security;
+        buff[len++] = ((const CYBLE_GAP_AUTH_INFO_T *) eventParam)->bonding;
+        buff[len++] = ((const CYBLE_GAP_AUTH_INFO_T *) eventParam)->ekeySize;
+        buff[len++] = ((const CYBLE_GAP_AUTH_INFO_T *) eventParam)->authErr;
+        break;
+    case CYBLE_EVT_GAP_DEVICE_CONNECTED:
+    case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
+        connParam = (const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *) eventParam;
+        buff[len++] = connParam->status;
+        buff[len++] = LO8(connParam->connIntv);
+        buff[len++] = HI8(connParam->connIntv);
+        buff[len++] = LO8(connParam->connLatency);
+        buff[len++] = HI8(connParam->connLatency);
+        buff[len++] = LO8(connParam->supervisionTO);
+        buff[len++] = HI8(connParam->supervisionTO);
+        break;
+    case CYBLE_EVT_GATT_CONNECT_IND:
+    case CYBLE_EVT_GATT_DISCONNECT_IND:
+        buff[len++] = ((const CYBLE_CONN_HANDLE_T *) eventParam)->bdHandle;
+        buff[len++] = ((const CYBLE_CONN_HANDLE_T *) eventParam)->attId;
+        break;
+    case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
+        buff[len++] = ((const CYBLE_GATT_XCHG_MTU_PARAM_T *) eventParam)->connHandle.bdHandle;
+        buff[len++] = ((const CYBLE_GATT_XCHG_MTU_PARAM_T *) eventParam)->connHandle.attId;
+        buff[len++] = LO8(((const CYBLE_GATT_XCHG_MTU_PARAM_T *) eventParam)->mtu);
+        buff[len++] = HI8(((const CYBLE_GATT_XCHG_MTU_PARAM_T *) eventParam)->mtu);
+        break;
+    case CYBLE_EVT_GATTS_WRITE_REQ:
+        writeReq = (const CYBLE_GATTS_WRITE_REQ_PARAM_T *) eventParam;
+        buff[len++] = writeReq->connHandle.bdHandle;
+        buff[len++] = writeReq->connHandle.attId;
+        buff[len++] = LO8(writeReq->handleValPair.attrHandle);
+        buff[len++] = HI8(writeReq->handleValPair.attrHandle);
+        len += EvtTracePutValue(&buff[len], &writeReq->handleValPair.value);
+        break;
+    case CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED:
+    case CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_ENABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_DISABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION:
+    case CYBLE_EVT_RSCSS_CHAR_WRITE:
+        charValue = (const CYBLE_RSCS_CHAR_VALUE_T *) eventParam;
+        buff[len++] = charValue->connHandle.bdHandle;
+        buff[len++] = charValue->connHandle.attId;
+        buff[len++] = (uint8) charValue->charIndex;
+        len += EvtTracePutValue(&buff[len], charValue->value);
+        break;
+    default:
+        /* No parameter, or none the handlers read */
+        break;
+    }
+
+    return(len);
+}
+
+
+/*******************************************************************************
+* Function Name: EvtTraceRecord
+********************************************************************************
+*
+* Summary:
+*  Writes a trace record of an event to UART_DEB. Called on entry to the BLE
+*  event handlers through EVTRACE_RECORD().
+*
+* Parameters:
+*  source:     Handler the event reached, EVTRACE_SOURCE_*.
+*  event:      Event code.
+*  eventParam: Event parameter as passed to the handler.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void EvtTraceRecord(uint8 source, uint32 event, const void *eventParam)
+{
+    uint8 frame[EVTRACE_FRAME_HEADER_SIZE + EVTRACE_RECORD_MAX];
+    uint32 now = SwTimerGetTicks();
+    uint8 len = EVTRACE_FRAME_HEADER_SIZE;
+
+    len += EvtTracePutVarint(&frame[len], now - evtTraceLastTick);
+    evtTraceLastTick = now;
+    frame[len++] = (uint8) ((uint8) CyBle_GetState() << EVTRACE_STATE_SHIFT) | (source & EVTRACE_SOURCE_MASK);
+    len += EvtTracePutVarint(&frame[len], event);
+    len += EvtTracePutParam(&frame[len], event, eventParam);
+
+    frame[0u] = EVTRACE_SYNC0;
+    frame[1u] = EVTRACE_SYNC1;
+    frame[2u] = len - EVTRACE_FRAME_HEADER_SIZE;
+    UART_DEB_SpiUartPutArray(frame, len);
+}
+
+
+/* [] END OF FILE */
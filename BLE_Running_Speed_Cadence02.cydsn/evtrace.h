@@ -0,0 +1,48 @@
+/*******************************************************************************
+* File Name: evtrace.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and macros of the BLE event trace. With
+*  EVENT_TRACE every event that reaches AppCallBack() or
+*  RscServiceAppEventHandler() is written to UART_DEB with its parameter and
+*  the time it arrived, in the format of evtrace_defs.h. Without it the trace
+*  points expand to nothing.
+*
+*  A UART_DEB capture of a device in the field replays on the host with
+*  RSC_SIM_REPLAY: the simulator feeds the events to the same handlers at
+*  the recorded times, on its virtual clock.
+*
+*  The records are written from the event callbacks, the main loop context,
+*  and take 5 to 50 bytes each; the UART stays busy for the time it takes
+*  to send them.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+#include "evtrace_defs.h"
+
+
+/***************************************
+*        Macros
+***************************************/
+#if (EVENT_TRACE)
+    #define EVTRACE_RECORD(source, event, eventParam)   EvtTraceRecord((source), (event), (eventParam))
+#else
+    #define EVTRACE_RECORD(source, event, eventParam)   do { } while(0)
+#endif /* (EVENT_TRACE) */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void EvtTraceRecord(uint8 source, uint32 event, const void *eventParam);
+
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/*******************************************************************************
+* File Name: evtrace_defs.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the wire format of the BLE event trace. The firmware writes it
+*  (evtrace.c), the host simulator replays it (RSC_SIM_REPLAY in
+*  host/cyble_stub.c) and the host decoder prints it (host/binlog_decode.c).
+*
+*  Every event is sent to UART_DEB as a frame of its own, between the text
+*  and the binary log frames:
+*   [EVTRACE_SYNC0][EVTRACE_SYNC1][length] followed by "length" bytes of
+*   record. The record is the number of WDT ticks since the previous record
+*   (the first one since the start) as an LEB128 varint, the source byte, the
+*   event code as an LEB128 varint and the event parameter.
+*
+*  The source byte holds the handler in the low nibble and the stack state,
+*  CyBle_GetState(), in the high nibble. The parameter is stored field by
+*  field, 16 and 32-bit fields LSB first, so the trace doesn't depend on the
+*  structure layout of the compiler:
+*   uint8 events (TIMEOUT, STACK_BUSY_STATUS, AUTH_FAILED,
+*   ADVERTISEMENT_START_STOP, DEVICE_DISCONNECTED, ENCRYPT_CHANGE) - 1 byte
+*   L2CAP_CONN_PARAM_UPDATE_RSP            - result, 2 bytes
+*   PASSKEY_DISPLAY_REQUEST                - passkey, 4 bytes
+*   AUTH_REQ, AUTH_COMPLETE                - security, bonding, ekeySize,
+*                                            authErr
+*   DEVICE_CONNECTED,
+*   CONNECTION_UPDATE_COMPLETE             - status, connIntv, connLatency,
+*                                            supervisionTO
+*   GATT_CONNECT_IND, GATT_DISCONNECT_IND  - bdHandle, attId
+*   GATTS_XCNHG_MTU_REQ                    - bdHandle, attId, mtu
+*   GATTS_WRITE_REQ                        - bdHandle, attId, attrHandle,
+*                                            value
+*   RSCS server events                     - bdHandle, attId, charIndex,
+*                                            value if there is one
+*  The other events have no parameter. A value takes the rest of the record
+*  and is cut to EVTRACE_VALUE_MAX bytes.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Neither byte occurs in the text, 0xFE is not even valid UTF-8 */
+#define EVTRACE_SYNC0                   (0xFEu)
+#define EVTRACE_SYNC1                   (0xE5u)
+#define EVTRACE_FRAME_HEADER_SIZE       (3u)
+
+/* Handlers the events are traced at */
+#define EVTRACE_SOURCE_APP              (0u)
+#define EVTRACE_SOURCE_RSCS             (1u)
+#define EVTRACE_SOURCE_MASK             (0x0Fu)
+#define EVTRACE_STATE_SHIFT             (4u)
+
+/* Longest value kept of a write, and of a record: two varints, the source
+* byte and the largest parameter
+*/
+#define EVTRACE_VALUE_MAX               (32u)
+#define EVTRACE_PARAM_MAX               (4u + EVTRACE_VALUE_MAX)
+#define EVTRACE_RECORD_MAX              (11u + EVTRACE_PARAM_MAX)
+
+
+/* [] END OF FILE */
@@ -0,0 +1,216 @@
+/*******************************************************************************
+* File Name: binlog_decode.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host decoder for the UART_DEB stream. Plain text (printf output) is copied
+*  as is, binary log frames (see binlog_defs.h) are turned back into text
+*  lines prefixed with the WDT time stamp in seconds. BLE event trace frames
+*  (see evtrace_defs.h) are skipped, or printed as a line each with -t.
+*
+*  Usage: binlog_decode [-t] [capture file]    (reads stdin without a file)
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "binlog_defs.h"
+#include "evtrace_defs.h"
+
+#define BINLOG_EVENT_ARGC(id, argc, format)     argc,
+#define BINLOG_EVENT_FORMAT(id, argc, format)   format,
+
+static const unsigned int eventArgc[BINLOG_EVT_COUNT] = { BINLOG_EVENT_TABLE(BINLOG_EVENT_ARGC) };
+static const char * const eventFormat[BINLOG_EVT_COUNT] = { BINLOG_EVENT_TABLE(BINLOG_EVENT_FORMAT) };
+
+
+/* Reads an LEB128 varint from the frame, returns 0 on truncation */
+static int ReadVarint(const uint8_t *buff, unsigned int len, unsigned int *pos, unsigned long *value)
+{
+    unsigned int shift = 0u;
+    uint8_t byte;
+
+    *value = 0u;
+    do
+    {
+        if(*pos >= len)
+        {
+            return(0);
+        }
+        byte = buff[(*pos)++];
+        *value |= ((unsigned long) (byte & BINLOG_VARINT_MASK)) << shift;
+        shift += BINLOG_VARINT_SHIFT;
+    }
+    while(0u != (byte & BINLOG_VARINT_MORE));
+
+    return(1);
+}
+
+static void DecodeFrame(const uint8_t *buff, unsigned int len, unsigned long tick)
+{
+    unsigned int pos = 0u;
+    unsigned int id;
+    unsigned int i;
+    unsigned long delta;
+    unsigned long args[BINLOG_MAX_ARGS];
+
+    while(pos < len)
+    {
+        id = buff[pos++];
+        if((id >= BINLOG_EVT_COUNT) || (0 == ReadVarint(buff, len, &pos, &delta)))
+        {
+            printf("[binlog] corrupted record, id %u\r\n", id);
+            return;
+        }
+        tick += delta;
+
+        for(i = 0u; i < BINLOG_MAX_ARGS; i++)
+        {
+            args[i] = 0u;
+            if((i < eventArgc[id]) && (0 == ReadVarint(buff, len, &pos, &args[i])))
+            {
+                printf("[binlog] truncated record, id %u\r\n", id);
+                return;
+            }
+        }
+
+        printf("[%6lu.%03lu] ", tick / BINLOG_TICKS_PER_SEC,
+            ((tick % BINLOG_TICKS_PER_SEC) * 1000u) / BINLOG_TICKS_PER_SEC);
+        printf(eventFormat[id], args[0], args[1], args[2], args[3]);
+    }
+}
+
+/* Prints an event trace record: time, handler, stack state, event code and
+* the parameter bytes
+*/
+static void DecodeTrace(const uint8_t *buff, unsigned int len, unsigned long *tick)
+{
+    unsigned int pos = 0u;
+    unsigned long delta;
+    unsigned long event;
+    unsigned int source;
+
+    if((0 == ReadVarint(buff, len, &pos, &delta)) || (pos >= len))
+    {
+        printf("[evtrace] corrupted record\r\n");
+        return;
+    }
+    *tick += delta;
+    source = buff[pos++];
+    if(0 == ReadVarint(buff, len, &pos, &event))
+    {
+        printf("[evtrace] corrupted record\r\n");
+        return;
+    }
+
+    printf("[%6lu.%03lu] evtrace %s event 0x%04lx state %u:", *tick / BINLOG_TICKS_PER_SEC,
+        ((*tick % BINLOG_TICKS_PER_SEC) * 1000u) / BINLOG_TICKS_PER_SEC,
+        (EVTRACE_SOURCE_RSCS == (source & EVTRACE_SOURCE_MASK)) ? "rscs" : "app", event,
+        source >> EVTRACE_STATE_SHIFT);
+    while(pos < len)
+    {
+        printf(" %02x", buff[pos++]);
+    }
+    printf("\r\n");
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in = stdin;
+    int ch;
+    unsigned int len;
+    unsigned int i;
+    unsigned long tick;
+    unsigned long traceTick = 0u;
+    int printTrace = 0;
+    uint8_t header[BINLOG_FRAME_HEADER_SIZE];
+    static uint8_t frame[UINT16_MAX];
+
+    if((argc > 1) && (0 == strcmp(argv[1], "-t")))
+    {
+        printTrace = 1;
+        argc--;
+        argv++;
+    }
+    if(argc > 1)
+    {
+        in = fopen(argv[1], "rb");
+        if(NULL == in)
+        {
+            perror(argv[1]);
+            return(1);
+        }
+    }
+
+    while(EOF != (ch = fgetc(in)))
+    {
+        if(EVTRACE_SYNC0 == ch)
+        {
+            ch = fgetc(in);
+            if(EVTRACE_SYNC1 != ch)
+            {
+                putchar(EVTRACE_SYNC0);
+                (void) ungetc(ch, in);
+                continue;
+            }
+            ch = fgetc(in);
+            if((EOF == ch) || (fread(frame, 1u, (unsigned int) ch, in) != (unsigned int) ch))
+            {
+                printf("[evtrace] truncated frame\r\n");
+                break;
+            }
+            if(0 != printTrace)
+            {
+                DecodeTrace(frame, (unsigned int) ch, &traceTick);
+            }
+            continue;
+        }
+
+        if(BINLOG_SYNC0 != ch)
+        {
+            putchar(ch);
+            continue;
+        }
+
+        header[0u] = (uint8_t) ch;
+        if(fread(&header[1u], 1u, BINLOG_FRAME_HEADER_SIZE - 1u, in) != (BINLOG_FRAME_HEADER_SIZE - 1u))
+        {
+            break;
+        }
+        if(BINLOG_SYNC1 != header[1u])
+        {
+            printf("[binlog] lost frame sync\r\n");
+            continue;
+        }
+
+        len = (unsigned int) header[2u] | ((unsigned int) header[3u] << 8u);
+        tick = 0u;
+        for(i = 0u; i < 4u; i++)
+        {
+            tick |= ((unsigned long) header[4u + i]) << (8u * i);
+        }
+
+        if(fread(frame, 1u, len, in) != len)
+        {
+            printf("[binlog] truncated frame\r\n");
+            break;
+        }
+        DecodeFrame(frame, len, tick);
+    }
+
+    if(stdin != in)
+    {
+        fclose(in);
+    }
+    return(0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,2597 @@
+/*******************************************************************************
+* File Name: cyble_stub.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host implementation of the CYBLE, WDT, power management, UART_DEB and pin
+*  APIs declared in host/project.h. Time is virtual: it only advances when the
+*  application puts the "MCU" to sleep, so a run is fully repeatable.
+*
+*  The scripted peer advertises, connects after a short delay, enables RSC
+*  Measurement notifications and SC Control Point indications, and presses SW2
+*  periodically. The simulation ends when the configured duration elapses.
+*  Like iOS, the peer accepts a connection parameter update request with the
+*  longest multiple of 15 ms in the requested range, after rejecting the
+*  first RSC_SIM_CONN_REJECTS requests. Once subscribed, the peer writes the
+*  RSC_SIM_CP_WRITES commands to the SC Control Point back to back. It
+*  confirms each indication on the next connection event, but has a single
+*  ATT transaction: a new indication is refused while one is unconfirmed.
+*
+*  The link layer attends a connection event when the application forces
+*  quick transmit (the default), when data is queued for the peer, or when it
+*  has skipped as many events in a row as the slave latency allows. Only the
+*  attended events wake the "MCU".
+*
+*  With RSC_SIM_TRANSFER the peer exchanges the MTU, subscribes to the
+*  session transfer Data characteristic and downloads the stored workouts
+*  from the given offset. The stack holds HOST_TX_BUFFERS notifications and
+*  is busy while they are all taken; the link layer sends up to
+*  HOST_LL_PDUS_PER_EVENT packets of HOST_LL_PAYLOAD_SIZE bytes in a
+*  connection event, a notification longer than a packet takes several.
+*
+*  With RSC_SIM_BOND the peer pairs and bonds on its first connection; the
+*  stack keeps the bond in its list once the application stores the bonding
+*  data. With RSC_SIM_LINK_LOSS the peer leaves for a while: the link is lost
+*  when it stays away longer than the supervision timeout. A peer that is
+*  back connects to high duty cycle directed advertising at its own address
+*  within HOST_DIRECTED_CONNECT_US, like a phone that kept the connection
+*  pending, but takes RSC_SIM_CONNECT_SECONDS to find undirected advertising.
+*  A directed burst ends after HOST_DIRECTED_ADV_US.
+*
+*  Undirected advertising sends an event every advertising interval plus the
+*  mean random advDelay, and ends after the advertising timeout; the fast
+*  advertising of the component goes on with the slow one. The peer connects
+*  at the first advertising event it sees once it is ready. The summary
+*  gives the charge of the advertising events and the average current over
+*  the run with the DeepSleep floor, the connection events, and the
+*  Hibernate floor from the Hibernate to the end of the run. Hibernate ends
+*  the run; the time the armed Motion_Int interrupt would wake the device is
+*  reported.
+*
+*  With RSC_SIM_NTF_OFF the peer unsubscribes from the RSC Measurement
+*  notifications for a while. The stack refuses a notification with
+*  CYBLE_ERROR_INVALID_STATE when not connected, CYBLE_ERROR_NTF_DISABLED
+*  when the peer is not subscribed and CYBLE_ERROR_MEMORY_ALLOCATION_FAILED
+*  when its buffers are full; the summary counts them with the throughput
+*  of the notifications over the connected time and the wakeups.
+*
+*  The link has the RSC_SIM_PATH_LOSS path loss. The RSSI of the central's
+*  packets follows from it and HOST_PEER_TX_DBM, a few dB apart from one
+*  packet to the next. A packet of the device is lost with a probability
+*  that grows from 0 to 1 as its level at the central falls through the
+*  last HOST_PER_FADE_DB above HOST_PEER_SENSITIVITY_DBM. A lost packet ends
+*  the connection event and is sent again at the next one; RSC Measurement
+*  notifications take stack buffers until they are acknowledged, like the
+*  session transfer ones. When the central hears nothing for the
+*  supervision timeout the link is lost. Every attended connection event
+*  costs HOST_CONN_EVENT_NC and the airtime of the packets at the TX current
+*  of the TX power level.
+*
+*  UART_DEB is modelled at 115200 baud: every byte keeps the TX buffer busy
+*  for one character time, which prevents Deep Sleep like on the device. The
+*  bytes are written to stdout, or to the RSC_SIM_UART_FILE file.
+*
+*  Environment:
+*   RSC_SIM_SECONDS       - simulated run time in seconds (default 60).
+*   RSC_SIM_CONN_INTERVAL - connection interval the peer connects with, in
+*                           1.25 ms units (default 24).
+*   RSC_SIM_CONN_REJECTS  - connection parameter requests to reject (default 0).
+*   RSC_SIM_CONNECT_SECONDS - time from the start of advertising until the
+*                           peer connects (default 1), e.g. to record a
+*                           workout before the first connection.
+*   RSC_SIM_UART_FILE     - file that receives the UART_DEB output.
+*   RSC_SIM_CP_WRITES     - SC Control Point writes, separated by ';', as
+*                           comma separated hex bytes, e.g. "02;01,10,27,0,0".
+*   RSC_SIM_IND_LOSS      - indication confirmations the peer loses (default
+*                           0). The transaction times out after 30 s.
+*   RSC_SIM_TRANSFER      - stream offset the peer downloads the session
+*                           transfer from, e.g. 0 for all stored pages.
+*   RSC_SIM_MTU           - receive MTU of the peer (default 247).
+*   RSC_SIM_BOND          - 1 to have the peer bond (default 0).
+*   RSC_SIM_LINK_LOSS     - times the peer leaves and how long it stays away,
+*                           in seconds, separated by ';', e.g. "20,3;40,12".
+*   RSC_SIM_NTF_OFF       - times the peer unsubscribes from the RSC
+*                           Measurement notifications and for how long, in
+*                           seconds, separated by ';', e.g. "100,30".
+*   RSC_SIM_PATH_LOSS     - path loss in dB from the given times in seconds
+*                           on, separated by ';', e.g. "0,55;60,80" (default
+*                           55, a foot pod about a metre from the central).
+*   RSC_SIM_STATS_READ    - time in seconds the peer reads the Power
+*                           Statistics Counters characteristic; the summary
+*                           gives the value it read as 32-bit words.
+*   RSC_SIM_FLASH_FILE    - flash image that is loaded at start and written
+*                           back at the end, so a run can carry on from the
+*                           previous one like after a reset.
+*   RSC_SIM_REPLAY        - UART_DEB capture of an EVENT_TRACE build whose
+*                           BLE event trace is replayed; RSC_SIM_SECONDS
+*                           doesn't apply.
+*
+*  With RSC_SIM_REPLAY the scripted peer stays idle and the events of a BLE
+*  event trace (see evtrace_defs.h) reach the handlers at the recorded times
+*  instead, with the stack in the recorded state; the link is up while the
+*  trace says connected. The stack's own events are dropped, and SW2 isn't
+*  pressed: the trace only holds the BLE events. The run ends
+*  HOST_REPLAY_TAIL_US after the last event of the trace.
+*
+*  SysTick counts the host's monotonic clock down at CYDEV_BCLK__SYSCLK__HZ,
+*  so the cycle profiler reports the host time of the firmware code.
+*
+*  A flash row write stalls the CPU for HOST_FLASH_ROW_WRITE_US. The summary
+*  reports the stall time and an energy estimate from HOST_FLASH_WRITE_UA.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "project.h"
+#include "binlog_defs.h"
+#include "evtrace_defs.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+#define HOST_DEFAULT_DURATION_SEC       (60u)
+#define HOST_DEFAULT_CONN_INTERVAL      (24u)
+#define HOST_CONN_INTERVAL_UNIT_US      (1250u)
+#define HOST_DEFAULT_SUPERVISION_TO     (500u)
+#define HOST_CENTRAL_INTERVAL_STEP      (12u)
+#define HOST_CONN_UPDATE_INSTANT        (6u)
+#define HOST_CONNECT_DELAY_US           (1000000u)
+#define HOST_DIRECTED_ADV_US            (1280000u)
+#define HOST_DIRECTED_ADV_PERIOD_US     (3750u)
+#define HOST_DIRECTED_CONNECT_US        (5000u)
+#define HOST_SUPERVISION_TO_UNIT_US     (10000u)
+#define HOST_DISCONNECT_TIMEOUT         (0x08u)
+#define HOST_LINK_LOSSES_MAX            (8u)
+#define HOST_NTF_OFF_MAX                (8u)
+
+/* Fast and slow advertising of the BLE component customizer defaults, in
+* 0.625 ms units and seconds
+*/
+#define HOST_ADV_UNIT_US                (625u)
+#define HOST_ADV_DELAY_US               (5000u)
+#define HOST_FAST_ADV_INT_MIN           (0x0020u)
+#define HOST_FAST_ADV_INT_MAX           (0x0030u)
+#define HOST_FAST_ADV_TIMEOUT           (30u)
+#define HOST_SLOW_ADV_INT_MIN           (0x0640u)
+#define HOST_SLOW_ADV_INT_MAX           (0x4000u)
+#define HOST_SLOW_ADV_TIMEOUT           (150u)
+
+/* Charge of an advertising event on the three channels: the ECO start-up
+* and about 0.9 ms of TX and RX at 16.5 mA. DeepSleep with the WCO and
+* Hibernate currents from the CY8C4247LQI-BL483 datasheet.
+*/
+#define HOST_ADV_EVENT_NC               (15000u)
+#define HOST_DEEPSLEEP_NA               (1300u)
+#define HOST_HIBERNATE_NA               (150u)
+
+/* Radio link of the connection: the central's TX power and sensitivity, the
+* fading range and the RSSI spread
+*/
+#define HOST_PATH_LOSS_DB               (55)
+#define HOST_PATH_LOSSES_MAX            (8u)
+#define HOST_PEER_TX_DBM                (0)
+#define HOST_PEER_SENSITIVITY_DBM       (-90)
+#define HOST_PER_FADE_DB                (10)
+#define HOST_RSSI_SPREAD_DB             (2)
+#define HOST_PER_SCALE                  (1000u)
+
+/* Charge of an attended connection event without the TX: the ECO start-up
+* and receiving the central's packet. Airtime of an empty and of a full
+* packet at 1 Mbps with the TX ramp-up.
+*/
+#define HOST_CONN_EVENT_NC              (3000u)
+#define HOST_LL_EMPTY_PDU_US            (210u)
+#define HOST_LL_DATA_PDU_US             (426u)
+#define HOST_BUTTON_PERIOD_US           (20000000u)
+#define HOST_USEC_PER_SEC               (1000000u)
+#define HOST_LFCLK_HZ                   (32768u)
+#define HOST_WDT_COUNTER_PERIOD         (65536u)
+
+#define HOST_UART_CHAR_TIME_US          (87u)
+#define HOST_PRINTF_BUFFER_SIZE         (256u)
+
+#define HOST_EVENT_QUEUE_SIZE           (16u)
+#define HOST_EVENT_PARAM_SIZE           (32u)
+
+#define HOST_SERVICE_GENERIC            (0u)
+#define HOST_SERVICE_RSCS               (1u)
+
+#define HOST_RSC_MEASUREMENT_INIT_FLAGS (0x03u)
+#define HOST_RSC_FEATURE_INIT           (0x0017u)
+#define HOST_SENSOR_LOCATION_INIT       (0x02u)
+#define HOST_ATTR_MAX_SIZE              (20u)
+#define HOST_CP_WRITES_MAX              (4u)
+#define HOST_CP_RESPONSES_SIZE          (64u)
+#define HOST_ATT_TIMEOUT_US             (30000000u)
+
+/* Stack buffers and the link layer packets of a connection event, as most
+* centrals allow without the LE Data Length Extension
+*/
+#define HOST_DEFAULT_MTU                (247u)
+#define HOST_TX_BUFFERS                 (4u)
+
+/* Largest value of the Power Statistics Counters characteristic */
+#define HOST_STATS_VALUE_MAX            (64u)
+#define HOST_LL_PAYLOAD_SIZE            (27u)
+#define HOST_LL_PDUS_PER_EVENT          (6u)
+#define HOST_L2CAP_HEADER_SIZE          (4u)
+#define HOST_ATT_NTF_HEADER_SIZE        (3u)
+#define HOST_TRANSFER_OFFSET_SIZE       (4u)
+#define HOST_TRANSFER_START_SIZE        (5u)
+
+/* Row erase and program time, and the supply current meanwhile: datasheet
+* figures for the CY8C4247LQI-BL483 at 3 V.
+*/
+#define HOST_FLASH_ROW_WRITE_US         (20000u)
+#define HOST_FLASH_WRITE_UA             (2500u)
+#define HOST_SUPPLY_MV                  (3000u)
+
+/* Run time left after the last event of a replayed trace */
+#define HOST_REPLAY_TAIL_US             (1000000u)
+
+
+/* TX current at the power levels in uA, indexed by CYBLE_BLESS_PWR_LVL_T,
+* approximate CY8C4247LQI-BL483 figures, and their output power in dBm
+*/
+static const uint16 hostTxCurrentUa[CYBLE_LL_PWR_LVL_MAX] =
+{
+    0u, 10500u, 11500u, 13000u, 14500u, 15000u, 15700u, 16500u, 20000u
+};
+static const int8 hostTxPowerDbm[CYBLE_LL_PWR_LVL_MAX] =
+{
+    0, -18, -12, -6, -3, -2, -1, 0, 3
+};
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint64_t due;
+    uint32 event;
+    uint8 service;
+    uint8 param[HOST_EVENT_PARAM_SIZE];
+} HOST_EVENT_T;
+
+typedef struct
+{
+    uint8 val[HOST_ATTR_MAX_SIZE];
+    uint8 len;
+} HOST_ATTR_T;
+
+typedef struct
+{
+    uint64_t due;
+    uint32 event;
+    uint8 source;
+    uint8 len;
+    uint8 param[EVTRACE_PARAM_MAX];
+} HOST_TRACE_T;
+
+
+/***************************************
+*        Global Variables
+***************************************/
+uint8 cyBle_pendingFlashWrite = 0u;
+uint8 hostFlash[CY_FLASH_SIZE];
+
+static CYBLE_GAPP_DISC_PARAM_T hostAdvParam =
+{
+    0x0020u, 0x0030u, CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV, 0x00u, 0x00u, {0u}, 0x07u, 0x00u
+};
+CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo = {0x02u, &hostAdvParam, 30u};
+
+static uint64_t             hostNowUs;
+/* Host checks that don't start the stack let the time run freely */
+static uint64_t             hostEndUs = UINT64_MAX;
+static uint64_t             hostConnectAtUs;
+static uint64_t             hostConnectDelayUs = HOST_CONNECT_DELAY_US;
+static uint64_t             hostAdvEndUs = UINT64_MAX;
+static uint8                hostAdvDirected;
+static uint8                hostAdvSlowNext;
+static uint64_t             hostAdvPeriodUs;
+static uint64_t             hostAdvStartUs;
+static uint64_t             hostNextAdvEventUs;
+static uint64_t             hostPeerReadyUs = UINT64_MAX;
+static uint32               hostAdvEvents;
+static uint64_t             hostHibernateUs;
+static uint64_t             hostNextButtonUs;
+static uint32               hostConnIntervalUs;
+static uint64_t             hostNextConnEventUs;
+static uint16               hostInitialConnInterval;
+static CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T hostConnParam;
+static uint32               hostConnRejects;
+static uint8                hostQuickTransmit = 1u;
+static uint8                hostTxPending;
+static uint16               hostSkipRun;
+static CYBLE_STATE_T        hostBleState = CYBLE_STATE_STOPPED;
+static CYBLE_CALLBACK_T     hostAppCallback;
+static CYBLE_CALLBACK_T     hostRscsCallback;
+static CYBLE_CONN_HANDLE_T  hostConnHandle;
+static uint8                hostNtfEnabled;
+static uint8                hostIndEnabled;
+static uint8                hostIndOutstanding;
+static uint64_t             hostIndTimeoutUs;
+static uint32               hostIndLosses;
+static uint32               hostIndLost;
+
+/* Scripted SC Control Point writes and the responses they got */
+static HOST_ATTR_T          hostCpWrites[HOST_CP_WRITES_MAX];
+static CYBLE_GATT_VALUE_T   hostCpValues[HOST_CP_WRITES_MAX];
+static uint8                hostCpWriteCount;
+static char                 hostCpResponses[HOST_CP_RESPONSES_SIZE];
+
+/* Notifications waiting for the link layer, bytes left of each L2CAP frame */
+static uint16               hostTxFrames[HOST_TX_BUFFERS];
+static uint8                hostTxHead;
+static uint8                hostTxCount;
+static uint16               hostMtu = CYBLE_GATT_DEFAULT_MTU;
+
+/* Scripted session transfer download */
+static uint8                hostTransferEnabled;
+static uint32               hostTransferFrom;
+static uint16               hostClientMtu = HOST_DEFAULT_MTU;
+static uint8                hostTransferCccd[2u] = {0x01u, 0x00u};
+static uint8                hostTransferStart[HOST_TRANSFER_START_SIZE];
+static CYBLE_GATTS_WRITE_REQ_PARAM_T hostTransferWrites[2u];
+static uint8                hostTransferDone;
+static uint64_t             hostTransferStartUs;
+static uint64_t             hostTransferEndUs;
+static uint32               hostTransferFirst;
+static uint32               hostTransferNext;
+static uint32               hostTransferBytes;
+static uint32               hostTransferNtfs;
+static uint32               hostTransferGaps;
+static uint32               hostErrorRsps;
+
+/* Scripted bonding and link losses of the peer */
+static const CYBLE_GAP_BD_ADDR_T hostPeerAddr = {{0x3Cu, 0x5Au, 0x11u, 0xD0u, 0x7Eu, 0xF4u}, 0x00u};
+static uint8                hostBondEnabled;
+static uint8                hostBondPending;
+static CYBLE_GAP_BONDED_DEV_ADDR_LIST_T hostBondList;
+static uint64_t             hostLossAtUs[HOST_LINK_LOSSES_MAX];
+static uint64_t             hostLossBackUs[HOST_LINK_LOSSES_MAX];
+static uint8                hostLossCount;
+static uint64_t             hostConnectedUs;
+static uint64_t             hostConnectedTotalUs;
+static uint64_t             hostDisconnectedUs;
+static uint32               hostLinkLosses;
+static uint32               hostReconnects;
+static uint32               hostReconnectsDirected;
+static uint32               hostDirectedBursts;
+static uint64_t             hostReconnectTotalUs;
+static uint64_t             hostReconnectMaxUs;
+static uint64_t             hostReconnectBackUs;
+
+/* Radio link of the connection and the TX power of the channel groups */
+static uint64_t             hostPathLossAtUs[HOST_PATH_LOSSES_MAX];
+static int16                hostPathLossDb[HOST_PATH_LOSSES_MAX] = {HOST_PATH_LOSS_DB};
+static uint8                hostPathLossCount = 1u;
+static CYBLE_BLESS_PWR_LVL_T hostTxPower[CYBLE_LL_MAX_CH_TYPE] = {CYBLE_LL_PWR_LVL_0_DBM, CYBLE_LL_PWR_LVL_0_DBM};
+static uint32               hostTxPowerChanges;
+static int8                 hostRssi = 127;
+static uint32               hostRandState = 1u;
+static uint64_t             hostPeerHeardUs;
+static uint32               hostPdus;
+static uint32               hostPdusLost;
+static uint32               hostLinkDrops;
+static uint64_t             hostConnNc;
+
+/* GATT database value of the Power Statistics Counters characteristic and
+* what the peer read of it
+*/
+static uint8                hostStatsValue[HOST_STATS_VALUE_MAX];
+static uint16               hostStatsLen;
+static uint8                hostStatsRead[HOST_STATS_VALUE_MAX];
+static uint16               hostStatsReadLen;
+static uint64_t             hostStatsReadAtUs = UINT64_MAX;
+static uint64_t             hostStatsReadUs = UINT64_MAX;
+static uint8                hostStatsEnabled;
+static uint64_t             hostTxPc;
+
+static HOST_EVENT_T         hostEvents[HOST_EVENT_QUEUE_SIZE];
+static uint8                hostEventCount;
+
+/* Replayed trace and the storage of its values while they are handled */
+static uint8                hostReplay;
+static HOST_TRACE_T        *hostTrace;
+static uint32               hostTraceCount;
+static uint32               hostTraceNext;
+static uint32               hostTraceUndecoded;
+static uint8                hostTraceValue[EVTRACE_VALUE_MAX];
+static CYBLE_GATT_VALUE_T   hostTraceGattValue;
+
+static HOST_ATTR_T          hostRscsDb[CYBLE_RSCS_CHAR_COUNT];
+
+static uint8                hostIntEnabled;
+static cyisraddress         hostWdtIsr;
+static cyisraddress         hostSw2Isr;
+static uint8                hostSw2Enabled;
+static uint8                hostSw2Pending;
+static cyisraddress         hostMotionIsr;
+static uint8                hostMotionEnabled;
+static uint8                hostMotionPending;
+static uint64_t             hostMotionAtUs = UINT64_MAX;
+
+static uint64_t             hostSysTickBaseNs;
+static uint32               hostSysTickReload = CY_SYS_SYST_RVR_CNT_MASK;
+
+static uint32               hostWdtMatch;
+static uint32               hostWdtClearOnMatch;
+static uint32               hostWdtEnabled;
+static uint32               hostWdtIntSource;
+static uint64_t             hostWdtStartTicks;
+static uint64_t             hostWdtNextIrqTicks;
+
+static FILE                *hostUartOut;
+static uint64_t             hostUartIdleUs;
+static uint32               hostUartBytes;
+
+static uint32               hostNotifications;
+static uint32               hostNotificationBytes;
+
+/* RSC Measurement notifications the stack refused, and the times the peer
+* unsubscribes from them and subscribes again
+*/
+static uint32               hostNtfBuffersFull;
+static uint32               hostNtfDisabled;
+static uint32               hostNtfInvalidState;
+static uint64_t             hostNtfOffAtUs[HOST_NTF_OFF_MAX];
+static uint64_t             hostNtfOnAtUs[HOST_NTF_OFF_MAX];
+static uint8                hostNtfOffCount;
+static uint8                hostNtfOffNext;
+static uint8                hostNtfOff;
+static uint32               hostIndications;
+static uint32               hostDeepSleeps;
+static uint32               hostSleeps;
+static uint32               hostWdtIrqs;
+static uint32               hostButtonPresses;
+static uint32               hostConnEvents;
+static uint32               hostConnSkipped;
+static uint32               hostConnParamRequests;
+static uint32               hostConnParamRejected;
+static uint32               hostFlashWrites;
+static const char          *hostFlashFile;
+
+
+/***************************************
+*        Simulation helpers
+***************************************/
+static uint64_t HostUsToTicks(uint64_t us)
+{
+    return((us * HOST_LFCLK_HZ) / HOST_USEC_PER_SEC);
+}
+
+static uint64_t HostTicksToUs(uint64_t ticks)
+{
+    /* Round up so the wakeup lands on or after the tick */
+    return(((ticks * HOST_USEC_PER_SEC) + HOST_LFCLK_HZ - 1u) / HOST_LFCLK_HZ);
+}
+
+static uint32 HostWdtPeriod(void)
+{
+    return((0u != hostWdtClearOnMatch) ? (hostWdtMatch + 1u) : HOST_WDT_COUNTER_PERIOD);
+}
+
+static void HostWdtRearm(void)
+{
+    uint64_t nowTicks = HostUsToTicks(hostNowUs);
+    uint64_t elapsed = nowTicks - hostWdtStartTicks;
+    uint32 period = HostWdtPeriod();
+    uint64_t base = hostWdtStartTicks + (elapsed - (elapsed % period));
+
+    /* First tick after now where the counter equals the match value */
+    hostWdtNextIrqTicks = base + ((0u != hostWdtClearOnMatch) ? period : (hostWdtMatch & 0xFFFFu));
+    if(hostWdtNextIrqTicks <= nowTicks)
+    {
+        hostWdtNextIrqTicks += period;
+    }
+}
+
+/* Prints the advertising charge and the average current over the run */
+static void HostPrintCurrent(void)
+{
+    uint64_t endUs = (0u != hostHibernateUs) ? hostEndUs : hostNowUs;
+    uint64_t awakeUs = (0u != hostHibernateUs) ? hostHibernateUs : hostNowUs;
+    uint64_t advNc = (uint64_t) hostAdvEvents * HOST_ADV_EVENT_NC;
+    uint64_t totalNc;
+    uint64_t averageNa;
+    char hibernate[64];
+
+    /* nA x us is 1e-6 nC, nC per us is mA */
+    totalNc = advNc + hostConnNc + (hostTxPc / 1000u) + ((awakeUs * HOST_DEEPSLEEP_NA) / HOST_USEC_PER_SEC) +
+              (((endUs - awakeUs) * HOST_HIBERNATE_NA) / HOST_USEC_PER_SEC);
+    averageNa = (0u != endUs) ? ((totalNc * 1000000u) / endUs) : 0u;
+
+    if(0u == hostHibernateUs)
+    {
+        (void) snprintf(hibernate, sizeof(hibernate), "no hibernate");
+    }
+    else if((0u != hostMotionEnabled) && (UINT64_MAX != hostMotionAtUs))
+    {
+        (void) snprintf(hibernate, sizeof(hibernate), "hibernate at %lu s, motion wake at %lu s",
+            (unsigned long) (hostHibernateUs / HOST_USEC_PER_SEC), (unsigned long) (hostMotionAtUs / HOST_USEC_PER_SEC));
+    }
+    else
+    {
+        (void) snprintf(hibernate, sizeof(hibernate), "hibernate at %lu s, no motion wake",
+            (unsigned long) (hostHibernateUs / HOST_USEC_PER_SEC));
+    }
+    fprintf(stdout, "[host] advertising: %lu events, %lu uC, %s, %lu.%03lu uA average over %lu s\r\n",
+           (unsigned long) hostAdvEvents, (unsigned long) (advNc / 1000u), hibernate,
+           (unsigned long) (averageNa / 1000u), (unsigned long) (averageNa % 1000u),
+           (unsigned long) (endUs / HOST_USEC_PER_SEC));
+}
+
+static void HostPrintSummary(void)
+{
+    FILE *file;
+    uint64_t duration;
+    uint64_t connected;
+    uint16 i;
+
+    if((NULL != hostUartOut) && (stdout != hostUartOut))
+    {
+        fclose(hostUartOut);
+    }
+    if(NULL != hostFlashFile)
+    {
+        file = fopen(hostFlashFile, "wb");
+        if(NULL != file)
+        {
+            (void) fwrite(hostFlash, 1u, sizeof(hostFlash), file);
+            fclose(file);
+        }
+    }
+    fprintf(stdout, "[host] simulated %lu.%03lu s: %lu notifications (%lu bytes), %lu indications, "
+           "%lu deep sleeps, %lu sleeps, %lu WDT interrupts, %lu button presses\r\n",
+           (unsigned long) (hostNowUs / HOST_USEC_PER_SEC),
+           (unsigned long) ((hostNowUs % HOST_USEC_PER_SEC) / 1000u),
+           (unsigned long) hostNotifications, (unsigned long) hostNotificationBytes,
+           (unsigned long) hostIndications, (unsigned long) hostDeepSleeps,
+           (unsigned long) hostSleeps, (unsigned long) hostWdtIrqs,
+           (unsigned long) hostButtonPresses);
+    if(0u != hostReplay)
+    {
+        fprintf(stdout, "[host] replay: %lu of %lu trace events, %lu not decoded\r\n",
+               (unsigned long) hostTraceNext, (unsigned long) hostTraceCount,
+               (unsigned long) hostTraceUndecoded);
+    }
+
+    /* Every return from Sleep or Deep-Sleep is a wakeup */
+    connected = hostConnectedTotalUs + ((CYBLE_STATE_CONNECTED == hostBleState) ? (hostNowUs - hostConnectedUs) : 0u);
+    fprintf(stdout, "[host] link: %lu notifications refused (%lu buffers full, %lu disabled, %lu invalid state), "
+           "%lu.%03lu bytes/s over %lu s connected, %lu wakeups, %lu.%02lu per second\r\n",
+           (unsigned long) (hostNtfBuffersFull + hostNtfDisabled + hostNtfInvalidState),
+           (unsigned long) hostNtfBuffersFull, (unsigned long) hostNtfDisabled, (unsigned long) hostNtfInvalidState,
+           (unsigned long) ((0u != connected) ? ((hostNotificationBytes * (uint64_t) HOST_USEC_PER_SEC) / connected) : 0u),
+           (unsigned long) ((0u != connected) ?
+               (((hostNotificationBytes * (uint64_t) HOST_USEC_PER_SEC * 1000u) / connected) % 1000u) : 0u),
+           (unsigned long) (connected / HOST_USEC_PER_SEC),
+           (unsigned long) (hostDeepSleeps + hostSleeps),
+           (unsigned long) ((0u != hostNowUs) ? (((uint64_t) (hostDeepSleeps + hostSleeps) * HOST_USEC_PER_SEC) / hostNowUs) : 0u),
+           (unsigned long) ((0u != hostNowUs) ?
+               ((((uint64_t) (hostDeepSleeps + hostSleeps) * HOST_USEC_PER_SEC * 100u) / hostNowUs) % 100u) : 0u));
+
+    /* UART_DEB traffic keeps the device out of Deep-Sleep for the whole
+    * transfer and the host CPU time stands in for the firmware cycles spent
+    * formatting it.
+    */
+    fprintf(stdout, "[host] connection: %lu events attended, %lu skipped, %lu parameter requests (%lu rejected), "
+           "interval %lu.%02lu ms, latency %u, supervision timeout %u ms\r\n",
+           (unsigned long) hostConnEvents, (unsigned long) hostConnSkipped, (unsigned long) hostConnParamRequests,
+           (unsigned long) hostConnParamRejected,
+           (unsigned long) ((hostConnParam.connIntv * HOST_CONN_INTERVAL_UNIT_US) / 1000u),
+           (unsigned long) (((hostConnParam.connIntv * HOST_CONN_INTERVAL_UNIT_US) % 1000u) / 10u),
+           hostConnParam.connLatency, hostConnParam.supervisionTO * 10u);
+
+    /* uA x us x mV is 1e-15 J, printed in uJ */
+    fprintf(stdout, "[host] flash: %lu row writes, %lu ms CPU stall, %lu uJ\r\n",
+           (unsigned long) hostFlashWrites,
+           (unsigned long) ((hostFlashWrites * HOST_FLASH_ROW_WRITE_US) / 1000u),
+           (unsigned long) (((uint64_t) hostFlashWrites * HOST_FLASH_ROW_WRITE_US * HOST_FLASH_WRITE_UA *
+                             HOST_SUPPLY_MV) / 1000000000u));
+
+    fprintf(stdout, "[host] SC Control Point: %u writes, responses:%s, %lu confirmations lost\r\n",
+           hostCpWriteCount, ('\0' != hostCpResponses[0]) ? hostCpResponses : " none", (unsigned long) hostIndLost);
+
+    if(0u != hostTransferEnabled)
+    {
+        duration = ((0u != hostTransferEndUs) ? hostTransferEndUs : hostNowUs) - hostTransferStartUs;
+        fprintf(stdout, "[host] session transfer: %s, MTU %u, offsets %lu-%lu, %lu bytes in %lu notifications, "
+               "%lu ms, %lu bytes/s, %lu gaps, %lu error responses\r\n",
+               (0u != hostTransferEndUs) ? "done" : "incomplete", hostMtu,
+               (unsigned long) hostTransferFirst, (unsigned long) hostTransferNext,
+               (unsigned long) hostTransferBytes, (unsigned long) hostTransferNtfs,
+               (unsigned long) (duration / 1000u),
+               (unsigned long) ((0u != duration) ? ((hostTransferBytes * (uint64_t) HOST_USEC_PER_SEC) / duration) : 0u),
+               (unsigned long) hostTransferGaps, (unsigned long) hostErrorRsps);
+    }
+
+    if((0u != hostLossCount) || (0u != hostBondEnabled))
+    {
+        fprintf(stdout, "[host] reconnect: %lu link losses, %lu reconnections in %lu ms average, %lu ms max, "
+               "%lu ms average after the peer was back, %lu to directed advertising, %lu directed bursts\r\n",
+               (unsigned long) hostLinkLosses, (unsigned long) hostReconnects,
+               (unsigned long) ((0u != hostReconnects) ? ((hostReconnectTotalUs / hostReconnects) / 1000u) : 0u),
+               (unsigned long) (hostReconnectMaxUs / 1000u),
+               (unsigned long) ((0u != hostReconnects) ? ((hostReconnectBackUs / hostReconnects) / 1000u) : 0u),
+               (unsigned long) hostReconnectsDirected,
+               (unsigned long) hostDirectedBursts);
+    }
+
+    if(0u != hostConnEvents)
+    {
+        /* uA x us is 1e-12 C */
+        fprintf(stdout, "[host] radio: TX power %d dBm at the end, %lu changes, RSSI %d dBm, %lu packets, "
+               "%lu lost, %lu link drops, %lu uC in connection events, %lu uC of it TX\r\n",
+               hostTxPowerDbm[hostTxPower[CYBLE_LL_CONN_CH_TYPE]], (unsigned long) hostTxPowerChanges, hostRssi,
+               (unsigned long) hostPdus, (unsigned long) hostPdusLost, (unsigned long) hostLinkDrops,
+               (unsigned long) ((hostConnNc + (hostTxPc / 1000u)) / 1000u),
+               (unsigned long) (hostTxPc / 1000000u));
+    }
+
+    if(0u != hostStatsEnabled)
+    {
+        if(UINT64_MAX == hostStatsReadUs)
+        {
+            fprintf(stdout, "[host] Power Statistics: not read\r\n");
+        }
+        else
+        {
+            fprintf(stdout, "[host] Power Statistics: read at %lu s, %u bytes:",
+                   (unsigned long) (hostStatsReadUs / HOST_USEC_PER_SEC), hostStatsReadLen);
+            for(i = 0u; (i + 4u) <= hostStatsReadLen; i += 4u)
+            {
+                fprintf(stdout, " %lu", (unsigned long) ((uint32) hostStatsRead[i] |
+                       ((uint32) hostStatsRead[i + 1u] << 8u) | ((uint32) hostStatsRead[i + 2u] << 16u) |
+                       ((uint32) hostStatsRead[i + 3u] << 24u)));
+            }
+            fprintf(stdout, "\r\n");
+        }
+    }
+
+    HostPrintCurrent();
+
+    fprintf(stdout, "[host] UART_DEB: %lu bytes (%lu ms busy), host CPU time %lu ms\r\n",
+           (unsigned long) hostUartBytes,
+           (unsigned long) (((uint64_t) hostUartBytes * HOST_UART_CHAR_TIME_US) / 1000u),
+           (unsigned long) (((uint64_t) clock() * 1000u) / CLOCKS_PER_SEC));
+}
+
+static void HostPostEvent(uint8 service, uint32 event, const void *param, uint32 size, uint64_t due)
+{
+    HOST_EVENT_T *evt;
+
+    /* A replayed trace brings the events of the stack and the peer */
+    if(0u != hostReplay)
+    {
+        return;
+    }
+
+    if(hostEventCount < HOST_EVENT_QUEUE_SIZE)
+    {
+        evt = &hostEvents[hostEventCount++];
+        evt->due = due;
+        evt->event = event;
+        evt->service = service;
+        memset(evt->param, 0, sizeof(evt->param));
+        if(NULL != param)
+        {
+            memcpy(evt->param, param, (size < HOST_EVENT_PARAM_SIZE) ? size : HOST_EVENT_PARAM_SIZE);
+        }
+    }
+}
+
+static void HostRunIsrs(void)
+{
+    if((0u != hostIntEnabled) && (0u != hostWdtIntSource) && (NULL != hostWdtIsr))
+    {
+        hostWdtIsr();
+    }
+    if((0u != hostIntEnabled) && (0u != hostSw2Pending) && (NULL != hostSw2Isr))
+    {
+        hostSw2Pending = 0u;
+        hostSw2Isr();
+    }
+    if((0u != hostIntEnabled) && (0u != hostMotionEnabled) && (0u != hostMotionPending) && (NULL != hostMotionIsr))
+    {
+        hostMotionIsr();
+    }
+}
+
+/* Returns a pseudo-random number below range, the same in every run */
+static uint32 HostRandom(uint32 range)
+{
+    hostRandState = (hostRandState * 1103515245u) + 12345u;
+    return((hostRandState >> 16u) % range);
+}
+
+/* Returns the path loss at t */
+static int16 HostPathLossDb(uint64_t t)
+{
+    int16 lossDb = hostPathLossDb[0u];
+    uint8 i;
+
+    for(i = 1u; (i < hostPathLossCount) && (t >= hostPathLossAtUs[i]); i++)
+    {
+        lossDb = hostPathLossDb[i];
+    }
+    return(lossDb);
+}
+
+/* Sends a packet at the TX power of the connection channels, returns
+* non-zero when the central receives it
+*/
+static uint8 HostSendPdu(uint32 airUs, int16 pathLossDb)
+{
+    CYBLE_BLESS_PWR_LVL_T level = hostTxPower[CYBLE_LL_CONN_CH_TYPE];
+    int32 marginDb = (int32) hostTxPowerDbm[level] - pathLossDb - HOST_PEER_SENSITIVITY_DBM;
+    uint32 per = 0u;
+    uint8 received = 1u;
+
+    if(marginDb <= 0)
+    {
+        per = HOST_PER_SCALE;
+    }
+    else if(marginDb < HOST_PER_FADE_DB)
+    {
+        per = ((uint32) (HOST_PER_FADE_DB - marginDb) * HOST_PER_SCALE) / HOST_PER_FADE_DB;
+    }
+    else
+    {
+        /* Received with margin */
+    }
+
+    hostPdus++;
+    hostTxPc += (uint64_t) airUs * hostTxCurrentUa[level];
+    if(HostRandom(HOST_PER_SCALE) < per)
+    {
+        hostPdusLost++;
+        received = 0u;
+    }
+    else
+    {
+        hostPeerHeardUs = hostNextConnEventUs;
+    }
+    return(received);
+}
+
+/* Sends the queued notifications in the packets of a connection event. A
+* packet the central doesn't receive ends the event.
+*/
+static void HostDrainTx(void)
+{
+    uint8 pdus = HOST_LL_PDUS_PER_EVENT;
+    uint8 wasBusy = (HOST_TX_BUFFERS == hostTxCount) ? 1u : 0u;
+    uint8 status = CYBLE_STACK_STATE_FREE;
+    int16 pathLossDb = HostPathLossDb(hostNextConnEventUs);
+
+    hostConnNc += HOST_CONN_EVENT_NC;
+    hostRssi = (int8) (HOST_PEER_TX_DBM - pathLossDb + (int16) HostRandom((2u * HOST_RSSI_SPREAD_DB) + 1u) -
+                       HOST_RSSI_SPREAD_DB);
+
+    /* An empty packet answers the central when nothing is queued */
+    if(0u == hostTxCount)
+    {
+        (void) HostSendPdu(HOST_LL_EMPTY_PDU_US, pathLossDb);
+    }
+    while((0u != pdus) && (0u != hostTxCount))
+    {
+        pdus--;
+        if(0u == HostSendPdu(HOST_LL_DATA_PDU_US, pathLossDb))
+        {
+            break;
+        }
+        if(hostTxFrames[hostTxHead] > HOST_LL_PAYLOAD_SIZE)
+        {
+            hostTxFrames[hostTxHead] -= HOST_LL_PAYLOAD_SIZE;
+        }
+        else
+        {
+            hostTxHead = (hostTxHead + 1u) % HOST_TX_BUFFERS;
+            hostTxCount--;
+        }
+    }
+
+    if((0u != wasBusy) && (HOST_TX_BUFFERS != hostTxCount))
+    {
+        HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_STACK_BUSY_STATUS, &status, sizeof(status), hostNowUs);
+    }
+    if((0u != hostTransferDone) && (0u == hostTxCount) && (0u == hostTransferEndUs))
+    {
+        hostTransferEndUs = hostNowUs;
+    }
+    hostTxPending = (0u != hostTxCount) ? 1u : 0u;
+}
+
+/* Returns when the peer is in range again, t unless it is away at t */
+static uint64_t HostPeerBackUs(uint64_t t)
+{
+    uint8 i;
+
+    for(i = 0u; i < hostLossCount; i++)
+    {
+        if((t >= hostLossAtUs[i]) && (t < hostLossBackUs[i]))
+        {
+            t = hostLossBackUs[i];
+        }
+    }
+    return(t);
+}
+
+/* Returns when the supervision timeout ends the connection, the first
+* time the peer stays away for longer than it
+*/
+static uint64_t HostLinkLossUs(void)
+{
+    uint64_t timeoutUs = (uint64_t) hostConnParam.supervisionTO * HOST_SUPERVISION_TO_UNIT_US;
+    uint8 i;
+
+    for(i = 0u; i < hostLossCount; i++)
+    {
+        if((hostLossAtUs[i] >= hostConnectedUs) && ((hostLossBackUs[i] - hostLossAtUs[i]) > timeoutUs))
+        {
+            return(hostLossAtUs[i] + timeoutUs);
+        }
+    }
+    return(UINT64_MAX);
+}
+
+/* Next time the peer writes the RSC Measurement CCCD, skipping the
+* RSC_SIM_NTF_OFF windows that ended while it was not connected
+*/
+static uint64_t HostNtfToggleUs(void)
+{
+    while((hostNtfOffNext < hostNtfOffCount) && (0u == hostNtfOff) && (hostNtfOnAtUs[hostNtfOffNext] <= hostNowUs))
+    {
+        hostNtfOffNext++;
+    }
+    if(hostNtfOffNext >= hostNtfOffCount)
+    {
+        return(UINT64_MAX);
+    }
+    return((0u != hostNtfOff) ? hostNtfOnAtUs[hostNtfOffNext] : hostNtfOffAtUs[hostNtfOffNext]);
+}
+
+/* Ends the connection on the supervision timeout. The events queued for
+* the connection are dropped with it.
+*/
+static void HostDisconnect(void)
+{
+    uint8 reason = HOST_DISCONNECT_TIMEOUT;
+
+    hostBleState = CYBLE_STATE_DISCONNECTED;
+    hostConnectedTotalUs += hostNowUs - hostConnectedUs;
+    hostDisconnectedUs = hostNowUs;
+    hostPeerReadyUs = HostPeerBackUs(hostNowUs) + hostConnectDelayUs;
+    hostLinkLosses++;
+    hostNtfEnabled = 0u;
+    hostNtfOff = 0u;
+    hostIndEnabled = 0u;
+    hostIndOutstanding = 0u;
+    hostTxCount = 0u;
+    hostTxPending = 0u;
+    hostEventCount = 0u;
+
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GATT_DISCONNECT_IND, &hostConnHandle,
+        sizeof(hostConnHandle), hostNowUs);
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAP_DEVICE_DISCONNECTED, &reason,
+        sizeof(reason), hostNowUs);
+}
+
+/* Moves virtual time forward, latching any interrupts that fall due */
+static void HostAdvanceTo(uint64_t t)
+{
+    CYBLE_RSCS_CHAR_VALUE_T rscsParam;
+
+    if(t > hostEndUs)
+    {
+        t = hostEndUs;
+    }
+
+    hostNowUs = t;
+
+    if(0u != hostWdtEnabled)
+    {
+        while(HostUsToTicks(hostNowUs) >= hostWdtNextIrqTicks)
+        {
+            hostWdtIntSource |= CY_SYS_WDT_COUNTER1_INT;
+            hostWdtNextIrqTicks += HostWdtPeriod();
+            hostWdtIrqs++;
+        }
+    }
+
+    while((CYBLE_STATE_CONNECTED == hostBleState) && (hostNowUs >= hostNextConnEventUs))
+    {
+        if((0u != hostQuickTransmit) || (0u != hostTxPending) || (hostSkipRun >= hostConnParam.connLatency))
+        {
+            hostConnEvents++;
+            hostSkipRun = 0u;
+            hostTxPending = 0u;
+
+            /* Nothing gets through while the peer is away */
+            if(HostPeerBackUs(hostNextConnEventUs) == hostNextConnEventUs)
+            {
+                HostDrainTx();
+            }
+            else
+            {
+                hostTxPending = (0u != hostTxCount) ? 1u : 0u;
+                hostPeerHeardUs = hostNextConnEventUs;
+            }
+
+            /* The central gives up when it hears nothing for the supervision timeout */
+            if((hostNextConnEventUs - hostPeerHeardUs) >
+               ((uint64_t) hostConnParam.supervisionTO * HOST_SUPERVISION_TO_UNIT_US))
+            {
+                hostLinkDrops++;
+                HostDisconnect();
+                break;
+            }
+        }
+        else
+        {
+            hostConnSkipped++;
+            hostSkipRun++;
+        }
+        hostNextConnEventUs += hostConnIntervalUs;
+    }
+
+    while((CYBLE_STATE_ADVERTISING == hostBleState) && (hostNowUs >= hostNextAdvEventUs))
+    {
+        hostAdvEvents++;
+        hostNextAdvEventUs += hostAdvPeriodUs;
+    }
+
+    if(hostNowUs >= hostMotionAtUs)
+    {
+        hostMotionPending = 1u;
+        hostMotionAtUs = UINT64_MAX;
+    }
+
+    if((CYBLE_STATE_CONNECTED == hostBleState) && (hostNowUs >= HostLinkLossUs()))
+    {
+        HostDisconnect();
+    }
+
+    /* The peer unsubscribes from the notifications for a while */
+    if((CYBLE_STATE_CONNECTED == hostBleState) && (hostNowUs >= HostNtfToggleUs()))
+    {
+        memset(&rscsParam, 0, sizeof(rscsParam));
+        rscsParam.connHandle = hostConnHandle;
+        rscsParam.charIndex = CYBLE_RSCS_RSC_MEASUREMENT;
+        if(0u != hostNtfOff)
+        {
+            HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED, &rscsParam,
+                sizeof(rscsParam), hostNowUs);
+            hostNtfOff = 0u;
+            hostNtfOffNext++;
+        }
+        else
+        {
+            HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED, &rscsParam,
+                sizeof(rscsParam), hostNowUs);
+            hostNtfOff = 1u;
+        }
+    }
+
+    /* The peer reads the value the firmware last wrote to the database */
+    if((CYBLE_STATE_CONNECTED == hostBleState) && (hostNowUs >= hostStatsReadAtUs))
+    {
+        memcpy(hostStatsRead, hostStatsValue, hostStatsLen);
+        hostStatsReadLen = hostStatsLen;
+        hostStatsReadUs = hostNowUs;
+        hostStatsReadAtUs = UINT64_MAX;
+        hostTxPending = 1u;
+    }
+
+    if((CYBLE_STATE_CONNECTED == hostBleState) && (hostNowUs >= hostNextButtonUs))
+    {
+        hostNextButtonUs += HOST_BUTTON_PERIOD_US;
+        if(0u != hostSw2Enabled)
+        {
+            hostSw2Pending = 1u;
+            hostButtonPresses++;
+        }
+    }
+}
+
+/* Returns the time of the next BLE activity or interrupt after now */
+static uint64_t HostNextWakeup(void)
+{
+    uint64_t next = hostEndUs;
+    uint64_t t;
+    uint8 i;
+
+    if(CYBLE_STATE_CONNECTED == hostBleState)
+    {
+        /* The next connection event the link layer will attend */
+        t = hostNextConnEventUs;
+        if((0u == hostQuickTransmit) && (0u == hostTxPending) && (hostSkipRun < hostConnParam.connLatency))
+        {
+            t += (uint64_t) (hostConnParam.connLatency - hostSkipRun) * hostConnIntervalUs;
+        }
+        next = (t < next) ? t : next;
+        next = (hostNextButtonUs < next) ? hostNextButtonUs : next;
+        t = HostLinkLossUs();
+        next = (t < next) ? t : next;
+        t = HostNtfToggleUs();
+        next = (t < next) ? t : next;
+    }
+    else if(CYBLE_STATE_ADVERTISING == hostBleState)
+    {
+        next = (hostNextAdvEventUs < next) ? hostNextAdvEventUs : next;
+        next = (hostConnectAtUs < next) ? hostConnectAtUs : next;
+        next = (hostAdvEndUs < next) ? hostAdvEndUs : next;
+    }
+    else
+    {
+        /* Nothing scheduled on the radio */
+    }
+
+    next = (hostMotionAtUs < next) ? hostMotionAtUs : next;
+
+    /* The TX done interrupt ends a Sleep started while the UART was busy */
+    if(hostUartIdleUs > hostNowUs)
+    {
+        next = (hostUartIdleUs < next) ? hostUartIdleUs : next;
+    }
+
+    if(0u != hostWdtEnabled)
+    {
+        t = HostTicksToUs(hostWdtNextIrqTicks);
+        next = (t < next) ? t : next;
+    }
+
+    for(i = 0u; i < hostEventCount; i++)
+    {
+        next = (hostEvents[i].due < next) ? hostEvents[i].due : next;
+    }
+    if(hostTraceNext < hostTraceCount)
+    {
+        next = (hostTrace[hostTraceNext].due < next) ? hostTrace[hostTraceNext].due : next;
+    }
+
+    return((next > hostNowUs) ? next : (hostNowUs + 1u));
+}
+
+/* Starts a phase of the undirected advertising with the current parameters
+* and finds the advertising event the peer connects at: the first one once
+* it is ready and in range.
+*/
+static void HostAdvStartPhase(void)
+{
+    uint64_t readyUs = (hostPeerReadyUs > hostNowUs) ? hostPeerReadyUs : hostNowUs;
+    uint64_t t = hostNextAdvEventUs;
+
+    hostAdvStartUs = hostNowUs;
+    hostAdvPeriodUs = ((uint64_t) cyBle_discoveryModeInfo.advParam->advIntvMin * HOST_ADV_UNIT_US) +
+                      HOST_ADV_DELAY_US;
+    hostAdvEndUs = (0u != cyBle_discoveryModeInfo.advTo) ?
+        (hostNowUs + ((uint64_t) cyBle_discoveryModeInfo.advTo * HOST_USEC_PER_SEC)) : UINT64_MAX;
+
+    readyUs = HostPeerBackUs(readyUs);
+    if(readyUs > t)
+    {
+        t += ((readyUs - t + hostAdvPeriodUs - 1u) / hostAdvPeriodUs) * hostAdvPeriodUs;
+    }
+    hostConnectAtUs = ((0u == hostReplay) && (t < hostAdvEndUs)) ? t : UINT64_MAX;
+}
+
+/* Posts the peer's MTU exchange request and sets up its transfer writes */
+static void HostExchangeMtu(void)
+{
+    CYBLE_GATT_XCHG_MTU_PARAM_T mtuParam;
+
+    mtuParam.connHandle = hostConnHandle;
+    mtuParam.mtu = hostClientMtu;
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GATTS_XCNHG_MTU_REQ, &mtuParam, sizeof(mtuParam),
+        hostNowUs + hostConnIntervalUs);
+
+    hostTransferWrites[0u].handleValPair.attrHandle =
+        CYBLE_SESSION_TRANSFER_DATA_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE;
+    hostTransferWrites[0u].handleValPair.value.val = hostTransferCccd;
+    hostTransferWrites[0u].handleValPair.value.len = sizeof(hostTransferCccd);
+    hostTransferWrites[0u].handleValPair.value.actualLen = sizeof(hostTransferCccd);
+
+    hostTransferStart[0u] = 0x01u;
+    hostTransferStart[1u] = LO8(hostTransferFrom);
+    hostTransferStart[2u] = HI8(hostTransferFrom);
+    hostTransferStart[3u] = LO8(hostTransferFrom >> 16u);
+    hostTransferStart[4u] = HI8(hostTransferFrom >> 16u);
+    hostTransferWrites[1u].handleValPair.attrHandle = CYBLE_SESSION_TRANSFER_CONTROL_CHAR_HANDLE;
+    hostTransferWrites[1u].handleValPair.value.val = hostTransferStart;
+    hostTransferWrites[1u].handleValPair.value.len = sizeof(hostTransferStart);
+    hostTransferWrites[1u].handleValPair.value.actualLen = sizeof(hostTransferStart);
+}
+
+static void HostConnect(void)
+{
+    CYBLE_RSCS_CHAR_VALUE_T rscsParam;
+    CYBLE_GAP_AUTH_INFO_T authInfo;
+    uint8 i;
+
+    if(0u != hostDisconnectedUs)
+    {
+        hostReconnects++;
+        hostReconnectTotalUs += hostNowUs - hostDisconnectedUs;
+        hostReconnectBackUs += hostNowUs - HostPeerBackUs(hostDisconnectedUs);
+        if((hostNowUs - hostDisconnectedUs) > hostReconnectMaxUs)
+        {
+            hostReconnectMaxUs = hostNowUs - hostDisconnectedUs;
+        }
+        if(0u != hostAdvDirected)
+        {
+            hostReconnectsDirected++;
+        }
+        hostDisconnectedUs = 0u;
+    }
+
+    hostBleState = CYBLE_STATE_CONNECTED;
+    hostConnectedUs = hostNowUs;
+    hostPeerHeardUs = hostNowUs;
+    hostAdvEndUs = UINT64_MAX;
+    hostConnHandle.bdHandle = 0u;
+    hostConnHandle.attId = 0u;
+    hostNextButtonUs = hostNowUs + HOST_BUTTON_PERIOD_US;
+
+    hostConnParam.status = 0u;
+    hostConnParam.connIntv = hostInitialConnInterval;
+    hostConnParam.connLatency = 0u;
+    hostConnParam.supervisionTO = HOST_DEFAULT_SUPERVISION_TO;
+    hostConnIntervalUs = hostConnParam.connIntv * HOST_CONN_INTERVAL_UNIT_US;
+    hostNextConnEventUs = hostNowUs + hostConnIntervalUs;
+    hostQuickTransmit = 1u;
+    hostSkipRun = 0u;
+
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GATT_CONNECT_IND, &hostConnHandle,
+        sizeof(hostConnHandle), hostNowUs);
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAP_DEVICE_CONNECTED, &hostConnParam,
+        sizeof(hostConnParam), hostNowUs);
+
+    /* A new peer pairs and bonds first */
+    if((0u != hostBondEnabled) && (0u == hostBondList.count))
+    {
+        authInfo.security = 0x01u;
+        authInfo.bonding = CYBLE_GAP_BONDING;
+        authInfo.ekeySize = 16u;
+        authInfo.authErr = 0u;
+        HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAP_AUTH_COMPLETE, &authInfo, sizeof(authInfo),
+            hostNowUs + (3u * hostConnIntervalUs));
+    }
+
+    /* The peer subscribes right after the service discovery */
+    memset(&rscsParam, 0, sizeof(rscsParam));
+    rscsParam.connHandle = hostConnHandle;
+    rscsParam.charIndex = CYBLE_RSCS_RSC_MEASUREMENT;
+    HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED, &rscsParam,
+        sizeof(rscsParam), hostNowUs + hostConnIntervalUs);
+    rscsParam.charIndex = CYBLE_RSCS_SC_CONTROL_POINT;
+    HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_INDICATION_ENABLED, &rscsParam,
+        sizeof(rscsParam), hostNowUs + (2u * hostConnIntervalUs));
+
+    /* The download starts once the MTU is exchanged and the Data CCCD written */
+    hostMtu = CYBLE_GATT_DEFAULT_MTU;
+    hostTxCount = 0u;
+    if(0u != hostTransferEnabled)
+    {
+        HostExchangeMtu();
+        for(i = 0u; i < 2u; i++)
+        {
+            hostTransferWrites[i].connHandle = hostConnHandle;
+            HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GATTS_WRITE_REQ, &hostTransferWrites[i],
+                sizeof(hostTransferWrites[i]), hostNowUs + ((4u + i) * (uint64_t) hostConnIntervalUs));
+        }
+    }
+
+    /* The companion app writes its commands without waiting for the responses */
+    for(i = 0u; i < hostCpWriteCount; i++)
+    {
+        hostCpValues[i].val = hostCpWrites[i].val;
+        hostCpValues[i].len = hostCpWrites[i].len;
+        hostCpValues[i].actualLen = hostCpWrites[i].len;
+        rscsParam.value = &hostCpValues[i];
+        HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_CHAR_WRITE, &rscsParam,
+            sizeof(rscsParam), hostNowUs + (3u * hostConnIntervalUs));
+    }
+}
+
+/* Parses RSC_SIM_NTF_OFF */
+static void HostParseNtfOff(const char *env)
+{
+    char *end;
+    double at;
+    double off;
+
+    while(hostNtfOffCount < HOST_NTF_OFF_MAX)
+    {
+        at = strtod(env, &end);
+        if((end == env) || (',' != *end))
+        {
+            break;
+        }
+        env = end + 1;
+        off = strtod(env, &end);
+        if(end == env)
+        {
+            break;
+        }
+        hostNtfOffAtUs[hostNtfOffCount] = (uint64_t) (at * HOST_USEC_PER_SEC);
+        hostNtfOnAtUs[hostNtfOffCount] = hostNtfOffAtUs[hostNtfOffCount] + (uint64_t) (off * HOST_USEC_PER_SEC);
+        hostNtfOffCount++;
+        env = strchr(end, ';');
+        if(NULL == env)
+        {
+            break;
+        }
+        env++;
+    }
+}
+
+/* Parses RSC_SIM_LINK_LOSS */
+static void HostParseLinkLosses(const char *env)
+{
+    char *end;
+    double at;
+    double away;
+
+    while(hostLossCount < HOST_LINK_LOSSES_MAX)
+    {
+        at = strtod(env, &end);
+        if((end == env) || (',' != *end))
+        {
+            break;
+        }
+        env = end + 1;
+        away = strtod(env, &end);
+        if(end == env)
+        {
+            break;
+        }
+        hostLossAtUs[hostLossCount] = (uint64_t) (at * HOST_USEC_PER_SEC);
+        hostLossBackUs[hostLossCount] = hostLossAtUs[hostLossCount] + (uint64_t) (away * HOST_USEC_PER_SEC);
+        hostLossCount++;
+        env = strchr(end, ';');
+        if(NULL == env)
+        {
+            break;
+        }
+        env++;
+    }
+}
+
+/* Parses RSC_SIM_PATH_LOSS */
+static void HostParsePathLosses(const char *env)
+{
+    char *end;
+    double at;
+    long lossDb;
+
+    hostPathLossCount = 0u;
+    while(hostPathLossCount < HOST_PATH_LOSSES_MAX)
+    {
+        at = strtod(env, &end);
+        if((end == env) || (',' != *end))
+        {
+            break;
+        }
+        env = end + 1;
+        lossDb = strtol(env, &end, 10);
+        if(end == env)
+        {
+            break;
+        }
+        hostPathLossAtUs[hostPathLossCount] = (uint64_t) (at * HOST_USEC_PER_SEC);
+        hostPathLossDb[hostPathLossCount] = (int16) lossDb;
+        hostPathLossCount++;
+        env = strchr(end, ';');
+        if(NULL == env)
+        {
+            break;
+        }
+        env++;
+    }
+    if(0u == hostPathLossCount)
+    {
+        hostPathLossDb[0u] = HOST_PATH_LOSS_DB;
+        hostPathLossCount = 1u;
+    }
+}
+
+/* Parses RSC_SIM_CP_WRITES */
+static void HostParseCpWrites(const char *env)
+{
+    char *end;
+    HOST_ATTR_T *write;
+
+    while(('\0' != *env) && (hostCpWriteCount < HOST_CP_WRITES_MAX))
+    {
+        write = &hostCpWrites[hostCpWriteCount++];
+        write->len = 0u;
+        while(write->len < HOST_ATTR_MAX_SIZE)
+        {
+            write->val[write->len] = (uint8) strtoul(env, &end, 16);
+            if(end == env)
+            {
+                break;
+            }
+            write->len++;
+            env = end;
+            if(',' != *env)
+            {
+                break;
+            }
+            env++;
+        }
+        env = strchr(env, ';');
+        if(NULL == env)
+        {
+            break;
+        }
+        env++;
+    }
+}
+
+/* Reads an LEB128 varint from a trace record, returns 0 on truncation */
+static uint8 HostReadVarint(const uint8 *buff, uint32 len, uint32 *pos, uint32 *value)
+{
+    uint32 shift = 0u;
+    uint8 byte;
+
+    *value = 0u;
+    do
+    {
+        if((*pos >= len) || (shift > (4u * BINLOG_VARINT_SHIFT)))
+        {
+            return(0u);
+        }
+        byte = buff[(*pos)++];
+        *value |= ((uint32) (byte & BINLOG_VARINT_MASK)) << shift;
+        shift += BINLOG_VARINT_SHIFT;
+    }
+    while(0u != (byte & BINLOG_VARINT_MORE));
+
+    return(1u);
+}
+
+/* Loads the event trace records of RSC_SIM_REPLAY, a UART_DEB capture. The
+* text and the binary log frames around them are skipped.
+*/
+static void HostLoadTrace(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8 header[BINLOG_FRAME_HEADER_SIZE];
+    uint8 record[UINT8_MAX];
+    uint64_t ticks = 0u;
+    uint32 size = 0u;
+    uint32 pos;
+    uint32 value;
+    uint32 len;
+    HOST_TRACE_T *rec;
+    int ch;
+
+    if(NULL == file)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    while(EOF != (ch = fgetc(file)))
+    {
+        if(BINLOG_SYNC0 == ch)
+        {
+            if(fread(&header[1u], 1u, BINLOG_FRAME_HEADER_SIZE - 1u, file) != (BINLOG_FRAME_HEADER_SIZE - 1u))
+            {
+                break;
+            }
+            if(BINLOG_SYNC1 == header[1u])
+            {
+                (void) fseek(file, (long) header[2u] | ((long) header[3u] << 8u), SEEK_CUR);
+            }
+            continue;
+        }
+        if(EVTRACE_SYNC0 != ch)
+        {
+            continue;
+        }
+        ch = fgetc(file);
+        if(EVTRACE_SYNC1 != ch)
+        {
+            (void) ungetc(ch, file);
+            continue;
+        }
+        ch = fgetc(file);
+        if((EOF == ch) || (fread(record, 1u, (size_t) ch, file) != (size_t) ch))
+        {
+            break;
+        }
+        len = (uint32) ch;
+
+        if(hostTraceCount == size)
+        {
+            size = (0u != size) ? (2u * size) : 256u;
+            hostTrace = realloc(hostTrace, size * sizeof(HOST_TRACE_T));
+        }
+        rec = &hostTrace[hostTraceCount];
+        memset(rec, 0, sizeof(*rec));
+
+        pos = 0u;
+        if((0u == HostReadVarint(record, len, &pos, &value)) || (pos >= len))
+        {
+            hostTraceUndecoded++;
+            continue;
+        }
+        ticks += value;
+        rec->due = HostTicksToUs(ticks);
+        rec->source = record[pos++];
+        if(0u == HostReadVarint(record, len, &pos, &rec->event))
+        {
+            hostTraceUndecoded++;
+            continue;
+        }
+        rec->len = (uint8) (((len - pos) < EVTRACE_PARAM_MAX) ? (len - pos) : EVTRACE_PARAM_MAX);
+        memcpy(rec->param, &record[pos], rec->len);
+        hostTraceCount++;
+    }
+    fclose(file);
+}
+
+/* Sets the value a trace record carries from the given offset on */
+static CYBLE_GATT_VALUE_T * HostTraceValue(const HOST_TRACE_T *rec, uint8 offset)
+{
+    hostTraceGattValue.len = (rec->len > offset) ? (rec->len - offset) : 0u;
+    hostTraceGattValue.actualLen = hostTraceGattValue.len;
+    hostTraceGattValue.val = hostTraceValue;
+    memcpy(hostTraceValue, &rec->param[offset], hostTraceGattValue.len);
+    return(&hostTraceGattValue);
+}
+
+/* Turns a trace record back into the event parameter of the stack, returns
+* 0 when the record is too short for it
+*/
+static uint8 HostTraceDecode(const HOST_TRACE_T *rec, HOST_EVENT_T *evt)
+{
+    const uint8 *p = rec->param;
+    CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T connParam;
+    CYBLE_GATTS_WRITE_REQ_PARAM_T writeReq;
+    CYBLE_GATT_XCHG_MTU_PARAM_T mtuParam;
+    CYBLE_RSCS_CHAR_VALUE_T charValue;
+    CYBLE_GAP_AUTH_INFO_T authInfo;
+    uint16 value16;
+    uint32 value32;
+    uint8 size = 0u;
+
+    evt->due = rec->due;
+    evt->event = rec->event;
+    evt->service = (EVTRACE_SOURCE_RSCS == (rec->source & EVTRACE_SOURCE_MASK)) ?
+        HOST_SERVICE_RSCS : HOST_SERVICE_GENERIC;
+    memset(evt->param, 0, sizeof(evt->param));
+
+    switch(rec->event)
+    {
+    case CYBLE_EVT_TIMEOUT:
+    case CYBLE_EVT_STACK_BUSY_STATUS:
+    case CYBLE_EVT_GAP_AUTH_FAILED:
+    case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+    case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
+    case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
+        evt->param[0u] = p[0u];
+        size = 1u;
+        break;
+    case CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+        value16 = (uint16) (p[0u] | ((uint16) p[1u] << 8u));
+        memcpy(evt->param, &value16, sizeof(value16));
+        size = 2u;
+        break;
+    case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
+        value32 = (uint32) p[0u] | ((uint32) p[1u] << 8u) | ((uint32) p[2u] << 16u) | ((uint32) p[3u] << 24u);
+        memcpy(evt->param, &value32, sizeof(value32));
+        size = 4u;
+        break;
+    case CYBLE_EVT_GAP_AUTH_REQ:
+    case CYBLE_EVT_GAP_AUTH_COMPLETE:
+        authInfo.security = p[0u];
+        authInfo.bonding = p[1u];
+        authInfo.ekeySize = p[2u];
+        authInfo.authErr = p[3u];
+        memcpy(evt->param, &authInfo, sizeof(authInfo));
+        size = 4u;
+        break;
+    case CYBLE_EVT_GAP_DEVICE_CONNECTED:
+    case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
+        connParam.status = p[0u];
+        connParam.connIntv = (uint16) (p[1u] | ((uint16) p[2u] << 8u));
+        connParam.connLatency = (uint16) (p[3u] | ((uint16) p[4u] << 8u));
+        connParam.supervisionTO = (uint16) (p[5u] | ((uint16) p[6u] << 8u));
+        memcpy(evt->param, &connParam, sizeof(connParam));
+        size = 7u;
+        break;
+    case CYBLE_EVT_GATT_CONNECT_IND:
+    case CYBLE_EVT_GATT_DISCONNECT_IND:
+        evt->param[0u] = p[0u];
+        evt->param[1u] = p[1u];
+        size = 2u;
+        break;
+    case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
+        mtuParam.connHandle.bdHandle = p[0u];
+        mtuParam.connHandle.attId = p[1u];
+        mtuParam.mtu = (uint16) (p[2u] | ((uint16) p[3u] << 8u));
+        memcpy(evt->param, &mtuParam, sizeof(mtuParam));
+        size = 4u;
+        break;
+    case CYBLE_EVT_GATTS_WRITE_REQ:
+        writeReq.connHandle.bdHandle = p[0u];
+        writeReq.connHandle.attId = p[1u];
+        writeReq.handleValPair.attrHandle = (uint16) (p[2u] | ((uint16) p[3u] << 8u));
+        writeReq.handleValPair.value = *HostTraceValue(rec, 4u);
+        memcpy(evt->param, &writeReq, sizeof(writeReq));
+        size = 4u;
+        break;
+    case CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED:
+    case CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_ENABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_DISABLED:
+    case CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION:
+    case CYBLE_EVT_RSCSS_CHAR_WRITE:
+        charValue.connHandle.bdHandle = p[0u];
+        charValue.connHandle.attId = p[1u];
+        charValue.charIndex = (CYBLE_RSCS_CHAR_INDEX_T) p[2u];
+        /* Only a write is sure to carry a value */
+        charValue.value = ((rec->len > 3u) || (CYBLE_EVT_RSCSS_CHAR_WRITE == rec->event)) ?
+            HostTraceValue(rec, 3u) : NULL;
+        memcpy(evt->param, &charValue, sizeof(charValue));
+        size = 3u;
+        break;
+    default:
+        /* No parameter */
+        break;
+    }
+
+    return((rec->len >= size) ? 1u : 0u);
+}
+
+/* Brings the link to the stack state of a trace record: the peer of the
+* trace connects and disconnects, the scripted one doesn't press SW2
+*/
+static void HostReplayState(CYBLE_STATE_T state)
+{
+    if((CYBLE_STATE_CONNECTED == state) && (CYBLE_STATE_CONNECTED != hostBleState))
+    {
+        HostConnect();
+        hostNextButtonUs = UINT64_MAX;
+    }
+    else if((CYBLE_STATE_CONNECTED != state) && (CYBLE_STATE_CONNECTED == hostBleState))
+    {
+        HostDisconnect();
+    }
+    else
+    {
+        /* The link stays as it is */
+    }
+    hostBleState = state;
+}
+
+static void HostDispatch(const HOST_EVENT_T *evt)
+{
+    void *param = (void *) evt->param;
+
+    if(HOST_SERVICE_RSCS == evt->service)
+    {
+        if(CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED == evt->event)
+        {
+            hostNtfEnabled = 1u;
+        }
+        else if(CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED == evt->event)
+        {
+            hostNtfEnabled = 0u;
+        }
+        else if(CYBLE_EVT_RSCSS_INDICATION_ENABLED == evt->event)
+        {
+            hostIndEnabled = 1u;
+        }
+        else if(CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION == evt->event)
+        {
+            hostIndOutstanding = 0u;
+        }
+        else
+        {
+            /* No CCCD change */
+        }
+
+        if(NULL != hostRscsCallback)
+        {
+            hostRscsCallback(evt->event, param);
+        }
+    }
+    else if(NULL != hostAppCallback)
+    {
+        if(CYBLE_EVT_GATTS_XCNHG_MTU_REQ == evt->event)
+        {
+            /* The stack answers with its own MTU */
+            hostMtu = (hostClientMtu < CYBLE_GATT_MTU) ? hostClientMtu : CYBLE_GATT_MTU;
+        }
+        else if((CYBLE_EVT_GATTS_WRITE_REQ == evt->event) &&
+                (CYBLE_SESSION_TRANSFER_CONTROL_CHAR_HANDLE ==
+                 ((CYBLE_GATTS_WRITE_REQ_PARAM_T *) param)->handleValPair.attrHandle))
+        {
+            hostTransferStartUs = hostNowUs;
+        }
+        else if(CYBLE_EVT_GAP_AUTH_COMPLETE == evt->event)
+        {
+            /* The keys are stored once the application calls
+            * CyBle_StoreBondingData()
+            */
+            hostBondPending = 1u;
+            cyBle_pendingFlashWrite = 1u;
+        }
+        else if((CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE == evt->event) ||
+                (CYBLE_EVT_GAP_DEVICE_CONNECTED == evt->event))
+        {
+            /* The new parameters take effect at the update instant */
+            memcpy(&hostConnParam, param, sizeof(hostConnParam));
+            hostConnIntervalUs = hostConnParam.connIntv * HOST_CONN_INTERVAL_UNIT_US;
+            hostNextConnEventUs = hostNowUs + hostConnIntervalUs;
+        }
+        hostAppCallback(evt->event, param);
+    }
+    else
+    {
+        /* No handler registered */
+    }
+}
+
+
+/***************************************
+*        cy_boot
+***************************************/
+void HostGlobalIntEnable(void)
+{
+    hostIntEnabled = 1u;
+    HostRunIsrs();
+}
+
+void HostGlobalIntDisable(void)
+{
+    hostIntEnabled = 0u;
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    uint8 savedIntrStatus = hostIntEnabled;
+
+    hostIntEnabled = 0u;
+    return(savedIntrStatus);
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    if(0u != savedIntrStatus)
+    {
+        HostGlobalIntEnable();
+    }
+}
+
+uint64_t HostGetTimeUs(void)
+{
+    return(hostNowUs);
+}
+
+void CySysWdtUnlock(void)
+{
+}
+
+void CySysWdtLock(void)
+{
+}
+
+void CySysWdtWriteMode(uint32 counterNum, uint32 mode)
+{
+    (void) counterNum;
+    (void) mode;
+}
+
+void CySysWdtWriteClearOnMatch(uint32 counterNum, uint32 enable)
+{
+    (void) counterNum;
+    hostWdtClearOnMatch = enable;
+    HostWdtRearm();
+}
+
+void CySysWdtWriteMatch(uint32 counterNum, uint32 match)
+{
+    (void) counterNum;
+    hostWdtMatch = match & 0xFFFFu;
+    HostWdtRearm();
+}
+
+uint32 CySysWdtReadMatch(uint32 counterNum)
+{
+    (void) counterNum;
+    return(hostWdtMatch);
+}
+
+uint32 CySysWdtGetCount(uint32 counterNum)
+{
+    (void) counterNum;
+    return((uint32) ((HostUsToTicks(hostNowUs) - hostWdtStartTicks) % HostWdtPeriod()));
+}
+
+void CySysWdtResetCounters(uint32 countersMask)
+{
+    (void) countersMask;
+    hostWdtStartTicks = HostUsToTicks(hostNowUs);
+    HostWdtRearm();
+}
+
+void CySysWdtEnable(uint32 counterMask)
+{
+    (void) counterMask;
+    hostWdtEnabled = 1u;
+    HostWdtRearm();
+}
+
+uint32 CySysWdtGetInterruptSource(void)
+{
+    return(hostWdtIntSource);
+}
+
+void CySysWdtClearInterrupt(uint32 counterMask)
+{
+    hostWdtIntSource &= ~counterMask;
+}
+
+/* SysTick counts the host's monotonic clock down at the CPU clock rate, so
+* the profiler sees the host time of the firmware code
+*/
+static uint64_t HostMonotonicNs(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return(((uint64_t) ts.tv_sec * 1000000000u) + (uint64_t) ts.tv_nsec);
+}
+
+void CySysTickStart(void)
+{
+    hostSysTickBaseNs = HostMonotonicNs();
+}
+
+void CySysTickDisableInterrupt(void)
+{
+}
+
+void CySysTickSetReload(uint32 value)
+{
+    hostSysTickReload = value & CY_SYS_SYST_RVR_CNT_MASK;
+}
+
+void CySysTickClear(void)
+{
+    hostSysTickBaseNs = HostMonotonicNs();
+}
+
+uint32 CySysTickGetValue(void)
+{
+    uint64_t ticks = ((HostMonotonicNs() - hostSysTickBaseNs) * (CYDEV_BCLK__SYSCLK__HZ / 1000000u)) / 1000u;
+
+    return(hostSysTickReload - (uint32) (ticks % ((uint64_t) hostSysTickReload + 1u)));
+}
+
+void CySysPmSleep(void)
+{
+    hostSleeps++;
+    HostAdvanceTo(HostNextWakeup());
+}
+
+void CySysPmDeepSleep(void)
+{
+    hostDeepSleeps++;
+    HostAdvanceTo(HostNextWakeup());
+}
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    if(rowNum >= CY_FLASH_NUMBER_ROWS)
+    {
+        return(CY_SYS_FLASH_INVALID_ADDR);
+    }
+
+    memcpy(&hostFlash[rowNum * CY_FLASH_SIZEOF_ROW], rowData, CY_FLASH_SIZEOF_ROW);
+    hostFlashWrites++;
+
+    /* The CPU is stalled, the link layer keeps running */
+    HostAdvanceTo(hostNowUs + HOST_FLASH_ROW_WRITE_US);
+    return(CY_SYS_FLASH_SUCCESS);
+}
+
+void CySysPmHibernate(void)
+{
+    hostHibernateUs = hostNowUs;
+    fprintf(stdout, "[host] hibernate\r\n");
+    exit(0);
+}
+
+
+/***************************************
+*        Pins and interrupts
+***************************************/
+void Disconnect_LED_Write(uint8 value)
+{
+    (void) value;
+}
+
+void Advertising_LED_Write(uint8 value)
+{
+    (void) value;
+}
+
+void Running_LED_Write(uint8 value)
+{
+    (void) value;
+}
+
+void SW2_ClearInterrupt(void)
+{
+}
+
+void SW2_Interrupt_Start(void)
+{
+    hostSw2Enabled = 1u;
+}
+
+void SW2_Interrupt_StartEx(cyisraddress address)
+{
+    hostSw2Isr = address;
+    hostSw2Enabled = 1u;
+}
+
+void SW2_Interrupt_ClearPending(void)
+{
+    hostSw2Pending = 0u;
+}
+
+void Motion_Int_ClearInterrupt(void)
+{
+    hostMotionPending = 0u;
+}
+
+void Motion_Interrupt_Start(void)
+{
+    hostMotionEnabled = 1u;
+}
+
+void Motion_Interrupt_StartEx(cyisraddress address)
+{
+    hostMotionIsr = address;
+    hostMotionEnabled = 1u;
+}
+
+void Motion_Interrupt_ClearPending(void)
+{
+    hostMotionPending = 0u;
+}
+
+void HostSetMotionAt(uint64_t us)
+{
+    hostMotionPending = 0u;
+    hostMotionAtUs = us;
+}
+
+void WDT_Interrupt_StartEx(cyisraddress address)
+{
+    hostWdtIsr = address;
+}
+
+
+/***************************************
+*        UART_DEB
+***************************************/
+void UART_DEB_Start(void)
+{
+}
+
+void UART_DEB_UartPutChar(uint32 txDataByte)
+{
+    if(NULL == hostUartOut)
+    {
+        hostUartOut = stdout;
+    }
+    (void) fputc((int) txDataByte, hostUartOut);
+    hostUartBytes++;
+
+    if(hostUartIdleUs < hostNowUs)
+    {
+        hostUartIdleUs = hostNowUs;
+    }
+    hostUartIdleUs += HOST_UART_CHAR_TIME_US;
+}
+
+void UART_DEB_SpiUartPutArray(const uint8 wrBuf[], uint32 count)
+{
+    uint32 i;
+
+    for(i = 0u; i < count; i++)
+    {
+        UART_DEB_UartPutChar(wrBuf[i]);
+    }
+}
+
+uint32 UART_DEB_SpiUartGetTxBufferSize(void)
+{
+    uint32 size = 0u;
+
+    if(hostUartIdleUs > hostNowUs)
+    {
+        size = (uint32) (((hostUartIdleUs - hostNowUs) + HOST_UART_CHAR_TIME_US - 1u) / HOST_UART_CHAR_TIME_US);
+
+        /* Polling the buffer takes time too, so busy-wait loops terminate */
+        HostAdvanceTo(hostNowUs + 1u);
+    }
+    return(size);
+}
+
+int HostPrintf(const char *format, ...)
+{
+    char buff[HOST_PRINTF_BUFFER_SIZE];
+    va_list args;
+    int len;
+    int i;
+
+    va_start(args, format);
+    len = vsnprintf(buff, sizeof(buff), format, args);
+    va_end(args);
+
+    for(i = 0; (i < len) && (i < (int) sizeof(buff) - 1); i++)
+    {
+        UART_DEB_UartPutChar((uint8) buff[i]);
+    }
+    return(len);
+}
+
+
+/***************************************
+*        CYBLE
+***************************************/
+void CyBle_Start(CYBLE_CALLBACK_T callbackFunc)
+{
+    const char *env;
+    FILE *file;
+    uint32 duration = HOST_DEFAULT_DURATION_SEC;
+    uint32 interval = HOST_DEFAULT_CONN_INTERVAL;
+
+    env = getenv("RSC_SIM_SECONDS");
+    if((NULL != env) && (0 != atoi(env)))
+    {
+        duration = (uint32) atoi(env);
+    }
+    env = getenv("RSC_SIM_CONN_INTERVAL");
+    if((NULL != env) && (0 != atoi(env)))
+    {
+        interval = (uint32) atoi(env);
+    }
+    env = getenv("RSC_SIM_CONN_REJECTS");
+    if(NULL != env)
+    {
+        hostConnRejects = (uint32) atoi(env);
+    }
+    env = getenv("RSC_SIM_CONNECT_SECONDS");
+    if(NULL != env)
+    {
+        hostConnectDelayUs = (uint64_t) atoi(env) * HOST_USEC_PER_SEC;
+    }
+    env = getenv("RSC_SIM_CP_WRITES");
+    if(NULL != env)
+    {
+        HostParseCpWrites(env);
+    }
+    env = getenv("RSC_SIM_TRANSFER");
+    if(NULL != env)
+    {
+        hostTransferEnabled = 1u;
+        hostTransferFrom = (uint32) strtoul(env, NULL, 0);
+    }
+    env = getenv("RSC_SIM_MTU");
+    if((NULL != env) && (0 != atoi(env)))
+    {
+        hostClientMtu = (uint16) atoi(env);
+    }
+    env = getenv("RSC_SIM_BOND");
+    if(NULL != env)
+    {
+        hostBondEnabled = (0 != atoi(env)) ? 1u : 0u;
+    }
+    env = getenv("RSC_SIM_LINK_LOSS");
+    if(NULL != env)
+    {
+        HostParseLinkLosses(env);
+    }
+    env = getenv("RSC_SIM_NTF_OFF");
+    if(NULL != env)
+    {
+        HostParseNtfOff(env);
+    }
+    env = getenv("RSC_SIM_PATH_LOSS");
+    if(NULL != env)
+    {
+        HostParsePathLosses(env);
+    }
+    env = getenv("RSC_SIM_IND_LOSS");
+    if(NULL != env)
+    {
+        hostIndLosses = (uint32) atoi(env);
+    }
+    env = getenv("RSC_SIM_STATS_READ");
+    if(NULL != env)
+    {
+        hostStatsEnabled = 1u;
+        hostStatsReadAtUs = (uint64_t) atoi(env) * HOST_USEC_PER_SEC;
+    }
+    hostFlashFile = getenv("RSC_SIM_FLASH_FILE");
+    if(NULL != hostFlashFile)
+    {
+        file = fopen(hostFlashFile, "rb");
+        if(NULL != file)
+        {
+            (void) fread(hostFlash, 1u, sizeof(hostFlash), file);
+            fclose(file);
+        }
+    }
+    env = getenv("RSC_SIM_UART_FILE");
+    if(NULL != env)
+    {
+        hostUartOut = fopen(env, "wb");
+    }
+
+    hostEndUs = (uint64_t) duration * HOST_USEC_PER_SEC;
+    env = getenv("RSC_SIM_REPLAY");
+    if(NULL != env)
+    {
+        HostLoadTrace(env);
+        hostReplay = 1u;
+        hostEndUs = ((0u != hostTraceCount) ? hostTrace[hostTraceCount - 1u].due : 0u) + HOST_REPLAY_TAIL_US;
+    }
+    hostInitialConnInterval = (uint16) interval;
+    hostConnIntervalUs = interval * HOST_CONN_INTERVAL_UNIT_US;
+    hostAppCallback = callbackFunc;
+    hostBleState = CYBLE_STATE_INITIALIZING;
+
+    hostRscsDb[CYBLE_RSCS_RSC_MEASUREMENT].val[0u] = HOST_RSC_MEASUREMENT_INIT_FLAGS;
+    hostRscsDb[CYBLE_RSCS_RSC_MEASUREMENT].len = 10u;
+    hostRscsDb[CYBLE_RSCS_RSC_FEATURE].val[0u] = LO8(HOST_RSC_FEATURE_INIT);
+    hostRscsDb[CYBLE_RSCS_RSC_FEATURE].val[1u] = HI8(HOST_RSC_FEATURE_INIT);
+    hostRscsDb[CYBLE_RSCS_RSC_FEATURE].len = 2u;
+    hostRscsDb[CYBLE_RSCS_SENSOR_LOCATION].val[0u] = HOST_SENSOR_LOCATION_INIT;
+    hostRscsDb[CYBLE_RSCS_SENSOR_LOCATION].len = 1u;
+
+    atexit(&HostPrintSummary);
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_STACK_ON, NULL, 0u, 0u);
+}
+
+void CyBle_ProcessEvents(void)
+{
+    const HOST_TRACE_T *rec;
+    HOST_EVENT_T evt;
+    uint8 i;
+
+    if(hostNowUs >= hostEndUs)
+    {
+        exit(0);
+    }
+
+    if((CYBLE_STATE_ADVERTISING == hostBleState) && (hostNowUs >= hostConnectAtUs))
+    {
+        HostConnect();
+    }
+    else if((CYBLE_STATE_ADVERTISING == hostBleState) && (hostNowUs >= hostAdvEndUs) && (0u != hostAdvSlowNext))
+    {
+        /* The fast advertising goes on with the slow one */
+        cyBle_discoveryModeInfo.advParam->advIntvMin = HOST_SLOW_ADV_INT_MIN;
+        cyBle_discoveryModeInfo.advParam->advIntvMax = HOST_SLOW_ADV_INT_MAX;
+        cyBle_discoveryModeInfo.advTo = HOST_SLOW_ADV_TIMEOUT;
+        hostAdvSlowNext = 0u;
+        HostAdvStartPhase();
+    }
+    else if((CYBLE_STATE_ADVERTISING == hostBleState) && (hostNowUs >= hostAdvEndUs))
+    {
+        /* The advertising timeout, or the end of a directed burst */
+        CyBle_GappStopAdvertisement();
+    }
+    else
+    {
+        /* Still advertising, or not advertising at all */
+    }
+
+    /* Dispatch every due event in posting order */
+    i = 0u;
+    while(i < hostEventCount)
+    {
+        if(hostEvents[i].due <= hostNowUs)
+        {
+            evt = hostEvents[i];
+            hostEventCount--;
+            memmove(&hostEvents[i], &hostEvents[i + 1u], (hostEventCount - i) * sizeof(HOST_EVENT_T));
+
+            if(CYBLE_EVT_STACK_ON == evt.event)
+            {
+                hostBleState = CYBLE_STATE_DISCONNECTED;
+            }
+            HostDispatch(&evt);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    /* Feed the replayed trace to the handlers at the recorded times */
+    while((hostTraceNext < hostTraceCount) && (hostTrace[hostTraceNext].due <= hostNowUs))
+    {
+        rec = &hostTrace[hostTraceNext++];
+        HostReplayState((CYBLE_STATE_T) (rec->source >> EVTRACE_STATE_SHIFT));
+        if(0u != HostTraceDecode(rec, &evt))
+        {
+            HostDispatch(&evt);
+        }
+        else
+        {
+            hostTraceUndecoded++;
+        }
+    }
+}
+
+CYBLE_STATE_T CyBle_GetState(void)
+{
+    return(hostBleState);
+}
+
+CYBLE_LP_MODE_T CyBle_EnterLPM(CYBLE_LP_MODE_T pwrMode)
+{
+    return(pwrMode);
+}
+
+CYBLE_BLESS_STATE_T CyBle_GetBleSsState(void)
+{
+    return(CYBLE_BLESS_STATE_ECO_ON);
+}
+
+CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr)
+{
+    static const uint8 addr[CYBLE_GAP_BD_ADDR_SIZE] = {0x00u, 0x00u, 0x50u, 0xA0u, 0x50u, 0x00u};
+
+    memcpy(bdAddr->bdAddr, addr, sizeof(addr));
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    CYBLE_API_RESULT_T result = CYBLE_ERROR_INVALID_PARAMETER;
+
+    if((NULL != bleSsPwrLvl) && (bleSsPwrLvl->bleSsChId < CYBLE_LL_MAX_CH_TYPE) &&
+       (bleSsPwrLvl->blePwrLevelInDbm >= CYBLE_LL_PWR_LVL_NEG_18_DBM) &&
+       (bleSsPwrLvl->blePwrLevelInDbm < CYBLE_LL_PWR_LVL_MAX))
+    {
+        hostTxPower[bleSsPwrLvl->bleSsChId] = bleSsPwrLvl->blePwrLevelInDbm;
+        hostTxPowerChanges++;
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl)
+{
+    CYBLE_API_RESULT_T result = CYBLE_ERROR_INVALID_PARAMETER;
+
+    if((NULL != bleSsPwrLvl) && (bleSsPwrLvl->bleSsChId < CYBLE_LL_MAX_CH_TYPE))
+    {
+        bleSsPwrLvl->blePwrLevelInDbm = hostTxPower[bleSsPwrLvl->bleSsChId];
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+int8 CyBle_GetRssi(void)
+{
+    return(hostRssi);
+}
+
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType)
+{
+    CYBLE_GAPP_DISC_PARAM_T *advParam = cyBle_discoveryModeInfo.advParam;
+    uint64_t backUs = HostPeerBackUs(hostNowUs);
+    uint8 status = 0u;
+
+    hostBleState = CYBLE_STATE_ADVERTISING;
+    hostNextAdvEventUs = hostNowUs;
+    hostAdvDirected = (CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV == advParam->advType) ? 1u : 0u;
+    hostAdvSlowNext = 0u;
+    if(0u != hostAdvDirected)
+    {
+        hostDirectedBursts++;
+        hostAdvPeriodUs = HOST_DIRECTED_ADV_PERIOD_US;
+        hostAdvEndUs = hostNowUs + HOST_DIRECTED_ADV_US;
+        hostConnectAtUs = UINT64_MAX;
+
+        /* Only the peer it is directed at connects, if it is back in time */
+        if((0u == hostReplay) && (0 == memcmp(advParam->directAddr, hostPeerAddr.bdAddr, CYBLE_GAP_BD_ADDR_SIZE)) &&
+           ((backUs + HOST_DIRECTED_CONNECT_US) < hostAdvEndUs))
+        {
+            hostConnectAtUs = backUs + HOST_DIRECTED_CONNECT_US;
+        }
+    }
+    else
+    {
+        if(CYBLE_ADVERTISING_FAST == advertisingIntervalType)
+        {
+            advParam->advIntvMin = HOST_FAST_ADV_INT_MIN;
+            advParam->advIntvMax = HOST_FAST_ADV_INT_MAX;
+            cyBle_discoveryModeInfo.advTo = HOST_FAST_ADV_TIMEOUT;
+            hostAdvSlowNext = 1u;
+        }
+        else if(CYBLE_ADVERTISING_SLOW == advertisingIntervalType)
+        {
+            advParam->advIntvMin = HOST_SLOW_ADV_INT_MIN;
+            advParam->advIntvMax = HOST_SLOW_ADV_INT_MAX;
+            cyBle_discoveryModeInfo.advTo = HOST_SLOW_ADV_TIMEOUT;
+        }
+        else
+        {
+            /* CYBLE_ADVERTISING_CUSTOM: as set by the application */
+        }
+        if(UINT64_MAX == hostPeerReadyUs)
+        {
+            hostPeerReadyUs = hostNowUs + hostConnectDelayUs;
+        }
+        HostAdvStartPhase();
+    }
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP, &status,
+        sizeof(status), hostNowUs);
+    return(CYBLE_ERROR_OK);
+}
+
+void CyBle_GappStopAdvertisement(void)
+{
+    uint8 status = 0u;
+
+    hostBleState = CYBLE_STATE_DISCONNECTED;
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP, &status,
+        sizeof(status), hostNowUs);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)
+{
+    (void) bdHandle;
+    if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        return(CYBLE_ERROR_NO_DEVICE_ENTITY);
+    }
+    *peerBdAddr = hostPeerAddr;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesList(CYBLE_GAP_BONDED_DEV_ADDR_LIST_T *bondedDevList)
+{
+    *bondedDevList = hostBondList;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_StoreBondingData(uint8 isForceWrite)
+{
+    (void) isForceWrite;
+    cyBle_pendingFlashWrite = 0u;
+    if((0u != hostBondPending) && (hostBondList.count < CYBLE_GAP_MAX_BONDED_DEVICE))
+    {
+        hostBondList.bdAddrList[hostBondList.count++] = hostPeerAddr;
+    }
+    hostBondPending = 0u;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_SetSlaveLatencyMode(uint8 bdHandle, uint8 setForceQuickTransmit)
+{
+    (void) bdHandle;
+    if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        return(CYBLE_ERROR_INVALID_STATE);
+    }
+    hostQuickTransmit = (0u != setForceQuickTransmit) ? 1u : 0u;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+    CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam)
+{
+    CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T update;
+    uint16 result = CYBLE_L2CAP_CONN_PARAM_ACCEPTED;
+    uint64_t responseUs = hostNowUs + hostConnIntervalUs;
+
+    (void) bdHandle;
+    if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        return(CYBLE_ERROR_INVALID_STATE);
+    }
+    hostConnParamRequests++;
+    hostTxPending = 1u;
+
+    if(HostPeerBackUs(hostNowUs) != hostNowUs)
+    {
+        /* The peer is away, the request goes unanswered */
+        return(CYBLE_ERROR_OK);
+    }
+
+    if(hostConnRejects > 0u)
+    {
+        hostConnRejects--;
+        hostConnParamRejected++;
+        result = CYBLE_L2CAP_CONN_PARAM_REJECTED;
+    }
+    HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP, &result,
+        sizeof(result), responseUs);
+
+    if(CYBLE_L2CAP_CONN_PARAM_ACCEPTED == result)
+    {
+        /* Longest multiple of the central's step in range, or the maximum */
+        update.status = 0u;
+        update.connIntv = (uint16) (connParam->connIntvMax - (connParam->connIntvMax % HOST_CENTRAL_INTERVAL_STEP));
+        if(update.connIntv < connParam->connIntvMin)
+        {
+            update.connIntv = connParam->connIntvMax;
+        }
+        update.connLatency = connParam->connLatency;
+        update.supervisionTO = connParam->supervisionTO;
+        HostPostEvent(HOST_SERVICE_GENERIC, CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE, &update,
+            sizeof(update), responseUs + (HOST_CONN_UPDATE_INSTANT * (uint64_t) hostConnIntervalUs));
+    }
+    return(CYBLE_ERROR_OK);
+}
+
+
+uint8 CyBle_GattGetBusyStatus(void)
+{
+    return((HOST_TX_BUFFERS == hostTxCount) ? CYBLE_STACK_STATE_BUSY : CYBLE_STACK_STATE_FREE);
+}
+
+CYBLE_GATT_ERR_CODE_T CyBle_GattsWriteAttributeValue(CYBLE_GATT_HANDLE_VALUE_PAIR_T *handleValuePair,
+    uint16 offset, CYBLE_CONN_HANDLE_T *connHandle, uint8 flags)
+{
+    (void) connHandle;
+    (void) flags;
+
+    if(CYBLE_POWER_STATISTICS_COUNTERS_CHAR_HANDLE == handleValuePair->attrHandle)
+    {
+        if((offset + handleValuePair->value.len) > HOST_STATS_VALUE_MAX)
+        {
+            return(CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
+        }
+        memcpy(&hostStatsValue[offset], handleValuePair->value.val, handleValuePair->value.len);
+        hostStatsLen = offset + handleValuePair->value.len;
+    }
+    return(CYBLE_GATT_ERR_NONE);
+}
+
+CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle)
+{
+    (void) connHandle;
+    hostTxPending = 1u;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GattsErrorRsp(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_ERR_PARAM_T *errRspParam)
+{
+    (void) connHandle;
+    (void) errRspParam;
+    hostTxPending = 1u;
+    hostErrorRsps++;
+    return(CYBLE_ERROR_OK);
+}
+
+CYBLE_API_RESULT_T CyBle_GattsNotification(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_HANDLE_VALUE_NTF_T *ntfParam)
+{
+    CYBLE_API_RESULT_T result;
+    const uint8 *val = ntfParam->value.val;
+    uint32 offset;
+    uint16 length;
+
+    (void) connHandle;
+
+    if((NULL == val) || (ntfParam->value.len > (hostMtu - HOST_ATT_NTF_HEADER_SIZE)))
+    {
+        result = CYBLE_ERROR_INVALID_PARAMETER;
+    }
+    else if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        result = CYBLE_ERROR_INVALID_STATE;
+    }
+    else if(HOST_TX_BUFFERS == hostTxCount)
+    {
+        result = CYBLE_ERROR_MEMORY_ALLOCATION_FAILED;
+    }
+    else
+    {
+        hostTxFrames[(hostTxHead + hostTxCount) % HOST_TX_BUFFERS] =
+            HOST_L2CAP_HEADER_SIZE + HOST_ATT_NTF_HEADER_SIZE + ntfParam->value.len;
+        hostTxCount++;
+        hostTxPending = 1u;
+
+        /* The peer checks that the stream is contiguous */
+        if((CYBLE_SESSION_TRANSFER_DATA_CHAR_HANDLE == ntfParam->attrHandle) &&
+           (ntfParam->value.len >= HOST_TRANSFER_OFFSET_SIZE))
+        {
+            offset = (uint32) val[0u] | ((uint32) val[1u] << 8u) | ((uint32) val[2u] << 16u) |
+                     ((uint32) val[3u] << 24u);
+            length = ntfParam->value.len - HOST_TRANSFER_OFFSET_SIZE;
+            if(0u == hostTransferNtfs)
+            {
+                hostTransferFirst = offset;
+            }
+            else if(offset != hostTransferNext)
+            {
+                hostTransferGaps++;
+            }
+            hostTransferNext = offset + length;
+            hostTransferBytes += length;
+            hostTransferNtfs++;
+            if(0u == length)
+            {
+                hostTransferDone = 1u;
+            }
+        }
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+
+/***************************************
+*        CYBLE RSCS
+***************************************/
+void CyBle_RscsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc)
+{
+    hostRscsCallback = callbackFunc;
+}
+
+CYBLE_API_RESULT_T CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_CHAR_INDEX_T charIndex,
+    uint8 attrSize, uint8 *attrValue)
+{
+    CYBLE_API_RESULT_T result = CYBLE_ERROR_INVALID_PARAMETER;
+
+    if((charIndex < CYBLE_RSCS_CHAR_COUNT) && (attrSize <= HOST_ATTR_MAX_SIZE))
+    {
+        memcpy(hostRscsDb[charIndex].val, attrValue, attrSize);
+        hostRscsDb[charIndex].len = attrSize;
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+CYBLE_API_RESULT_T CyBle_RscssGetCharacteristicValue(CYBLE_RSCS_CHAR_INDEX_T charIndex,
+    uint8 attrSize, uint8 *attrValue)
+{
+    CYBLE_API_RESULT_T result = CYBLE_ERROR_INVALID_PARAMETER;
+
+    if((charIndex < CYBLE_RSCS_CHAR_COUNT) && (attrSize <= HOST_ATTR_MAX_SIZE))
+    {
+        memcpy(attrValue, hostRscsDb[charIndex].val, attrSize);
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+CYBLE_API_RESULT_T CyBle_RscssSendNotification(CYBLE_CONN_HANDLE_T connHandle,
+    CYBLE_RSCS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue)
+{
+    CYBLE_API_RESULT_T result;
+
+    (void) connHandle;
+
+    if((CYBLE_RSCS_RSC_MEASUREMENT != charIndex) || (NULL == attrValue) || (attrSize > HOST_ATTR_MAX_SIZE))
+    {
+        result = CYBLE_ERROR_INVALID_PARAMETER;
+    }
+    else if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        result = CYBLE_ERROR_INVALID_STATE;
+        hostNtfInvalidState++;
+    }
+    else if(0u == hostNtfEnabled)
+    {
+        result = CYBLE_ERROR_NTF_DISABLED;
+        hostNtfDisabled++;
+    }
+    else if(HOST_TX_BUFFERS == hostTxCount)
+    {
+        result = CYBLE_ERROR_MEMORY_ALLOCATION_FAILED;
+        hostNtfBuffersFull++;
+    }
+    else
+    {
+        hostTxFrames[(hostTxHead + hostTxCount) % HOST_TX_BUFFERS] =
+            HOST_L2CAP_HEADER_SIZE + HOST_ATT_NTF_HEADER_SIZE + attrSize;
+        hostTxCount++;
+        hostTxPending = 1u;
+        hostNotifications++;
+        hostNotificationBytes += attrSize;
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+CYBLE_API_RESULT_T CyBle_RscssSendIndication(CYBLE_CONN_HANDLE_T connHandle,
+    CYBLE_RSCS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue)
+{
+    CYBLE_API_RESULT_T result;
+    CYBLE_RSCS_CHAR_VALUE_T rscsParam;
+    size_t used;
+    uint8 i;
+
+    if((0u != hostIndOutstanding) && (hostNowUs >= hostIndTimeoutUs))
+    {
+        /* The lost confirmation ends the ATT transaction at the timeout */
+        hostIndOutstanding = 0u;
+    }
+
+    if((CYBLE_RSCS_SC_CONTROL_POINT != charIndex) || (NULL == attrValue) || (attrSize > HOST_ATTR_MAX_SIZE))
+    {
+        result = CYBLE_ERROR_INVALID_PARAMETER;
+    }
+    else if(CYBLE_STATE_CONNECTED != hostBleState)
+    {
+        result = CYBLE_ERROR_INVALID_STATE;
+    }
+    else if(0u == hostIndEnabled)
+    {
+        result = CYBLE_ERROR_IND_DISABLED;
+    }
+    else if(0u != hostIndOutstanding)
+    {
+        result = CYBLE_ERROR_INVALID_OPERATION;
+    }
+    else
+    {
+        used = strlen(hostCpResponses);
+        if((used + (3u * attrSize) + 2u) < sizeof(hostCpResponses))
+        {
+            hostCpResponses[used++] = ' ';
+            for(i = 0u; i < attrSize; i++)
+            {
+                used += (size_t) sprintf(&hostCpResponses[used], (0u == i) ? "%02x" : ".%02x", attrValue[i]);
+            }
+        }
+
+        hostIndOutstanding = 1u;
+        hostIndTimeoutUs = hostNowUs + HOST_ATT_TIMEOUT_US;
+        if(0u != hostIndLosses)
+        {
+            hostIndLosses--;
+            hostIndLost++;
+        }
+        else
+        {
+            /* The peer confirms on the next connection event */
+            memset(&rscsParam, 0, sizeof(rscsParam));
+            rscsParam.connHandle = connHandle;
+            rscsParam.charIndex = charIndex;
+            HostPostEvent(HOST_SERVICE_RSCS, CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION, &rscsParam,
+                sizeof(rscsParam), hostNowUs + hostConnIntervalUs);
+        }
+        hostTxPending = 1u;
+        hostIndications++;
+        result = CYBLE_ERROR_OK;
+    }
+    return(result);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,210 @@
+/*******************************************************************************
+* File Name: imu_csv.c
+*
+* Version: 1.0
+*
+* Description:
+*  Reads recorded accelerometer traces, see imu_csv.h, and provides the host
+*  StrideSensorRead(): the samples of the RSC_SIM_IMU_FILE trace become
+*  available in the "sensor FIFO" as the virtual time passes their time stamp.
+*  The activity interrupt of MotionSensorArm() is raised at the first sample
+*  of the trace that is past the threshold.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "imu_csv.h"
+#include "motion.h"
+
+#define IMU_CSV_LINE_SIZE           (256u)
+#define IMU_CSV_COLUMNS_MIN         (4)
+#define IMU_CSV_MG_MAX              (32767.0)
+#define IMU_CSV_MG_MIN              (-32768.0)
+#define IMU_CSV_USEC_PER_MSEC       (1000.0)
+#define IMU_CSV_GRAVITY_MG          (1000.0)
+
+static FILE                *imuSimFile;
+static IMU_CSV_ROW_T        imuSimRow;
+static int                  imuSimRowValid;
+static int                  imuSimOpened;
+
+
+static int16 ImuCsvToMg(double value)
+{
+    if(value > IMU_CSV_MG_MAX)
+    {
+        value = IMU_CSV_MG_MAX;
+    }
+    else if(value < IMU_CSV_MG_MIN)
+    {
+        value = IMU_CSV_MG_MIN;
+    }
+    return((int16) ((value < 0.0) ? (value - 0.5) : (value + 0.5)));
+}
+
+/* Opens a trace, "-" is stdin */
+FILE * ImuCsvOpen(const char *path)
+{
+    FILE *file = (0 == strcmp(path, "-")) ? stdin : fopen(path, "r");
+
+    if(NULL == file)
+    {
+        perror(path);
+    }
+    return(file);
+}
+
+/* Reads the next sample, returns 0 at the end of the trace */
+int ImuCsvRead(FILE *file, IMU_CSV_ROW_T *row)
+{
+    char line[IMU_CSV_LINE_SIZE];
+    char *pos;
+    char *end;
+    double values[IMU_CSV_COLUMNS_MIN];
+    int i;
+
+    while(NULL != fgets(line, sizeof(line), file))
+    {
+        pos = line;
+        for(i = 0; i < IMU_CSV_COLUMNS_MIN; i++)
+        {
+            values[i] = strtod(pos, &end);
+            if((end == pos) || ((i < (IMU_CSV_COLUMNS_MIN - 1)) && (',' != *end)))
+            {
+                break;
+            }
+            pos = end + 1;
+        }
+        if(i < IMU_CSV_COLUMNS_MIN)
+        {
+            /* Comment, header or empty line */
+            continue;
+        }
+
+        row->timeMs = values[0];
+        row->sample.x = ImuCsvToMg(values[1]);
+        row->sample.y = ImuCsvToMg(values[2]);
+        row->sample.z = ImuCsvToMg(values[3]);
+        row->label[0] = '\0';
+        row->cadence = 0.0;
+        row->strideCm = 0.0;
+
+        if(',' == *end)
+        {
+            pos = end + 1;
+            i = 0;
+            while((',' != *pos) && ('\r' != *pos) && ('\n' != *pos) && ('\0' != *pos) &&
+                  (i < (int) (IMU_CSV_LABEL_SIZE - 1u)))
+            {
+                row->label[i++] = *pos++;
+            }
+            row->label[i] = '\0';
+            pos = strchr(pos, ',');
+            if(NULL != pos)
+            {
+                row->cadence = strtod(pos + 1, &end);
+                if(',' == *end)
+                {
+                    row->strideCm = strtod(end + 1, NULL);
+                }
+            }
+        }
+        return(1);
+    }
+    return(0);
+}
+
+/* Host accelerometer driver: returns the trace samples that are due by now */
+uint8 StrideSensorRead(STRIDE_SAMPLE_T * samples, uint8 maxCount)
+{
+    const char *path;
+    uint8 count = 0u;
+    double nowMs = (double) HostGetTimeUs() / IMU_CSV_USEC_PER_MSEC;
+
+    if(0 == imuSimOpened)
+    {
+        imuSimOpened = 1;
+        path = getenv("RSC_SIM_IMU_FILE");
+        if(NULL != path)
+        {
+            imuSimFile = ImuCsvOpen(path);
+        }
+    }
+
+    while((NULL != imuSimFile) && (count < maxCount))
+    {
+        if((0 == imuSimRowValid) && (0 == ImuCsvRead(imuSimFile, &imuSimRow)))
+        {
+            /* End of the trace, the sensor goes quiet */
+            fclose(imuSimFile);
+            imuSimFile = NULL;
+            break;
+        }
+        imuSimRowValid = 1;
+        if(imuSimRow.timeMs > nowMs)
+        {
+            break;
+        }
+        samples[count++] = imuSimRow.sample;
+        imuSimRowValid = 0;
+    }
+    return(count);
+}
+
+#if (STRIDE_SENSOR_ENABLED)
+/* Returns non-zero when the magnitude of the sample is more than thresholdMg
+* off the gravity
+*/
+static int ImuCsvIsMotion(const IMU_CSV_ROW_T *row, uint16 thresholdMg)
+{
+    double lowMg = IMU_CSV_GRAVITY_MG - (double) thresholdMg;
+    double highMg = IMU_CSV_GRAVITY_MG + (double) thresholdMg;
+    double squareMg = ((double) row->sample.x * row->sample.x) + ((double) row->sample.y * row->sample.y) +
+                      ((double) row->sample.z * row->sample.z);
+
+    return((squareMg < (lowMg * lowMg)) || (squareMg > (highMg * highMg)));
+}
+
+/* Host accelerometer driver: finds the sample that raises the activity
+* interrupt by reading ahead in the trace, then seeks back
+*/
+void MotionSensorArm(uint16 thresholdMg)
+{
+    IMU_CSV_ROW_T row;
+    long pos;
+    uint64_t atUs = UINT64_MAX;
+
+    if((0 != imuSimRowValid) && (0 != ImuCsvIsMotion(&imuSimRow, thresholdMg)))
+    {
+        atUs = (uint64_t) (imuSimRow.timeMs * IMU_CSV_USEC_PER_MSEC);
+    }
+    else if((NULL != imuSimFile) && (0 <= (pos = ftell(imuSimFile))))
+    {
+        /* The pending sample is past, the rest of the trace follows */
+        while(0 != ImuCsvRead(imuSimFile, &row))
+        {
+            if(0 != ImuCsvIsMotion(&row, thresholdMg))
+            {
+                atUs = (uint64_t) (row.timeMs * IMU_CSV_USEC_PER_MSEC);
+                break;
+            }
+        }
+        (void) fseek(imuSimFile, pos, SEEK_SET);
+    }
+    else
+    {
+        /* No trace, or one that can't seek: the pod is never moved */
+    }
+    HostSetMotionAt(atUs);
+}
+#endif /* (STRIDE_SENSOR_ENABLED) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,51 @@
+/*******************************************************************************
+* File Name: imu_csv.h
+*
+* Version: 1.0
+*
+* Description:
+*  Reader of recorded accelerometer traces for the host build. One sample per
+*  line:
+*
+*   time_ms,ax_mg,ay_mg,az_mg[,label[,cadence_spm,stride_cm]]
+*
+*  Values may be integers or decimals. Empty lines, lines starting with '#'
+*  and a header line are skipped. The optional label names the activity
+*  (stand, walk, run) and the optional reference cadence and stride length
+*  are the ground truth the replay compares against.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "stride.h"
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+#define IMU_CSV_LABEL_SIZE          (16u)
+
+typedef struct
+{
+    double timeMs;
+    STRIDE_SAMPLE_T sample;
+    char label[IMU_CSV_LABEL_SIZE];
+    /* Zero when the trace has no reference */
+    double cadence;
+    double strideCm;
+} IMU_CSV_ROW_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+FILE * ImuCsvOpen(const char *path);
+int ImuCsvRead(FILE *file, IMU_CSV_ROW_T *row);
+
+
+/* [] END OF FILE */
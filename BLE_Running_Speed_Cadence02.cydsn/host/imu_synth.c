@@ -0,0 +1,146 @@
+/*******************************************************************************
+* File Name: imu_synth.c
+*
+* Version: 1.0
+*
+* Description:
+*  Writes a labelled synthetic foot pod trace in the imu_csv.h format, for the
+*  host checks when no recording is at hand. Every stride has a heel strike
+*  followed by the swing dip of the same foot, a weaker impact of the other
+*  foot half a stride later, and noise. The peak-to-peak acceleration follows
+*  the stride length through the Weinberg model the pipeline uses, within
+*  SYNTH_AMPLITUDE_SPREAD, and the stride period jitters by a few percent.
+*
+*  Usage: imu_synth [sample rate in Hz] [seed]
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SYNTH_DEFAULT_RATE_HZ       (128.0)
+#define SYNTH_GRAVITY_MG            (1000.0)
+#define SYNTH_NOISE_MG              (25.0)
+#define SYNTH_JITTER                (0.03)
+/* Impact strength varies from segment to segment, like a loosely laced pod */
+#define SYNTH_AMPLITUDE_SPREAD      (0.10)
+
+/* Matches STRIDE_LENGTH_K_Q8 / 256 */
+#define SYNTH_WEINBERG_K            (3379.0 / 256.0)
+
+/* Pulse shapes in seconds and as a share of the peak-to-peak value */
+#define SYNTH_STRIKE_TIME           (0.100)
+#define SYNTH_STRIKE_SHARE          (0.75)
+#define SYNTH_SWING_TIME            (0.300)
+#define SYNTH_SWING_SHARE           (0.25)
+#define SYNTH_OTHER_TIME            (0.080)
+#define SYNTH_OTHER_SHARE           (0.15)
+
+/* Sensor tilt: share of the vertical signal seen on the x and y axes */
+#define SYNTH_TILT_X                (0.20)
+#define SYNTH_TILT_Y                (0.10)
+
+typedef struct
+{
+    const char *label;
+    double seconds;
+    /* Steps per minute, two per stride */
+    double cadence;
+    double strideCm;
+} SYNTH_SEGMENT_T;
+
+static const SYNTH_SEGMENT_T synthSegments[] =
+{
+    { "stand",  5.0,   0.0,   0.0 },
+    { "walk",  60.0,  88.0,  75.0 },
+    { "run",   60.0, 140.0, 100.0 },
+    { "walk",  30.0,  95.0,  82.0 },
+    { "run",   30.0, 155.0, 112.0 },
+    { "walk",  20.0,  80.0,  66.0 },
+    { "stand",  5.0,   0.0,   0.0 },
+};
+
+static unsigned long synthSeed = 1u;
+
+
+/* Deterministic uniform [0, 1) */
+static double SynthRandom(void)
+{
+    synthSeed = (synthSeed * 1103515245u) + 12345u;
+    return((double) ((synthSeed >> 8u) & 0xFFFFu) / 65536.0);
+}
+
+/* Roughly Gaussian with unit deviation */
+static double SynthNoise(void)
+{
+    return((SynthRandom() + SynthRandom() + SynthRandom() + SynthRandom() - 2.0) * 1.73);
+}
+
+static double SynthHalfSine(double t, double width)
+{
+    return(((t >= 0.0) && (t < width)) ? sin(M_PI * t / width) : 0.0);
+}
+
+int main(int argc, char *argv[])
+{
+    double rate = (argc > 1) ? atof(argv[1]) : SYNTH_DEFAULT_RATE_HZ;
+    double t = 0.0;
+    double strideStart = 0.0;
+    double period = 0.0;
+    double phase;
+    double p2p;
+    double v;
+    double segmentEnd = 0.0;
+    unsigned int i;
+
+    if(argc > 2)
+    {
+        synthSeed = strtoul(argv[2], NULL, 0);
+    }
+
+    printf("time_ms,ax_mg,ay_mg,az_mg,label,cadence_spm,stride_cm\n");
+
+    for(i = 0u; i < (sizeof(synthSegments) / sizeof(synthSegments[0])); i++)
+    {
+        const SYNTH_SEGMENT_T *seg = &synthSegments[i];
+
+        segmentEnd += seg->seconds;
+        p2p = pow(seg->strideCm / SYNTH_WEINBERG_K, 4.0) *
+            (1.0 + (SYNTH_AMPLITUDE_SPREAD * (2.0 * SynthRandom() - 1.0)));
+        strideStart = t;
+        period = 0.0;
+
+        for(; t < segmentEnd; t += 1.0 / rate)
+        {
+            v = 0.0;
+            if(seg->cadence > 0.0)
+            {
+                if((0.0 == period) || ((t - strideStart) >= period))
+                {
+                    strideStart = (0.0 == period) ? t : (strideStart + period);
+                    period = (120.0 / seg->cadence) * (1.0 + (SYNTH_JITTER * (2.0 * SynthRandom() - 1.0)));
+                }
+                phase = t - strideStart;
+                v += SYNTH_STRIKE_SHARE * p2p * SynthHalfSine(phase, SYNTH_STRIKE_TIME);
+                v -= SYNTH_SWING_SHARE * p2p * SynthHalfSine(phase - SYNTH_STRIKE_TIME, SYNTH_SWING_TIME);
+                v += SYNTH_OTHER_SHARE * p2p * SynthHalfSine(phase - (period / 2.0), SYNTH_OTHER_TIME);
+            }
+
+            printf("%.3f,%.1f,%.1f,%.1f,%s,%.1f,%.1f\n", t * 1000.0,
+                (SYNTH_TILT_X * v) + (SYNTH_NOISE_MG * SynthNoise()),
+                (SYNTH_TILT_Y * v) + (SYNTH_NOISE_MG * SynthNoise()),
+                SYNTH_GRAVITY_MG + v + (SYNTH_NOISE_MG * SynthNoise()),
+                seg->label, seg->cadence, seg->strideCm);
+        }
+    }
+    return(0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,553 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Version 1.0
+*
+* Description:
+*  Host replacement for the PSoC Creator generated project.h. Declares just
+*  enough of the cy_boot, CYBLE, WDT, UART_DEB and pin APIs for the example
+*  project sources to compile and run as a normal Linux process. The
+*  implementations live in cyble_stub.c.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(CY_HOST_PROJECT_H)
+#define CY_HOST_PROJECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/***************************************
+*        cytypes.h
+***************************************/
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef volatile uint32 reg32;
+
+typedef void (*cyisraddress)(void);
+
+#define CY_SECTION(name)            __attribute__((section(name)))
+#define CY_ALIGN(align)             __attribute__((aligned(align)))
+
+#define CY_ISR(FuncName)            void FuncName(void)
+#define CY_ISR_PROTO(FuncName)      void FuncName(void)
+
+#define LO8(x)                      ((uint8) ((x) & 0xFFu))
+#define HI8(x)                      ((uint8) ((uint16)(x) >> 8))
+#define LO16(x)                     ((uint16) ((x) & 0xFFFFu))
+#define HI16(x)                     ((uint16) ((uint32)(x) >> 16))
+
+/* CMSIS data memory barrier. The host tests run the interrupt handler side
+* on a separate thread, so it has to be a real fence here.
+*/
+#define __DMB()                     __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define CyGlobalIntEnable           HostGlobalIntEnable()
+#define CyGlobalIntDisable          HostGlobalIntDisable()
+
+void HostGlobalIntEnable(void);
+void HostGlobalIntDisable(void);
+uint8 CyEnterCriticalSection(void);
+void  CyExitCriticalSection(uint8 savedIntrStatus);
+
+/* Virtual time of the simulation in microseconds */
+uint64_t HostGetTimeUs(void);
+
+/* Raises the Motion_Int pin interrupt at the virtual time, UINT64_MAX for
+* never. Called by the host accelerometer driver.
+*/
+void HostSetMotionAt(uint64_t us);
+
+
+/***************************************
+*        CyLib.h / CyLFClk.h
+***************************************/
+#define CY_SYS_WDT_MODE_NONE        (0u)
+#define CY_SYS_WDT_MODE_INT         (1u)
+#define CY_SYS_WDT_MODE_RESET       (2u)
+#define CY_SYS_WDT_MODE_INT_RESET   (3u)
+
+#define CY_SYS_WDT_COUNTER0         (0x00u)
+#define CY_SYS_WDT_COUNTER1         (0x01u)
+#define CY_SYS_WDT_COUNTER2         (0x02u)
+
+#define CY_SYS_WDT_COUNTER0_MASK    (0x01u)
+#define CY_SYS_WDT_COUNTER1_MASK    (0x100u)
+#define CY_SYS_WDT_COUNTER2_MASK    (0x10000u)
+
+#define CY_SYS_WDT_COUNTER0_INT     (0x04u)
+#define CY_SYS_WDT_COUNTER1_INT     (0x400u)
+#define CY_SYS_WDT_COUNTER2_INT     (0x40000u)
+
+void   CySysWdtUnlock(void);
+void   CySysWdtLock(void);
+void   CySysWdtWriteMode(uint32 counterNum, uint32 mode);
+void   CySysWdtWriteClearOnMatch(uint32 counterNum, uint32 enable);
+void   CySysWdtWriteMatch(uint32 counterNum, uint32 match);
+uint32 CySysWdtReadMatch(uint32 counterNum);
+uint32 CySysWdtGetCount(uint32 counterNum);
+void   CySysWdtResetCounters(uint32 countersMask);
+void   CySysWdtEnable(uint32 counterMask);
+uint32 CySysWdtGetInterruptSource(void);
+void   CySysWdtClearInterrupt(uint32 counterMask);
+
+/* SysTick of the CPU clock, CYDEV_BCLK__SYSCLK__HZ from cyfitter.h. The
+* host counts down with its monotonic clock.
+*/
+#define CYDEV_BCLK__SYSCLK__HZ      (48000000u)
+#define CY_SYS_SYST_RVR_CNT_MASK    (0x00FFFFFFu)
+#define CY_SYS_SYST_CVR_CNT_MASK    (0x00FFFFFFu)
+
+void   CySysTickStart(void);
+void   CySysTickDisableInterrupt(void);
+void   CySysTickSetReload(uint32 value);
+void   CySysTickClear(void);
+uint32 CySysTickGetValue(void);
+
+void   CySysPmSleep(void);
+void   CySysPmDeepSleep(void);
+void   CySysPmHibernate(void);
+
+
+/***************************************
+*        CyFlash.h
+***************************************/
+/* CY8C4247LQI-BL483: 128 KB in 128 byte rows */
+#define CY_FLASH_SIZEOF_ROW         (128u)
+#define CY_FLASH_NUMBER_ROWS        (1024u)
+#define CY_FLASH_SIZE               (CY_FLASH_NUMBER_ROWS * CY_FLASH_SIZEOF_ROW)
+
+#define CY_SYS_FLASH_SUCCESS        (0x00u)
+#define CY_SYS_FLASH_INVALID_ADDR   (0x04u)
+
+/* The flash array is an image in host memory, erased to zeros like on the
+* device.
+*/
+extern uint8 hostFlash[CY_FLASH_SIZE];
+#define CY_FLASH_BASE               ((uintptr_t) hostFlash)
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[]);
+
+
+/***************************************
+*        Pins and interrupts
+***************************************/
+void   Disconnect_LED_Write(uint8 value);
+void   Advertising_LED_Write(uint8 value);
+void   Running_LED_Write(uint8 value);
+
+void   SW2_ClearInterrupt(void);
+void   SW2_Interrupt_Start(void);
+void   SW2_Interrupt_StartEx(cyisraddress address);
+void   SW2_Interrupt_ClearPending(void);
+
+void   Motion_Int_ClearInterrupt(void);
+void   Motion_Interrupt_Start(void);
+void   Motion_Interrupt_StartEx(cyisraddress address);
+void   Motion_Interrupt_ClearPending(void);
+
+void   WDT_Interrupt_StartEx(cyisraddress address);
+
+
+/***************************************
+*        UART_DEB (SCB)
+***************************************/
+#define UART_DEB_GET_TX_FIFO_SR_VALID   (0u)
+
+void   UART_DEB_Start(void);
+void   UART_DEB_UartPutChar(uint32 txDataByte);
+void   UART_DEB_SpiUartPutArray(const uint8 wrBuf[], uint32 count);
+uint32 UART_DEB_SpiUartGetTxBufferSize(void);
+
+/* On the device printf() reaches UART_DEB through the retargeting in debug.c.
+* Route it the same way here so the debug output costs UART time in the
+* simulation.
+*/
+int    HostPrintf(const char *format, ...);
+#define printf                          HostPrintf
+
+
+/***************************************
+*        CYBLE
+***************************************/
+#define CYBLE_GAP_BD_ADDR_SIZE          (0x06u)
+
+#define CYBLE_ADVERTISING_FAST          (0x00u)
+#define CYBLE_ADVERTISING_SLOW          (0x01u)
+#define CYBLE_ADVERTISING_CUSTOM        (0x02u)
+
+typedef void (*CYBLE_CALLBACK_T)(uint32 eventCode, void *eventParam);
+
+typedef enum
+{
+    CYBLE_ERROR_OK = 0u,
+    CYBLE_ERROR_INVALID_PARAMETER,
+    CYBLE_ERROR_INVALID_OPERATION,
+    CYBLE_ERROR_MEMORY_ALLOCATION_FAILED,
+    CYBLE_ERROR_INSUFFICIENT_RESOURCES,
+    CYBLE_ERROR_OOB_NOT_AVAILABLE,
+    CYBLE_ERROR_NO_CONNECTION,
+    CYBLE_ERROR_NO_DEVICE_ENTITY,
+    CYBLE_ERROR_REPEATED_ATTEMPTS,
+    CYBLE_ERROR_GAP_ROLE,
+    CYBLE_ERROR_TX_POWER_READ,
+    CYBLE_ERROR_BT_ON_NOT_COMPLETED,
+    CYBLE_ERROR_SEC_FAILED,
+    CYBLE_ERROR_L2CAP_PSM_WRONG_ENCODING = 0x0Du,
+    CYBLE_ERROR_L2CAP_PSM_ALREADY_REGISTERED,
+    CYBLE_ERROR_L2CAP_PSM_NOT_REGISTERED,
+    CYBLE_ERROR_L2CAP_CONNECTION_ENTITY_NOT_FOUND,
+    CYBLE_ERROR_L2CAP_CHANNEL_NOT_FOUND,
+    CYBLE_ERROR_L2CAP_PSM_NOT_IN_RANGE,
+    CYBLE_ERROR_DEVICE_ALREADY_EXISTS = 0x27u,
+    CYBLE_ERROR_FLASH_WRITE_NOT_PERMITED = 0x28u,
+    CYBLE_ERROR_MIC_AUTH_FAILED = 0x29u,
+    CYBLE_ERROR_FLASH_WRITE = 0x2Au,
+    CYBLE_ERROR_NTF_DISABLED = 0xA0u,
+    CYBLE_ERROR_IND_DISABLED,
+    CYBLE_ERROR_CHAR_IS_NOT_DISCOVERED,
+    CYBLE_ERROR_INVALID_STATE
+} CYBLE_API_RESULT_T;
+
+typedef enum
+{
+    CYBLE_STATE_STOPPED,
+    CYBLE_STATE_INITIALIZING,
+    CYBLE_STATE_CONNECTED,
+    CYBLE_STATE_ADVERTISING,
+    CYBLE_STATE_SCANNING,
+    CYBLE_STATE_CONNECTING,
+    CYBLE_STATE_DISCONNECTED
+} CYBLE_STATE_T;
+
+typedef enum
+{
+    CYBLE_BLESS_ACTIVE = 0x01u,
+    CYBLE_BLESS_SLEEP,
+    CYBLE_BLESS_DEEPSLEEP,
+    CYBLE_BLESS_HIBERNATE,
+    CYBLE_BLESS_INVALID = 0xFFu
+} CYBLE_LP_MODE_T;
+
+typedef enum
+{
+    CYBLE_BLESS_STATE_ACTIVE = 0x01u,
+    CYBLE_BLESS_STATE_EVENT_CLOSE,
+    CYBLE_BLESS_STATE_SLEEP,
+    CYBLE_BLESS_STATE_ECO_ON,
+    CYBLE_BLESS_STATE_ECO_STABLE,
+    CYBLE_BLESS_STATE_DEEPSLEEP,
+    CYBLE_BLESS_STATE_HIBERNATE,
+    CYBLE_BLESS_STATE_INVALID = 0xFFu
+} CYBLE_BLESS_STATE_T;
+
+typedef enum
+{
+    CYBLE_LL_PWR_LVL_NEG_18_DBM = 0x01u,
+    CYBLE_LL_PWR_LVL_NEG_12_DBM,
+    CYBLE_LL_PWR_LVL_NEG_6_DBM,
+    CYBLE_LL_PWR_LVL_NEG_3_DBM,
+    CYBLE_LL_PWR_LVL_NEG_2_DBM,
+    CYBLE_LL_PWR_LVL_NEG_1_DBM,
+    CYBLE_LL_PWR_LVL_0_DBM,
+    CYBLE_LL_PWR_LVL_3_DBM,
+    CYBLE_LL_PWR_LVL_MAX
+} CYBLE_BLESS_PWR_LVL_T;
+
+typedef enum
+{
+    CYBLE_LL_ADV_CH_TYPE = 0x00u,
+    CYBLE_LL_CONN_CH_TYPE,
+    CYBLE_LL_MAX_CH_TYPE
+} CYBLE_BLESS_PHY_CH_GRP_ID_T;
+
+typedef struct
+{
+    CYBLE_BLESS_PWR_LVL_T blePwrLevelInDbm;
+    CYBLE_BLESS_PHY_CH_GRP_ID_T bleSsChId;
+} CYBLE_BLESS_PWR_IN_DB_T;
+
+typedef enum
+{
+    /* General events */
+    CYBLE_EVT_HOST_INVALID = 0x00u,
+    CYBLE_EVT_STACK_ON = 0x01u,
+    CYBLE_EVT_TIMEOUT,
+    CYBLE_EVT_HARDWARE_ERROR,
+    CYBLE_EVT_HCI_STATUS,
+    CYBLE_EVT_STACK_BUSY_STATUS,
+
+    /* GAP events */
+    CYBLE_EVT_GAP_AUTH_REQ = 0x20u,
+    CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST,
+    CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST,
+    CYBLE_EVT_GAP_AUTH_COMPLETE,
+    CYBLE_EVT_GAP_AUTH_FAILED,
+    CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP,
+    CYBLE_EVT_GAP_DEVICE_CONNECTED,
+    CYBLE_EVT_GAP_DEVICE_DISCONNECTED,
+    CYBLE_EVT_GAP_ENCRYPT_CHANGE,
+    CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE,
+    CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT,
+
+    /* L2CAP events */
+    CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_REQ = 0x60u,
+    CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP,
+
+    /* GATT events */
+    CYBLE_EVT_GATT_CONNECT_IND = 0x40u,
+    CYBLE_EVT_GATT_DISCONNECT_IND,
+    CYBLE_EVT_GATTS_XCNHG_MTU_REQ,
+    CYBLE_EVT_GATTS_WRITE_REQ,
+    CYBLE_EVT_GATTS_INDICATION_ENABLED,
+    CYBLE_EVT_GATTS_HANDLE_VALUE_CNF,
+
+    /* RSCS service events */
+    CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED = 0x1A00u,
+    CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED,
+    CYBLE_EVT_RSCSS_INDICATION_ENABLED,
+    CYBLE_EVT_RSCSS_INDICATION_DISABLED,
+    CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION,
+    CYBLE_EVT_RSCSS_CHAR_WRITE,
+    CYBLE_EVT_RSCSC_NOTIFICATION,
+    CYBLE_EVT_RSCSC_INDICATION,
+    CYBLE_EVT_RSCSC_READ_CHAR_RESPONSE,
+    CYBLE_EVT_RSCSC_WRITE_CHAR_RESPONSE,
+    CYBLE_EVT_RSCSC_READ_DESCR_RESPONSE,
+    CYBLE_EVT_RSCSC_WRITE_DESCR_RESPONSE
+} CYBLE_EVT_T;
+
+typedef struct
+{
+    uint8 bdHandle;
+    uint8 attId;
+} CYBLE_CONN_HANDLE_T;
+
+typedef struct
+{
+    uint8 bdAddr[CYBLE_GAP_BD_ADDR_SIZE];
+    uint8 type;
+} CYBLE_GAP_BD_ADDR_T;
+
+typedef struct
+{
+    uint8 security;
+    uint8 bonding;
+    uint8 ekeySize;
+    uint8 authErr;
+} CYBLE_GAP_AUTH_INFO_T;
+
+#define CYBLE_GAP_NO_BONDING                (0x00u)
+#define CYBLE_GAP_BONDING                   (0x01u)
+
+#define CYBLE_GAP_MAX_BONDED_DEVICE         (4u)
+
+typedef struct
+{
+    uint8 count;
+    CYBLE_GAP_BD_ADDR_T bdAddrList[CYBLE_GAP_MAX_BONDED_DEVICE];
+} CYBLE_GAP_BONDED_DEV_ADDR_LIST_T;
+
+typedef enum
+{
+    CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV = 0x00u,
+    CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV,
+    CYBLE_GAPP_SCANNABLE_UNDIRECTED_ADV,
+    CYBLE_GAPP_NON_CONNECTABLE_UNDIRECTED_ADV,
+    CYBLE_GAPP_CONNECTABLE_LOW_DC_DIRECTED_ADV
+} CYBLE_GAPP_ADV_T;
+
+typedef struct
+{
+    uint16 advIntvMin;
+    uint16 advIntvMax;
+    CYBLE_GAPP_ADV_T advType;
+    uint8 ownAddrType;
+    uint8 directAddrType;
+    uint8 directAddr[CYBLE_GAP_BD_ADDR_SIZE];
+    uint8 advChannelMap;
+    uint8 advFilterPolicy;
+} CYBLE_GAPP_DISC_PARAM_T;
+
+typedef struct
+{
+    uint8 discMode;
+    CYBLE_GAPP_DISC_PARAM_T *advParam;
+    uint16 advTo;
+} CYBLE_GAPP_DISC_MODE_INFO_T;
+
+typedef struct
+{
+    uint16 connIntvMin;
+    uint16 connIntvMax;
+    uint16 connLatency;
+    uint16 supervisionTO;
+} CYBLE_GAP_CONN_UPDATE_PARAM_T;
+
+typedef struct
+{
+    uint8 status;
+    uint16 connIntv;
+    uint16 connLatency;
+    uint16 supervisionTO;
+} CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T;
+
+#define CYBLE_L2CAP_CONN_PARAM_ACCEPTED     (0x0000u)
+#define CYBLE_L2CAP_CONN_PARAM_REJECTED     (0x0001u)
+
+typedef struct
+{
+    uint8  *val;
+    uint16 len;
+    uint16 actualLen;
+} CYBLE_GATT_VALUE_T;
+
+typedef uint16 CYBLE_GATT_DB_ATTR_HANDLE_T;
+
+typedef struct
+{
+    CYBLE_GATT_VALUE_T value;
+    CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle;
+} CYBLE_GATT_HANDLE_VALUE_PAIR_T;
+
+typedef CYBLE_GATT_HANDLE_VALUE_PAIR_T CYBLE_GATTS_HANDLE_VALUE_NTF_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValPair;
+} CYBLE_GATTS_WRITE_REQ_PARAM_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    uint16 mtu;
+} CYBLE_GATT_XCHG_MTU_PARAM_T;
+
+typedef enum
+{
+    CYBLE_GATT_ERR_NONE = 0x00u,
+    CYBLE_GATT_ERR_INVALID_HANDLE = 0x01u,
+    CYBLE_GATT_ERR_WRITE_NOT_PERMITTED = 0x03u,
+    CYBLE_GATT_ERR_REQUEST_NOT_SUPPORTED = 0x06u,
+    CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN = 0x0Du,
+    CYBLE_GATT_ERR_CCCD_IMPROPERLY_CONFIGURED = 0xFDu
+} CYBLE_GATT_ERR_CODE_T;
+
+typedef struct
+{
+    CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle;
+    uint8 opcode;
+    CYBLE_GATT_ERR_CODE_T errorCode;
+} CYBLE_GATTS_ERR_PARAM_T;
+
+#define CYBLE_GATT_WRITE_REQ                (0x12u)
+#define CYBLE_GATT_DB_LOCALLY_INITIATED     (0x00u)
+#define CYBLE_GATT_DB_PEER_INITIATED        (0x40u)
+
+#define CYBLE_STACK_STATE_FREE              (0x00u)
+#define CYBLE_STACK_STATE_BUSY              (0x01u)
+
+/* ATT MTU of a new connection and the Maximum MTU set in the component */
+#define CYBLE_GATT_DEFAULT_MTU              (23u)
+#define CYBLE_GATT_MTU                      (512u)
+
+extern uint8 cyBle_pendingFlashWrite;
+extern CYBLE_GAPP_DISC_MODE_INFO_T cyBle_discoveryModeInfo;
+
+void CyBle_Start(CYBLE_CALLBACK_T callbackFunc);
+void CyBle_ProcessEvents(void);
+CYBLE_STATE_T CyBle_GetState(void);
+CYBLE_LP_MODE_T CyBle_EnterLPM(CYBLE_LP_MODE_T pwrMode);
+CYBLE_BLESS_STATE_T CyBle_GetBleSsState(void);
+CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T *bdAddr);
+CYBLE_API_RESULT_T CyBle_SetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl);
+CYBLE_API_RESULT_T CyBle_GetTxPowerLevel(CYBLE_BLESS_PWR_IN_DB_T *bleSsPwrLvl);
+int8 CyBle_GetRssi(void);
+CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType);
+void CyBle_GappStopAdvertisement(void);
+CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr);
+CYBLE_API_RESULT_T CyBle_GapGetBondedDevicesList(CYBLE_GAP_BONDED_DEV_ADDR_LIST_T *bondedDevList);
+CYBLE_API_RESULT_T CyBle_StoreBondingData(uint8 isForceWrite);
+CYBLE_API_RESULT_T CyBle_SetSlaveLatencyMode(uint8 bdHandle, uint8 setForceQuickTransmit);
+CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+    CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam);
+uint8 CyBle_GattGetBusyStatus(void);
+CYBLE_GATT_ERR_CODE_T CyBle_GattsWriteAttributeValue(CYBLE_GATT_HANDLE_VALUE_PAIR_T *handleValuePair,
+    uint16 offset, CYBLE_CONN_HANDLE_T *connHandle, uint8 flags);
+CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle);
+CYBLE_API_RESULT_T CyBle_GattsErrorRsp(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_ERR_PARAM_T *errRspParam);
+CYBLE_API_RESULT_T CyBle_GattsNotification(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_HANDLE_VALUE_NTF_T *ntfParam);
+
+
+/***************************************
+*        CYBLE custom services
+***************************************/
+/* Attribute handles the customizer generates for the Session Transfer
+* service, see transfer.h
+*/
+#define CYBLE_SESSION_TRANSFER_SERVICE_HANDLE                                       (0x0020u)
+#define CYBLE_SESSION_TRANSFER_CONTROL_CHAR_HANDLE                                  (0x0022u)
+#define CYBLE_SESSION_TRANSFER_DATA_CHAR_HANDLE                                     (0x0024u)
+#define CYBLE_SESSION_TRANSFER_DATA_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE (0x0025u)
+
+/* Power Statistics service, see powerstats.h */
+#define CYBLE_POWER_STATISTICS_SERVICE_HANDLE                                       (0x0026u)
+#define CYBLE_POWER_STATISTICS_COUNTERS_CHAR_HANDLE                                 (0x0028u)
+
+
+/***************************************
+*        CYBLE RSCS
+***************************************/
+#define CYBLE_RSCS_SET_CUMMULATIVE_VALUE            (0x01u)
+#define CYBLE_RSCS_START_SENSOR_CALIBRATION         (0x02u)
+#define CYBLE_RSCS_UPDATE_SENSOR_LOCATION           (0x03u)
+#define CYBLE_RSCS_REQ_SUPPORTED_SENSOR_LOCATION    (0x04u)
+#define CYBLE_RSCS_RESPONSE_CODE                    (0x10u)
+
+#define CYBLE_RSCS_ERR_SUCCESS                      (0x01u)
+#define CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED        (0x02u)
+#define CYBLE_RSCS_ERR_INVALID_PARAMETER            (0x03u)
+#define CYBLE_RSCS_ERR_OPERATION_FAILED             (0x04u)
+
+typedef enum
+{
+    CYBLE_RSCS_RSC_MEASUREMENT,
+    CYBLE_RSCS_RSC_FEATURE,
+    CYBLE_RSCS_SENSOR_LOCATION,
+    CYBLE_RSCS_SC_CONTROL_POINT,
+    CYBLE_RSCS_CHAR_COUNT
+} CYBLE_RSCS_CHAR_INDEX_T;
+
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    CYBLE_RSCS_CHAR_INDEX_T charIndex;
+    CYBLE_GATT_VALUE_T *value;
+} CYBLE_RSCS_CHAR_VALUE_T;
+
+void CyBle_RscsRegisterAttrCallback(CYBLE_CALLBACK_T callbackFunc);
+CYBLE_API_RESULT_T CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_CHAR_INDEX_T charIndex,
+    uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_RscssGetCharacteristicValue(CYBLE_RSCS_CHAR_INDEX_T charIndex,
+    uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_RscssSendNotification(CYBLE_CONN_HANDLE_T connHandle,
+    CYBLE_RSCS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue);
+CYBLE_API_RESULT_T CyBle_RscssSendIndication(CYBLE_CONN_HANDLE_T connHandle,
+    CYBLE_RSCS_CHAR_INDEX_T charIndex, uint8 attrSize, uint8 *attrValue);
+
+#endif /* CY_HOST_PROJECT_H */
+
+
+/* [] END OF FILE */
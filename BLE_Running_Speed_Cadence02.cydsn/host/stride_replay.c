@@ -0,0 +1,321 @@
+/*******************************************************************************
+* File Name: stride_replay.c
+*
+* Version: 1.0
+*
+* Description:
+*  Replays a recorded accelerometer trace (see imu_csv.h) through the stride
+*  detection pipeline of stride.c sample by sample and reports the detected
+*  strides. When the trace carries reference cadence and stride length, the
+*  errors are summarised per label and checked against the given limits.
+*
+*  Strides labelled "walk" or "run" also benchmark the walking/running
+*  classifier: the share of strides with the right profile, the number of
+*  profile changes against the number of label changes, and how many strides
+*  it takes to follow a label change.
+*
+*  Usage: stride_replay [-v] [-c max cadence error] [-s max stride error]
+*                       [-n max stride count error %] [-a min accuracy %]
+*                       trace.csv
+*
+*  The trace is assumed to be sampled at STRIDE_SAMPLE_RATE_HZ.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "rscs.h"
+#include "imu_csv.h"
+#include "classify.h"
+
+#define REPLAY_MAX_LABELS           (8u)
+#define REPLAY_RATE_TOLERANCE       (0.05)
+#define REPLAY_NO_GAIT              (0xFFu)
+
+typedef struct
+{
+    char label[IMU_CSV_LABEL_SIZE];
+    unsigned long strides;
+    unsigned long referenced;
+    double expectedStrides;
+    double cadenceErr;
+    double strideErr;
+    unsigned long classified;
+    unsigned long correct;
+} REPLAY_STATS_T;
+
+extern uint16 currSpeed;
+
+static REPLAY_STATS_T replayStats[REPLAY_MAX_LABELS];
+static unsigned int replayLabels;
+
+/* Classifier benchmark */
+static uint8 replayGait = REPLAY_NO_GAIT;
+static uint8 replayProfile;
+static unsigned long replayLabelChanges;
+static unsigned long replayProfileChanges;
+static unsigned long replayFollowing;
+static unsigned long replayLatencySum;
+static unsigned long replayLatencyMax;
+static int replayPending;
+
+
+static REPLAY_STATS_T * ReplayStatsFor(const char *label)
+{
+    unsigned int i;
+
+    for(i = 0u; i < replayLabels; i++)
+    {
+        if(0 == strcmp(replayStats[i].label, label))
+        {
+            return(&replayStats[i]);
+        }
+    }
+    if(replayLabels < REPLAY_MAX_LABELS)
+    {
+        snprintf(replayStats[replayLabels].label, IMU_CSV_LABEL_SIZE, "%s", label);
+        return(&replayStats[replayLabels++]);
+    }
+    return(&replayStats[REPLAY_MAX_LABELS - 1u]);
+}
+
+/* The profile the label asks for, REPLAY_NO_GAIT for other labels */
+static uint8 ReplayGaitOf(const char *label)
+{
+    if(0 == strcmp(label, "walk"))
+    {
+        return(WALKING);
+    }
+    if(0 == strcmp(label, "run"))
+    {
+        return(RUNNING);
+    }
+    return(REPLAY_NO_GAIT);
+}
+
+static void ReplayClassified(REPLAY_STATS_T *stats, const char *label)
+{
+    uint8 gait = ReplayGaitOf(label);
+
+    if(profile != replayProfile)
+    {
+        replayProfile = profile;
+        replayProfileChanges++;
+    }
+    if(REPLAY_NO_GAIT == gait)
+    {
+        return;
+    }
+
+    if((REPLAY_NO_GAIT != replayGait) && (gait != replayGait))
+    {
+        replayLabelChanges++;
+        replayPending = 1;
+        replayFollowing = 0u;
+    }
+    replayGait = gait;
+
+    stats->classified++;
+    if(profile == gait)
+    {
+        stats->correct++;
+    }
+
+    if(0 != replayPending)
+    {
+        replayFollowing++;
+        if(profile == gait)
+        {
+            replayPending = 0;
+            replayLatencySum += replayFollowing;
+            if(replayFollowing > replayLatencyMax)
+            {
+                replayLatencyMax = replayFollowing;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *file;
+    IMU_CSV_ROW_T row;
+    REPLAY_STATS_T *stats;
+    REPLAY_STATS_T total;
+    double maxCadenceErr = 0.0;
+    double maxStrideErr = 0.0;
+    double maxCountErr = 0.0;
+    double minAccuracy = 0.0;
+    double accuracy;
+    double firstMs = 0.0;
+    double lastMs = 0.0;
+    double rate;
+    double cadenceErr;
+    double strideErr;
+    double countErr;
+    unsigned long samples = 0u;
+    unsigned int i;
+    int verbose = 0;
+    int failed = 0;
+    int opt = 1;
+
+    while((opt < argc) && ('-' == argv[opt][0]) && ('\0' != argv[opt][1]))
+    {
+        if(0 == strcmp(argv[opt], "-v"))
+        {
+            verbose = 1;
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-c")))
+        {
+            maxCadenceErr = atof(argv[++opt]);
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-s")))
+        {
+            maxStrideErr = atof(argv[++opt]);
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-n")))
+        {
+            maxCountErr = atof(argv[++opt]);
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-a")))
+        {
+            minAccuracy = atof(argv[++opt]);
+        }
+        else
+        {
+            break;
+        }
+        opt++;
+    }
+    if(opt >= argc)
+    {
+        fprintf(stderr, "usage: %s [-v] [-c cadence] [-s stride] [-n count %%] [-a accuracy %%] trace.csv\n", argv[0]);
+        return(2);
+    }
+    file = ImuCsvOpen(argv[opt]);
+    if(NULL == file)
+    {
+        return(2);
+    }
+
+    InitProfile();
+    StrideInit();
+    replayProfile = profile;
+
+    while(0 != ImuCsvRead(file, &row))
+    {
+        if(0u == samples)
+        {
+            firstMs = row.timeMs;
+        }
+        lastMs = row.timeMs;
+        samples++;
+
+        stats = ReplayStatsFor(row.label);
+        stats->expectedStrides += (row.cadence / 120.0) / STRIDE_SAMPLE_RATE_HZ;
+
+        if(YES == StrideProcessSample(&row.sample))
+        {
+            stats->strides++;
+            if(row.cadence > 0.0)
+            {
+                stats->referenced++;
+                stats->cadenceErr += fabs(strideInfo.cadence - row.cadence);
+                stats->strideErr += fabs(strideInfo.strideCm - row.strideCm);
+            }
+            ReplayClassified(stats, row.label);
+            if(0 != verbose)
+            {
+                printf("%10.3f s  cadence %3u  stride %3u cm  peak %5u mg  p2p %5u mg  "
+                       "speed %2u.%02u m/s  distance %lu dm  score %5d %s  [%s]\n",
+                       row.timeMs / 1000.0, strideInfo.cadence, strideInfo.strideCm,
+                       strideInfo.peak, strideInfo.peakToPeak,
+                       currSpeed >> 8u, ((currSpeed & 0xFFu) * 100u) >> 8u,
+                       (unsigned long) rscMeasurement.totalDistance, classifyScore,
+                       (WALKING == profile) ? "walk" : "run ", row.label);
+            }
+        }
+    }
+    if(stdin != file)
+    {
+        fclose(file);
+    }
+
+    if(samples > 1u)
+    {
+        rate = (samples - 1u) * 1000.0 / (lastMs - firstMs);
+        if(fabs(rate - STRIDE_SAMPLE_RATE_HZ) > (REPLAY_RATE_TOLERANCE * STRIDE_SAMPLE_RATE_HZ))
+        {
+            printf("warning: trace is sampled at %.1f Hz, the pipeline expects %u Hz\n",
+                rate, STRIDE_SAMPLE_RATE_HZ);
+        }
+    }
+
+    memset(&total, 0, sizeof(total));
+    printf("%-8s %8s %10s %12s %12s\n", "label", "strides", "expected", "cadence err", "stride err");
+    for(i = 0u; i < replayLabels; i++)
+    {
+        stats = &replayStats[i];
+        total.strides += stats->strides;
+        total.referenced += stats->referenced;
+        total.expectedStrides += stats->expectedStrides;
+        total.cadenceErr += stats->cadenceErr;
+        total.strideErr += stats->strideErr;
+        total.classified += stats->classified;
+        total.correct += stats->correct;
+
+        cadenceErr = (0u != stats->referenced) ? (stats->cadenceErr / stats->referenced) : 0.0;
+        strideErr = (0u != stats->referenced) ? (stats->strideErr / stats->referenced) : 0.0;
+        printf("%-8s %8lu %10.1f %8.2f spm %9.2f cm\n", (0 != stats->label[0]) ? stats->label : "-",
+            stats->strides, stats->expectedStrides, cadenceErr, strideErr);
+
+        if((stats->expectedStrides > 0.0) && (maxCountErr > 0.0))
+        {
+            countErr = 100.0 * fabs(stats->strides - stats->expectedStrides) / stats->expectedStrides;
+            if(countErr > maxCountErr)
+            {
+                printf("FAIL: %s stride count is off by %.1f %%\n", stats->label, countErr);
+                failed = 1;
+            }
+        }
+        if((maxCadenceErr > 0.0) && (cadenceErr > maxCadenceErr))
+        {
+            printf("FAIL: %s cadence error %.2f spm\n", stats->label, cadenceErr);
+            failed = 1;
+        }
+        if((maxStrideErr > 0.0) && (strideErr > maxStrideErr))
+        {
+            printf("FAIL: %s stride length error %.2f cm\n", stats->label, strideErr);
+            failed = 1;
+        }
+    }
+    printf("%lu samples, %lu strides (%.1f expected), total distance %lu dm\n",
+        samples, total.strides, total.expectedStrides, (unsigned long) rscMeasurement.totalDistance);
+
+    if(0u != total.classified)
+    {
+        accuracy = (100.0 * total.correct) / total.classified;
+        printf("classifier: %.1f %% of %lu strides right, %lu profile changes for %lu label changes, "
+               "follows in %.1f strides (max %lu)\n",
+               accuracy, total.classified, replayProfileChanges, replayLabelChanges,
+               (0u != replayLabelChanges) ? ((double) replayLatencySum / replayLabelChanges) : 0.0,
+               replayLatencyMax);
+        if((minAccuracy > 0.0) && ((accuracy < minAccuracy) || (0 != replayPending)))
+        {
+            printf("FAIL: classifier accuracy %.1f %%\n", accuracy);
+            failed = 1;
+        }
+    }
+
+    return(failed);
+}
+
+
+/* [] END OF FILE */
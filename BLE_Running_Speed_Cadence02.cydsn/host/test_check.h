@@ -0,0 +1,37 @@
+/*******************************************************************************
+* File Name: test_check.h
+*
+* Version: 1.0
+*
+* Description:
+*  Checks shared by the host tests. A failed CHECK() prints the condition and
+*  counts it; main() ends with return(TEST_RESULT("test_name")), which prints
+*  PASS or FAIL and gives the exit code. Include it in one test file only.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+
+
+/***************************************
+*        Macros
+***************************************/
+#define CHECK(cond) \
+    do { if(!(cond)) { printf("%s:%d: check failed: %s\r\n", __FILE__, __LINE__, #cond); failures++; } } while(0)
+
+#define TEST_RESULT(name) \
+    (printf("%s: %s\r\n", (name), (0 == failures) ? "PASS" : "FAIL"), (0 == failures) ? 0 : 1)
+
+
+/***************************************
+*        Global Variables
+***************************************/
+static int failures;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,169 @@
+/*******************************************************************************
+* File Name: test_evtqueue.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host checks for the event queue in evtqueue.c. After the single threaded
+*  checks of the empty, full and index wrap cases, a producer thread standing
+*  in for the interrupt handler and a consumer thread standing in for the
+*  main loop pass TEST_STRESS_EVENTS numbered events through the queue. Every
+*  event must arrive exactly once, in order and intact.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include "common.h"
+#include "evtqueue.h"
+#include "test_check.h"
+
+/* More than the 24 bits of sequence number an event carries would alias */
+#define TEST_STRESS_EVENTS          (1000000u)
+#define TEST_WRAP_EVENTS            (1000u)
+
+static unsigned long stressFull;
+static unsigned long stressEmpty;
+static unsigned long stressErrors;
+
+
+/* Sequence number in arg and value, a check byte over both in type */
+static uint8 TestCheckByte(uint8 arg, uint16 value)
+{
+    return((uint8) ~(arg + LO8(value) + HI8(value)));
+}
+
+static void TestPutSeq(uint32 seq)
+{
+    uint8 arg = (uint8) (seq >> 16u);
+    uint16 value = LO16(seq);
+
+    while(NO == EvtQueuePut(TestCheckByte(arg, value), arg, value))
+    {
+        stressFull++;
+        sched_yield();
+    }
+}
+
+static void TestEmptyAndFull(void)
+{
+    EVTQ_EVENT_T event;
+    uint8 i;
+
+    EvtQueueInit();
+    CHECK(NO == EvtQueueGet(&event));
+
+    for(i = 0u; i < EVTQ_SIZE; i++)
+    {
+        CHECK(YES == EvtQueuePut(EVTQ_EVT_BUTTON, i, (uint16) (i * 1000u)));
+    }
+    CHECK(NO == EvtQueuePut(EVTQ_EVT_BUTTON, 0u, 0u));
+    CHECK(1u == EvtQueueGetDropped());
+
+    for(i = 0u; i < EVTQ_SIZE; i++)
+    {
+        CHECK(YES == EvtQueueGet(&event));
+        CHECK(EVTQ_EVT_BUTTON == event.type);
+        CHECK(i == event.arg);
+        CHECK((uint16) (i * 1000u) == event.value);
+    }
+    CHECK(NO == EvtQueueGet(&event));
+}
+
+static void TestIndexWrap(void)
+{
+    EVTQ_EVENT_T event;
+    uint16 i;
+
+    /* Keep the queue partly filled while the uint8 indices wrap several times */
+    EvtQueueInit();
+    for(i = 0u; i < (EVTQ_SIZE / 2u); i++)
+    {
+        CHECK(YES == EvtQueuePut(EVTQ_EVT_BUTTON, 0u, i));
+    }
+    for(i = 0u; i < TEST_WRAP_EVENTS; i++)
+    {
+        CHECK(YES == EvtQueuePut(EVTQ_EVT_BUTTON, 0u, (uint16) (i + (EVTQ_SIZE / 2u))));
+        CHECK(YES == EvtQueueGet(&event));
+        CHECK(i == event.value);
+    }
+    CHECK(0u == EvtQueueGetDropped());
+}
+
+static void * TestProducer(void *unused)
+{
+    uint32 seq;
+
+    (void) unused;
+    for(seq = 0u; seq < TEST_STRESS_EVENTS; seq++)
+    {
+        TestPutSeq(seq);
+    }
+    return(NULL);
+}
+
+static void * TestConsumer(void *unused)
+{
+    EVTQ_EVENT_T event;
+    uint32 expected = 0u;
+    uint32 seq;
+
+    (void) unused;
+    while(expected < TEST_STRESS_EVENTS)
+    {
+        if(NO == EvtQueueGet(&event))
+        {
+            stressEmpty++;
+            sched_yield();
+            continue;
+        }
+        seq = ((uint32) event.arg << 16u) | event.value;
+        if((seq != (expected & 0xFFFFFFu)) || (event.type != TestCheckByte(event.arg, event.value)))
+        {
+            if(stressErrors++ < 10u)
+            {
+                printf("event %lu: got seq %lu type %02x\r\n", (unsigned long) expected,
+                    (unsigned long) seq, event.type);
+            }
+        }
+        expected++;
+    }
+    return(NULL);
+}
+
+static void TestTwoThreads(void)
+{
+    pthread_t producer;
+    pthread_t consumer;
+
+    EvtQueueInit();
+    CHECK(0 == pthread_create(&consumer, NULL, &TestConsumer, NULL));
+    CHECK(0 == pthread_create(&producer, NULL, &TestProducer, NULL));
+    CHECK(0 == pthread_join(producer, NULL));
+    CHECK(0 == pthread_join(consumer, NULL));
+
+    CHECK(0u == stressErrors);
+    /* Every full queue the producer ran into was counted as a drop */
+    CHECK((uint16) stressFull == EvtQueueGetDropped());
+
+    printf("test_evtqueue: %u events, producer found the queue full %lu times, "
+           "consumer found it empty %lu times\r\n",
+           TEST_STRESS_EVENTS, stressFull, stressEmpty);
+}
+
+int main(void)
+{
+    TestEmptyAndFull();
+    TestIndexWrap();
+    TestTwoThreads();
+
+    return(TEST_RESULT("test_evtqueue"));
+}
+
+
+/* [] END OF FILE */
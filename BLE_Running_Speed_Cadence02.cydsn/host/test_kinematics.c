@@ -0,0 +1,225 @@
+/*******************************************************************************
+* File Name: test_kinematics.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host checks for the fixed-point calculations in kinematics.c. Speed, pace
+*  and distance are compared with a double-precision reference over every
+*  cadence and stride length the WALKING and RUNNING profiles produce, and
+*  the speed over the whole 8-bit cadence range. The division and square root
+*  helpers are checked against the C operators.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <math.h>
+#include "common.h"
+#include "rscs.h"
+#include "kinematics.h"
+#include "test_check.h"
+
+/* Rounded to nearest, so half an LSB plus the reciprocal error */
+#define TEST_SPEED_TOLERANCE        (0.55)
+#define TEST_PACE_TOLERANCE         (0.5)
+#define TEST_DISTANCE_STRIDES       (100000u)
+#define TEST_STRIDE_RANGE_MAX       (257u)
+#define TEST_DIVIDEND_STEP          (7u)
+#define TEST_DIVISOR_STEP           (13u)
+#define TEST_SQRT_EXHAUSTIVE        (1000000u)
+
+static double maxSpeedError;
+static double maxPaceError;
+
+
+/* m/s * 256: two steps per stride, cadence in steps/min, stride in cm */
+static double RefSpeed(unsigned int cadence, unsigned int strideCm)
+{
+    return((2.0 * cadence * (strideCm / 100.0) / 60.0) * 256.0);
+}
+
+static double RefPace(unsigned int speed)
+{
+    return(1000.0 / (speed / 256.0));
+}
+
+static void CheckSpeedAndPace(unsigned int cadence, unsigned int strideCm)
+{
+    uint16 speed = KinSpeed((uint8) cadence, (uint16) strideCm);
+    uint16 pace = KinPace(speed);
+    double speedErr = fabs(speed - RefSpeed(cadence, strideCm));
+    double paceErr;
+
+    CHECK(speedErr <= TEST_SPEED_TOLERANCE);
+    if(speedErr > maxSpeedError)
+    {
+        maxSpeedError = speedErr;
+    }
+
+    /* Pace is checked against the speed that was actually reported */
+    if(0u == speed)
+    {
+        CHECK(KIN_PACE_MAX == pace);
+    }
+    else if(RefPace(speed) < KIN_PACE_MAX)
+    {
+        paceErr = fabs(pace - RefPace(speed));
+        CHECK(paceErr <= TEST_PACE_TOLERANCE);
+        if(paceErr > maxPaceError)
+        {
+            maxPaceError = paceErr;
+        }
+    }
+    else
+    {
+        CHECK(KIN_PACE_MAX == pace);
+    }
+}
+
+static void TestProfileRanges(void)
+{
+    unsigned int cadence;
+    unsigned int stride;
+
+    /* UpdatePace() lets both values run one past their MAX before wrapping */
+    for(cadence = WALKING_INST_CADENCE_MIN; cadence <= (WALKING_INST_CADENCE_MAX + 1u); cadence++)
+    {
+        for(stride = WALKING_INST_STRIDE_LENGTH_MIN; stride <= (WALKING_INST_STRIDE_LENGTH_MAX + 1u); stride++)
+        {
+            CheckSpeedAndPace(cadence, stride);
+        }
+    }
+    for(cadence = RUNNING_INST_CADENCE_MIN; cadence <= (RUNNING_INST_CADENCE_MAX + 1u); cadence++)
+    {
+        for(stride = RUNNING_INST_STRIDE_LENGTH_MIN; stride <= (RUNNING_INST_STRIDE_LENGTH_MAX + 1u); stride++)
+        {
+            CheckSpeedAndPace(cadence, stride);
+        }
+    }
+
+    /* The case the old 16-bit product wrapped: 2 * 155 * 115 = 35650 */
+    CHECK(1521u == KinSpeed(155u, 115u));
+}
+
+static void TestFullCadenceRange(void)
+{
+    unsigned int cadence;
+    unsigned int stride;
+
+    /* Products up to KIN_CADENCE_STRIDE_MAX are exact, larger ones clamp */
+    for(cadence = 0u; cadence <= UINT8_MAX; cadence++)
+    {
+        for(stride = 0u; stride <= TEST_STRIDE_RANGE_MAX; stride++)
+        {
+            CheckSpeedAndPace(cadence, stride);
+        }
+    }
+    CHECK(KinSpeed(UINT8_MAX, UINT16_MAX) == KinSpeed(UINT8_MAX, TEST_STRIDE_RANGE_MAX));
+}
+
+static void TestPaceAllSpeeds(void)
+{
+    uint32 speed;
+    double err;
+
+    for(speed = 1u; speed <= UINT16_MAX; speed++)
+    {
+        if(RefPace(speed) < KIN_PACE_MAX)
+        {
+            err = fabs(KinPace((uint16) speed) - RefPace(speed));
+            CHECK(err <= TEST_PACE_TOLERANCE);
+            if(err > maxPaceError)
+            {
+                maxPaceError = err;
+            }
+        }
+        else
+        {
+            CHECK(KIN_PACE_MAX == KinPace((uint16) speed));
+        }
+    }
+    CHECK(KIN_PACE_MAX == KinPace(0u));
+}
+
+static void TestDivide(void)
+{
+    uint32 dividend;
+    uint32 divisor;
+    uint32 mismatches = 0u;
+
+    /* Rounded to nearest, halves up */
+    for(dividend = 0u; dividend <= UINT16_MAX; dividend += TEST_DIVIDEND_STEP)
+    {
+        for(divisor = 1u; divisor <= UINT16_MAX; divisor += TEST_DIVISOR_STEP)
+        {
+            if(KinDivide((uint16) dividend, (uint16) divisor) != (((2u * dividend) + divisor) / (2u * divisor)))
+            {
+                mismatches++;
+            }
+        }
+    }
+    CHECK(0u == mismatches);
+    CHECK(65535u == KinDivide(UINT16_MAX, 1u));
+    CHECK(0u == KinDivide(100u, 0u));
+}
+
+static void TestSqrt(void)
+{
+    uint32 value;
+    uint32 root;
+
+    for(value = 0u; value < TEST_SQRT_EXHAUSTIVE; value++)
+    {
+        root = KinSqrt(value);
+        CHECK(((root * root) <= value) && (((root + 1u) * (root + 1u)) > value));
+    }
+    CHECK(65535u == KinSqrt(UINT32_MAX));
+    CHECK(46340u == KinSqrt(2147483647u));
+}
+
+static void TestDistance(void)
+{
+    uint32 i;
+    uint32 distanceDm = 0u;
+    uint8 remainderCm = 0u;
+    double refCm = 0.0;
+    uint16 stride = WALKING_INST_STRIDE_LENGTH_MIN;
+
+    for(i = 0u; i < TEST_DISTANCE_STRIDES; i++)
+    {
+        KinAddDistance(&distanceDm, &remainderCm, stride);
+        refCm += stride;
+
+        stride = (stride < RUNNING_INST_STRIDE_LENGTH_MAX) ? (stride + 1u) : WALKING_INST_STRIDE_LENGTH_MIN;
+    }
+    CHECK(distanceDm == (uint32) floor(refCm / 10.0));
+    CHECK(remainderCm == (uint8) fmod(refCm, 10.0));
+
+    /* The carry plus the largest stride stays in the exact range of the divide */
+    distanceDm = 0u;
+    remainderCm = 9u;
+    KinAddDistance(&distanceDm, &remainderCm, UINT16_MAX);
+    CHECK(6554u == distanceDm);
+    CHECK(4u == remainderCm);
+}
+
+int main(void)
+{
+    TestProfileRanges();
+    TestFullCadenceRange();
+    TestPaceAllSpeeds();
+    TestDivide();
+    TestSqrt();
+    TestDistance();
+
+    printf("test_kinematics: max speed error %.3f LSB, max pace error %.3f s/km\r\n",
+        maxSpeedError, maxPaceError);
+    return(TEST_RESULT("test_kinematics"));
+}
+
+
+/* [] END OF FILE */
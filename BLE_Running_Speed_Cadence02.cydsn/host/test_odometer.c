@@ -0,0 +1,163 @@
+/*******************************************************************************
+* File Name: test_odometer.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host checks for the flash odometer in odometer.c, run against the flash
+*  image of the stub layer. A TEST_RUN_DM run checks the write batching, the
+*  row rotation and the stall time budget. Restarts check the recovery of the
+*  newest record, also after a row write that was cut short.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "odometer.h"
+#include "test_check.h"
+
+/* 10 km in strides of 1.37 m */
+#define TEST_RUN_DM                 (100000u)
+#define TEST_STRIDE_DM              (137u)
+#define TEST_HIBERNATE_DM           (123456u)
+
+
+static const ODOMETER_RECORD_T * TestRecord(uint8 row)
+{
+    return((const ODOMETER_RECORD_T *) &hostFlash[(ODOMETER_FIRST_ROW + row) * CY_FLASH_SIZEOF_ROW]);
+}
+
+/* Row of the record with the highest sequence number */
+static uint8 TestNewestRow(void)
+{
+    uint8 row;
+    uint8 newest = 0u;
+
+    for(row = 1u; row < ODOMETER_ROWS; row++)
+    {
+        if(TestRecord(row)->sequence > TestRecord(newest)->sequence)
+        {
+            newest = row;
+        }
+    }
+    return(newest);
+}
+
+static void TestBlankFlash(void)
+{
+    memset(hostFlash, 0, sizeof(hostFlash));
+    CHECK(0u == OdometerInit());
+
+    /* Nothing to save before the first ODOMETER_SAVE_DISTANCE_DM */
+    OdometerProcess(ODOMETER_SAVE_DISTANCE_DM - 1u);
+    CHECK(0u == odometerWrites);
+}
+
+static void TestRun(void)
+{
+    uint32 distance;
+    uint32 sequence;
+    uint8 row;
+    uint8 newest;
+
+    for(distance = 0u; distance <= TEST_RUN_DM; distance += TEST_STRIDE_DM)
+    {
+        OdometerProcess(distance);
+    }
+
+    /* One write per ODOMETER_SAVE_DISTANCE_DM at most, the stride overshoots */
+    CHECK(odometerWrites <= (TEST_RUN_DM / ODOMETER_SAVE_DISTANCE_DM));
+    CHECK(odometerWrites >= (TEST_RUN_DM / (ODOMETER_SAVE_DISTANCE_DM + TEST_STRIDE_DM)));
+    CHECK(0u == odometerWriteErrors);
+
+    /* Every row holds one of the last ODOMETER_ROWS records */
+    newest = TestNewestRow();
+    sequence = TestRecord(newest)->sequence;
+    CHECK(sequence == odometerWrites);
+    for(row = 0u; row < ODOMETER_ROWS; row++)
+    {
+        CHECK(ODOMETER_MAGIC == TestRecord(row)->magic);
+        CHECK(TestRecord((newest + ODOMETER_ROWS - row) % ODOMETER_ROWS)->sequence == (sequence - row));
+    }
+
+    /* Stall time within the budget */
+    CHECK(odometerWriteTicksMax <= SWTIMER_MS_TO_TICKS(ODOMETER_WRITE_BUDGET_MS));
+    CHECK(odometerWriteTicksTotal <= (odometerWrites * SWTIMER_MS_TO_TICKS(ODOMETER_WRITE_BUDGET_MS)));
+
+    /* The restart finds the last saved distance */
+    CHECK(OdometerInit() == TestRecord(newest)->totalDistance);
+    CHECK((TEST_RUN_DM - OdometerInit()) < ODOMETER_SAVE_DISTANCE_DM);
+
+    printf("test_odometer: %u writes for %lu m, %lu ms stall at most\r\n", odometerWrites,
+        (unsigned long) (TEST_RUN_DM / 10u),
+        (unsigned long) ((odometerWriteTicksMax * 1000u) / SWTIMER_TICKS_PER_SEC));
+}
+
+static void TestHibernate(void)
+{
+    uint16 writes;
+
+    OdometerSave(TEST_HIBERNATE_DM);
+    CHECK(TEST_HIBERNATE_DM == OdometerInit());
+
+    /* A distance that is saved already isn't written again */
+    writes = odometerWrites;
+    OdometerSave(TEST_HIBERNATE_DM);
+    CHECK(writes == odometerWrites);
+}
+
+static void TestGoingBack(void)
+{
+    uint16 writes = odometerWrites;
+
+    /* The Client resets the cumulative value */
+    OdometerProcess(0u);
+    CHECK((writes + 1u) == odometerWrites);
+    CHECK(0u == OdometerInit());
+}
+
+static void TestTornWrite(void)
+{
+    uint8 newest;
+    uint8 *data;
+
+    OdometerSave(TEST_HIBERNATE_DM);
+    OdometerSave(TEST_HIBERNATE_DM + ODOMETER_SAVE_DISTANCE_DM);
+    newest = TestNewestRow();
+
+    /* The reset hit the newest row half way through programming */
+    data = &hostFlash[(ODOMETER_FIRST_ROW + newest) * CY_FLASH_SIZEOF_ROW];
+    memset(&data[sizeof(uint32)], 0, sizeof(ODOMETER_RECORD_T) - sizeof(uint32));
+    CHECK(TEST_HIBERNATE_DM == OdometerInit());
+
+    /* The next record reuses the broken row */
+    OdometerSave(TEST_HIBERNATE_DM + 1u);
+    CHECK(newest == TestNewestRow());
+    CHECK((TEST_HIBERNATE_DM + 1u) == OdometerInit());
+
+    /* An erased row is skipped too */
+    memset(data, 0, CY_FLASH_SIZEOF_ROW);
+    CHECK(TEST_HIBERNATE_DM == OdometerInit());
+}
+
+int main(void)
+{
+    SwTimerInit();
+
+    TestBlankFlash();
+    TestRun();
+    TestHibernate();
+    TestGoingBack();
+    TestTornWrite();
+
+    return(TEST_RESULT("test_odometer"));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+* File Name: test_rscs.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host checks for the RSC Measurement encoding in rscs.c. Every combination
+*  of the measurement flags is packed and compared with the field layout of
+*  the Running Speed and Cadence Service specification.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "rscs.h"
+#include "test_check.h"
+
+#define TEST_FLAGS_COMBINATIONS     (8u)
+#define TEST_SPEED                  (0x0A0Bu)
+#define TEST_CADENCE                (0x0Cu)
+#define TEST_STRIDE                 (0x0D0Eu)
+#define TEST_DISTANCE               (0x11223344u)
+
+extern uint16 currSpeed;
+
+
+/* Builds the expected value field by field as laid out in the specification */
+static uint8 SpecLayout(uint8 flags, uint8 *buff)
+{
+    uint8 size = 0u;
+
+    buff[size++] = flags;
+    buff[size++] = LO8(TEST_SPEED);
+    buff[size++] = HI8(TEST_SPEED);
+    buff[size++] = TEST_CADENCE;
+    if(0u != (flags & 0x01u))
+    {
+        buff[size++] = LO8(TEST_STRIDE);
+        buff[size++] = HI8(TEST_STRIDE);
+    }
+    if(0u != (flags & 0x02u))
+    {
+        buff[size++] = 0x44u;
+        buff[size++] = 0x33u;
+        buff[size++] = 0x22u;
+        buff[size++] = 0x11u;
+    }
+    return(size);
+}
+
+static void TestEncodeAllFlags(void)
+{
+    uint8 flags;
+    uint8 size;
+    uint8 expectedSize;
+    uint8 buff[RSC_RSC_MEASUREMENT_CHAR_SIZE + 1u];
+    uint8 expected[RSC_RSC_MEASUREMENT_CHAR_SIZE];
+
+    for(flags = 0u; flags < TEST_FLAGS_COMBINATIONS; flags++)
+    {
+        rscMeasurement.flags = flags;
+        rscMeasurement.instCadence = TEST_CADENCE;
+        rscMeasurement.instStridelen = TEST_STRIDE;
+        rscMeasurement.totalDistance = TEST_DISTANCE;
+        currSpeed = TEST_SPEED;
+
+        memset(buff, 0xA5, sizeof(buff));
+        size = EncodeRscMeasurement(buff);
+        expectedSize = SpecLayout(flags, expected);
+
+        CHECK(size == expectedSize);
+        CHECK(size == RSC_CHAR_SIZE(flags));
+        CHECK((size == 4u) || (size == 6u) || (size == 8u) || (size == 10u));
+        CHECK(0 == memcmp(buff, expected, expectedSize));
+        /* Nothing written past the announced fields */
+        CHECK(0xA5u == buff[size]);
+    }
+}
+
+static void TestInitProfileMasksFlags(void)
+{
+    uint16 feature;
+    uint8 flags = RSC_CHAR_FEATURE_FLAGS_MASK;
+    uint8 featureBuff[RSC_RSC_FEATURE_SIZE];
+
+    CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_RSC_MEASUREMENT, RSC_CHAR_FLAGS_SIZE, &flags);
+
+    for(feature = 0u; feature < TEST_FLAGS_COMBINATIONS; feature++)
+    {
+        featureBuff[0u] = LO8(feature);
+        featureBuff[1u] = HI8(feature);
+        CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_RSC_FEATURE, RSC_RSC_FEATURE_SIZE, featureBuff);
+
+        InitProfile();
+
+        CHECK(rscMeasurement.flags == (uint8) feature);
+        CHECK(RSC_CHAR_SIZE(rscMeasurement.flags) == (RSC_CHAR_MANDATORY_SIZE +
+            (((feature & 0x01u) != 0u) ? 2u : 0u) + (((feature & 0x02u) != 0u) ? 4u : 0u)));
+    }
+}
+
+static void TestDistanceCarry(void)
+{
+    uint16 i;
+
+    InitProfile();
+    rscMeasurement.instStridelen = 73u;
+
+    /* 1000 strides of 73 cm are exactly 7300 dm */
+    for(i = 0u; i < 1000u; i++)
+    {
+        SimulateProfile();
+    }
+    CHECK(7300u == rscMeasurement.totalDistance);
+}
+
+int main(void)
+{
+    TestEncodeAllFlags();
+    TestInitProfileMasksFlags();
+    TestDistanceCarry();
+
+    return(TEST_RESULT("test_rscs"));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,268 @@
+/*******************************************************************************
+* File Name: test_workout.c
+*
+* Version: 1.0
+*
+* Description:
+*  Host checks for the workout recorder in workout.c: the record codec round
+*  trip over steady and extreme strides, malformed records, and the page ring
+*  in the flash image of the stub layer across restarts, a wrap of the ring
+*  and a page write that was cut short.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "odometer.h"
+#include "workout.h"
+#include "test_check.h"
+
+#define TEST_STRIDES                (1000u)
+#define TEST_PERIOD                 (110u)
+#define TEST_CADENCE                (140u)
+#define TEST_STRIDE_CM              (105u)
+
+static unsigned long testSeed = 1u;
+
+
+static uint32 TestRandom(void)
+{
+    testSeed = (testSeed * 1103515245u) + 12345u;
+    return((uint32) (testSeed >> 8u) & 0xFFFFu);
+}
+
+/* A stride TEST_PERIOD samples after the previous one with a little jitter,
+* the first one starts the workout
+*/
+static void TestNextStride(WORKOUT_STRIDE_T *stride, uint32 i)
+{
+    stride->time = (i * TEST_PERIOD) + ((0u != i) ? (TestRandom() % 3u) : 0u);
+    stride->cadence = (uint8) (TEST_CADENCE + (TestRandom() % 2u));
+    stride->strideCm = (uint16) (TEST_STRIDE_CM + (TestRandom() % 4u));
+}
+
+static void TestRoundTrip(const WORKOUT_STRIDE_T *strides, uint32 count)
+{
+    WORKOUT_CODEC_T encoder;
+    WORKOUT_CODEC_T decoder;
+    WORKOUT_STRIDE_T decoded;
+    uint8 buff[WORKOUT_RECORD_MAX_SIZE + 1u];
+    uint8 size;
+    uint32 i;
+
+    WorkoutCodecReset(&encoder, strides[0u].time);
+    WorkoutCodecReset(&decoder, strides[0u].time);
+    for(i = 0u; i < count; i++)
+    {
+        memset(buff, 0xEE, sizeof(buff));
+        size = WorkoutEncodeRecord(&encoder, &strides[i], buff);
+        CHECK((size >= 1u) && (size <= WORKOUT_RECORD_MAX_SIZE));
+        CHECK(0xEEu == buff[WORKOUT_RECORD_MAX_SIZE]);
+        CHECK(size == WorkoutDecodeRecord(&decoder, buff, size, &decoded));
+        CHECK(decoded.time == strides[i].time);
+        CHECK(decoded.cadence == strides[i].cadence);
+        CHECK(decoded.strideCm == strides[i].strideCm);
+    }
+}
+
+static void TestCodec(void)
+{
+    static const WORKOUT_STRIDE_T extremes[] =
+    {
+        { 0u,           0u,   0u     },
+        { 0u,           255u, 65535u },
+        { 1u,           0u,   0u     },
+        { 0x7FFFFFFFu,  255u, 65535u },
+        { 0xFFFFFFFFu,  1u,   1u     },
+    };
+    WORKOUT_STRIDE_T strides[TEST_STRIDES];
+    WORKOUT_CODEC_T codec;
+    uint8 buff[WORKOUT_RECORD_MAX_SIZE];
+    uint32 i;
+
+    TestRoundTrip(extremes, sizeof(extremes) / sizeof(extremes[0u]));
+
+    for(i = 0u; i < TEST_STRIDES; i++)
+    {
+        TestNextStride(&strides[i], i);
+    }
+    TestRoundTrip(strides, TEST_STRIDES);
+
+    /* A stride at the period of its cadence takes the compact byte */
+    WorkoutCodecReset(&codec, 0u);
+    codec.cadence = TEST_CADENCE;
+    codec.strideCm = TEST_STRIDE_CM;
+    strides[0u].time = TEST_PERIOD;
+    strides[0u].cadence = TEST_CADENCE;
+    strides[0u].strideCm = TEST_STRIDE_CM;
+    CHECK(1u == WorkoutEncodeRecord(&codec, &strides[0u], buff));
+    CHECK(WORKOUT_COMPACT_FLAG == buff[0u]);
+
+    /* Malformed records */
+    WorkoutCodecReset(&codec, 0u);
+    buff[0u] = WORKOUT_TAG_MASK + 1u;
+    CHECK(0u == WorkoutDecodeRecord(&codec, buff, 1u, &strides[0u]));
+    buff[0u] = WORKOUT_TAG_PERIOD;
+    buff[1u] = 0x80u;
+    CHECK(0u == WorkoutDecodeRecord(&codec, buff, 2u, &strides[0u]));
+    buff[0u] = WORKOUT_MEDIUM_FLAG;
+    CHECK(0u == WorkoutDecodeRecord(&codec, buff, 1u, &strides[0u]));
+    CHECK(0u == WorkoutDecodeRecord(&codec, buff, 0u, &strides[0u]));
+}
+
+/* Decodes the pages from the row on and checks them against the strides */
+static uint32 TestReadPages(uint16 row, uint16 pages)
+{
+    const WORKOUT_PAGE_T *page;
+    WORKOUT_CODEC_T codec;
+    WORKOUT_STRIDE_T stride;
+    WORKOUT_STRIDE_T expected;
+    uint32 strides = 0u;
+    uint8 pos;
+    uint8 size;
+
+    testSeed = 1u;
+
+    while(0u != pages--)
+    {
+        page = WORKOUT_PAGE(row);
+        CHECK(YES == WorkoutPageIsValid(page));
+        WorkoutCodecReset(&codec, page->header.time);
+        pos = 0u;
+        while(pos < page->header.length)
+        {
+            size = WorkoutDecodeRecord(&codec, &page->payload[pos], page->header.length - pos, &stride);
+            CHECK(0u != size);
+            pos += size;
+
+            TestNextStride(&expected, strides++);
+            CHECK(stride.time == expected.time);
+            CHECK(stride.cadence == expected.cadence);
+            CHECK(stride.strideCm == expected.strideCm);
+        }
+        CHECK(pos == page->header.length);
+        row = (row + 1u) % WORKOUT_ROWS;
+    }
+    return(strides);
+}
+
+static void TestRecord(uint32 count)
+{
+    WORKOUT_STRIDE_T stride;
+    uint32 i;
+
+    testSeed = 1u;
+    for(i = 0u; i < count; i++)
+    {
+        TestNextStride(&stride, i);
+        WorkoutRecordStride(stride.time, stride.cadence, stride.strideCm);
+    }
+}
+
+static void TestRecorder(void)
+{
+    uint16 pages;
+
+    memset(hostFlash, 0, sizeof(hostFlash));
+    WorkoutInit();
+    CHECK(0u == workoutId);
+
+    /* Nothing is recorded before the recording is armed */
+    TestRecord(TEST_STRIDES);
+    CHECK(NO == WorkoutIsActive());
+
+    WorkoutArm(YES);
+    TestRecord(TEST_STRIDES);
+    CHECK(YES == WorkoutIsActive());
+    CHECK(1u == workoutId);
+    CHECK(TEST_STRIDES == workoutStrides);
+
+    /* Disarming stores the last page */
+    pages = workoutPages;
+    WorkoutArm(NO);
+    WorkoutProcess();
+    CHECK(NO == WorkoutIsActive());
+    CHECK((pages + 1u) == workoutPages);
+    CHECK(0u == workoutWriteErrors);
+    CHECK(workoutBytes <= (workoutPages * CY_FLASH_SIZEOF_ROW));
+    CHECK(TEST_STRIDES == TestReadPages(0u, workoutPages));
+
+    printf("test_workout: %lu strides in %u pages, %lu.%02lu bytes per stride\r\n",
+        (unsigned long) workoutStrides, workoutPages, (unsigned long) (workoutBytes / workoutStrides),
+        (unsigned long) (((workoutBytes % workoutStrides) * 100u) / workoutStrides));
+
+    /* The restart carries on after the newest page */
+    WorkoutInit();
+    CHECK(1u == workoutId);
+    WorkoutArm(YES);
+    TestRecord(1u);
+    WorkoutStop();
+    CHECK(2u == workoutId);
+    CHECK(WORKOUT_PAGE(pages + 1u)->header.workout == 2u);
+    CHECK(1u == TestReadPages(pages + 1u, 1u));
+}
+
+static void TestWrap(void)
+{
+    WORKOUT_STRIDE_T stride;
+    uint32 strides;
+    uint16 row;
+    uint16 newest;
+    uint8 length;
+    uint8 *data;
+
+    /* Record until the ring wrapped and the workout overwrote its own start */
+    memset(hostFlash, 0, sizeof(hostFlash));
+    WorkoutInit();
+    WorkoutArm(YES);
+    strides = 0u;
+    testSeed = 1u;
+    while(workoutPages < (WORKOUT_ROWS + (WORKOUT_ROWS / 2u)))
+    {
+        TestNextStride(&stride, strides++);
+        WorkoutRecordStride(stride.time, stride.cadence, stride.strideCm);
+    }
+    WorkoutStop();
+    newest = (uint16) ((workoutPages - 1u) % WORKOUT_ROWS);
+
+    WorkoutInit();
+    CHECK(1u == workoutId);
+    for(row = 0u; row < WORKOUT_ROWS; row++)
+    {
+        CHECK(YES == WorkoutPageIsValid(WORKOUT_PAGE(row)));
+    }
+    CHECK(WORKOUT_PAGE(newest)->header.sequence == (uint16) (workoutPages - 1u));
+
+    /* The reset hit the newest page half way through programming */
+    data = &hostFlash[(WORKOUT_FIRST_ROW + newest) * CY_FLASH_SIZEOF_ROW];
+    length = WORKOUT_PAGE(newest)->header.length;
+    memset(&data[sizeof(WORKOUT_PAGE_HEADER_T) + (length / 2u)], 0, length - (length / 2u));
+    CHECK(NO == WorkoutPageIsValid(WORKOUT_PAGE(newest)));
+    WorkoutInit();
+    WorkoutArm(YES);
+    TestRecord(1u);
+    WorkoutStop();
+    CHECK(2u == workoutId);
+    CHECK(YES == WorkoutPageIsValid(WORKOUT_PAGE(newest)));
+    CHECK(2u == WORKOUT_PAGE(newest)->header.workout);
+}
+
+int main(void)
+{
+    SwTimerInit();
+
+    TestCodec();
+    TestRecorder();
+    TestWrap();
+
+    return(TEST_RESULT("test_workout"));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,273 @@
+/*******************************************************************************
+* File Name: workout_bench.c
+*
+* Version: 1.0
+*
+* Description:
+*  Records an accelerometer trace (see imu_csv.h) through the stride pipeline
+*  of stride.c into the workout pages of workout.c, decodes the pages back
+*  from the flash image and compares every record with the stride the
+*  pipeline reported. The trace is replayed over and over until the workout
+*  reaches the given distance, a marathon by default, which must fit the
+*  WORKOUT_ROWS pages. With -l only the samples of that label are replayed,
+*  e.g. the running ones for a marathon race.
+*
+*  The report gives the flash bytes per stride, page headers included,
+*  against WORKOUT_RAW_STRIDE_SIZE bytes for a plain time, cadence and stride
+*  length record, and the share of strides that took the compact byte. With
+*  -o the flash image is saved for the simulator (RSC_SIM_FLASH_FILE), e.g.
+*  to time the session transfer of the workout.
+*
+*  Usage: workout_bench [-v] [-d distance in m] [-l label] [-o flash.bin] trace.csv
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "common.h"
+#include "rscs.h"
+#include "odometer.h"
+#include "workout.h"
+#include "imu_csv.h"
+
+/* uint32 time, uint8 cadence and uint16 stride length */
+#define WORKOUT_RAW_STRIDE_SIZE     (7u)
+#define BENCH_MARATHON_M            (42195u)
+#define BENCH_MAX_STRIDES           (200000u)
+#define BENCH_CM_PER_M              (100u)
+
+typedef struct
+{
+    uint32 interval;
+    uint8 cadence;
+    uint16 strideCm;
+} BENCH_STRIDE_T;
+
+static STRIDE_SAMPLE_T *benchSamples;
+static unsigned long benchSampleCount;
+static BENCH_STRIDE_T benchStrides[BENCH_MAX_STRIDES];
+static unsigned long benchStrideCount;
+
+
+/* Loads the trace so it can be replayed more than once, only the samples
+* of the label unless it is NULL
+*/
+static int BenchLoad(const char *name, const char *label)
+{
+    FILE *file = ImuCsvOpen(name);
+    IMU_CSV_ROW_T row;
+    unsigned long size = 0u;
+
+    if(NULL == file)
+    {
+        return(0);
+    }
+    while(0 != ImuCsvRead(file, &row))
+    {
+        if((NULL != label) && (0 != strcmp(row.label, label)))
+        {
+            continue;
+        }
+        if(benchSampleCount == size)
+        {
+            size = (0u != size) ? (2u * size) : 4096u;
+            benchSamples = realloc(benchSamples, size * sizeof(STRIDE_SAMPLE_T));
+            if(NULL == benchSamples)
+            {
+                return(0);
+            }
+        }
+        benchSamples[benchSampleCount++] = row.sample;
+    }
+    if(stdin != file)
+    {
+        fclose(file);
+    }
+    return(0u != benchSampleCount);
+}
+
+/* Decodes the workout pages from row 0 on and checks them, returns the
+* number of compact records or -1 on a mismatch
+*/
+static long BenchVerify(int verbose)
+{
+    const WORKOUT_PAGE_T *page;
+    WORKOUT_CODEC_T codec;
+    WORKOUT_STRIDE_T stride;
+    const BENCH_STRIDE_T *expected;
+    uint32 previous = 0u;
+    unsigned long strides = 0u;
+    long compact = 0;
+    uint16 row;
+    uint8 pos;
+    uint8 size;
+
+    for(row = 0u; row < workoutPages; row++)
+    {
+        page = WORKOUT_PAGE(row);
+        if((NO == WorkoutPageIsValid(page)) || (workoutId != page->header.workout))
+        {
+            printf("FAIL: page %u is not valid\n", row);
+            return(-1);
+        }
+        WorkoutCodecReset(&codec, page->header.time);
+        pos = 0u;
+        while(pos < page->header.length)
+        {
+            if(0u != (page->payload[pos] & WORKOUT_COMPACT_FLAG))
+            {
+                compact++;
+            }
+            size = WorkoutDecodeRecord(&codec, &page->payload[pos], page->header.length - pos, &stride);
+            expected = &benchStrides[strides];
+
+            /* The interval after a stop leaves the standing time out */
+            if((0u == size) || (strides >= benchStrideCount) ||
+               ((0u != strides) && ((stride.time - previous) < expected->interval)) ||
+               (stride.cadence != expected->cadence) || (stride.strideCm != expected->strideCm))
+            {
+                printf("FAIL: stride %lu on page %u doesn't match\n", strides, row);
+                return(-1);
+            }
+            if(0 != verbose)
+            {
+                printf("%10.3f s  cadence %3u  stride %3u cm  %s\n",
+                    (double) stride.time / STRIDE_SAMPLE_RATE_HZ, stride.cadence, stride.strideCm,
+                    (0u != (page->payload[pos] & WORKOUT_COMPACT_FLAG)) ? "compact" : "long");
+            }
+            previous = stride.time;
+            pos += size;
+            strides++;
+        }
+    }
+    if(strides != benchStrideCount)
+    {
+        printf("FAIL: %lu strides decoded, %lu recorded\n", strides, benchStrideCount);
+        return(-1);
+    }
+    return(compact);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *label = NULL;
+    const char *output = NULL;
+    FILE *file;
+    unsigned long distanceM = BENCH_MARATHON_M;
+    unsigned long distanceCm = 0u;
+    unsigned long passes = 0u;
+    unsigned long i;
+    double perStride;
+    long compact;
+    int verbose = 0;
+    int opt = 1;
+
+    while((opt < argc) && ('-' == argv[opt][0]) && ('\0' != argv[opt][1]))
+    {
+        if(0 == strcmp(argv[opt], "-v"))
+        {
+            verbose = 1;
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-d")))
+        {
+            distanceM = strtoul(argv[++opt], NULL, 0);
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-l")))
+        {
+            label = argv[++opt];
+        }
+        else if(((opt + 1) < argc) && (0 == strcmp(argv[opt], "-o")))
+        {
+            output = argv[++opt];
+        }
+        else
+        {
+            break;
+        }
+        opt++;
+    }
+    if(opt >= argc)
+    {
+        fprintf(stderr, "usage: %s [-v] [-d distance in m] [-l label] [-o flash.bin] trace.csv\n",
+            argv[0]);
+        return(2);
+    }
+    if(0 == BenchLoad(argv[opt], label))
+    {
+        return(2);
+    }
+
+    memset(hostFlash, 0, sizeof(hostFlash));
+    InitProfile();
+    StrideInit();
+    WorkoutInit();
+    WorkoutArm(YES);
+
+    while(distanceCm < (distanceM * BENCH_CM_PER_M))
+    {
+        for(i = 0u; i < benchSampleCount; i++)
+        {
+            if(YES == StrideProcessSample(&benchSamples[i]))
+            {
+                if(benchStrideCount >= BENCH_MAX_STRIDES)
+                {
+                    printf("FAIL: more than %u strides\n", BENCH_MAX_STRIDES);
+                    return(1);
+                }
+                benchStrides[benchStrideCount].interval = strideInfo.interval;
+                benchStrides[benchStrideCount].cadence = strideInfo.cadence;
+                benchStrides[benchStrideCount].strideCm = strideInfo.strideCm;
+                benchStrideCount++;
+                distanceCm += strideInfo.strideCm;
+            }
+        }
+        passes++;
+        if(0u == benchStrideCount)
+        {
+            printf("FAIL: no strides in the trace\n");
+            return(1);
+        }
+    }
+    WorkoutStop();
+
+    perStride = (double) workoutBytes / workoutStrides;
+    printf("workout: %lu strides, %.2f km in %lu passes of the trace, %lu bytes in %u of %u pages\n",
+        (unsigned long) workoutStrides, distanceCm / 100000.0, passes, (unsigned long) workoutBytes,
+        workoutPages, WORKOUT_ROWS);
+    printf("workout: %.2f bytes per stride, %.1f x smaller than %u byte records, "
+           "%.0f km fit the flash\n", perStride, WORKOUT_RAW_STRIDE_SIZE / perStride, WORKOUT_RAW_STRIDE_SIZE,
+        (((double) WORKOUT_ROWS * distanceCm) / workoutPages) / 100000.0);
+
+    if(workoutPages > WORKOUT_ROWS)
+    {
+        printf("FAIL: the workout wrapped the %u pages\n", WORKOUT_ROWS);
+        return(1);
+    }
+    compact = BenchVerify(verbose);
+    if(compact < 0)
+    {
+        return(1);
+    }
+    printf("workout: %.1f %% compact records, all %lu strides decoded\n",
+        (100.0 * compact) / benchStrideCount, benchStrideCount);
+
+    if(NULL != output)
+    {
+        file = fopen(output, "wb");
+        if((NULL == file) || (sizeof(hostFlash) != fwrite(hostFlash, 1u, sizeof(hostFlash), file)))
+        {
+            printf("FAIL: can't write %s\n", output);
+            return(1);
+        }
+        fclose(file);
+    }
+    return(0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,277 @@
+/*******************************************************************************
+* File Name: kinematics.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the fixed-point speed, distance and pace calculations
+*  used by the Running Speed and Cadence profile, and the integer helpers
+*  they share with the stride detection. No function divides at run time.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "kinematics.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+
+/* 2^31 / d at the middle of each of the 32 intervals of the normalised speed */
+static const uint16 kinRecipSeed[KIN_RECIP_SEED_COUNT] =
+{
+    64528u, 62602u, 60787u, 59075u, 57456u, 55924u, 54471u, 53092u,
+    51782u, 50534u, 49345u, 48210u, 47127u, 46091u, 45100u, 44151u,
+    43240u, 42367u, 41528u, 40721u, 39946u, 39199u, 38480u, 37787u,
+    37118u, 36472u, 35849u, 35246u, 34664u, 34100u, 33554u, 33026u
+};
+
+
+/*******************************************************************************
+* Function Name: KinSpeed
+********************************************************************************
+*
+* Summary:
+*  Calculates the instantaneous speed from the cadence and the stride length.
+*  The product is formed in 32 bits, so running cadences and strides no longer
+*  wrap before the scaling.
+*
+* Parameters:
+*  cadence: Instantaneous cadence in steps per minute.
+*  strideCm: Instantaneous stride length in centimetres.
+*
+* Return:
+*  Speed in m/s with resolution of 1/256, rounded to nearest.
+*
+*******************************************************************************/
+uint16 KinSpeed(uint8 cadence, uint16 strideCm)
+{
+    uint32 product = (uint32) cadence * strideCm;
+
+    if(product > KIN_CADENCE_STRIDE_MAX)
+    {
+        product = KIN_CADENCE_STRIDE_MAX;
+    }
+
+    return((uint16) (((product * KIN_SPEED_MUL) + (1u << (KIN_SPEED_SHIFT - 1u))) >> KIN_SPEED_SHIFT));
+}
+
+
+/*******************************************************************************
+* Function Name: KinAddDistance
+********************************************************************************
+*
+* Summary:
+*  Adds one stride to the total distance. The centimetres that don't make up a
+*  whole decimetre are carried over to the next stride, so no distance is lost
+*  to rounding.
+*
+* Parameters:
+*  distanceDm: Total distance in decimetres, updated in place.
+*  remainderCm: Centimetre carry below one decimetre, updated in place.
+*  strideCm: Stride length in centimetres.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void KinAddDistance(uint32 * distanceDm, uint8 * remainderCm, uint16 strideCm)
+{
+    uint32 cm = (uint32) *remainderCm + strideCm;
+    uint32 dm = KIN_DIV_BY_10(cm);
+
+    *distanceDm += dm;
+    *remainderCm = (uint8) (cm - (dm * KIN_CM_TO_DM_VALUE));
+}
+
+
+/*******************************************************************************
+* Function Name: KinReciprocal
+********************************************************************************
+*
+* Summary:
+*  Calculates the reciprocal of a divisor without dividing. The divisor is
+*  normalised to [2^15, 2^16), a table seed of its reciprocal is refined with
+*  KIN_RECIP_ITERATIONS Newton-Raphson steps r' = r + r * (1 - d * r).
+*
+* Parameters:
+*  divisor: Non-zero divisor.
+*  shift: Returns the normalisation shift, 1 / divisor = recip * 2^(shift - 31).
+*
+* Return:
+*  2^31 / (divisor << shift), good to a few parts per million.
+*
+*******************************************************************************/
+static uint32 KinReciprocal(uint16 divisor, uint8 * shift)
+{
+    uint32 norm = divisor;
+    uint32 recip;
+    int32 err;
+    uint8 i;
+
+    *shift = 0u;
+    while(norm < KIN_RECIP_NORM_MIN)
+    {
+        norm <<= 1u;
+        (*shift)++;
+    }
+
+    recip = kinRecipSeed[(norm >> KIN_RECIP_SEED_SHIFT) & KIN_RECIP_SEED_MASK];
+    for(i = 0u; i < KIN_RECIP_ITERATIONS; i++)
+    {
+        /* Both factors are at most 2^16, so the product fits 32 bits */
+        err = (int32) (KIN_RECIP_ONE - (norm * recip));
+        recip = (uint32) ((int32) recip + (((int32) recip * (err >> KIN_RECIP_ERR_SHIFT)) >> KIN_RECIP_CORR_SHIFT));
+    }
+
+    return((recip < KIN_RECIP_MAX) ? recip : KIN_RECIP_MAX);
+}
+
+
+/*******************************************************************************
+* Function Name: KinRoundQuotient
+********************************************************************************
+*
+* Summary:
+*  Settles a quotient estimate that is off by a few units with the remainder
+*  of the division and rounds it to nearest.
+*
+* Parameters:
+*  quotient: Estimate of dividend / divisor.
+*  dividend: Dividend, so that (dividend + 2 * divisor) fits 32 bits.
+*  divisor: Non-zero divisor.
+*
+* Return:
+*  dividend / divisor rounded to nearest.
+*
+*******************************************************************************/
+static uint32 KinRoundQuotient(uint32 quotient, uint32 dividend, uint16 divisor)
+{
+    while((quotient * divisor) > dividend)
+    {
+        quotient--;
+    }
+    while(((quotient + 1u) * divisor) <= dividend)
+    {
+        quotient++;
+    }
+    if((2u * (dividend - (quotient * divisor))) >= divisor)
+    {
+        quotient++;
+    }
+    return(quotient);
+}
+
+
+/*******************************************************************************
+* Function Name: KinPace
+********************************************************************************
+*
+* Summary:
+*  Calculates the pace from the speed through the reciprocal of the speed.
+*
+* Parameters:
+*  speed: Speed in m/s with resolution of 1/256.
+*
+* Return:
+*  Pace in seconds per kilometre, KIN_PACE_MAX if the speed is too low.
+*
+*******************************************************************************/
+uint16 KinPace(uint16 speed)
+{
+    uint32 recip;
+    uint32 pace;
+    uint8 shift;
+
+    if(0u == speed)
+    {
+        return(KIN_PACE_MAX);
+    }
+
+    recip = KinReciprocal(speed, &shift);
+
+    /* The shift is at most 15, so at least 8 fraction bits are dropped */
+    pace = KinRoundQuotient((KIN_METERS_PER_KM * recip) >> (KIN_PACE_SHIFT - shift), KIN_PACE_NUMERATOR, speed);
+
+    return((pace < KIN_PACE_MAX) ? (uint16) pace : KIN_PACE_MAX);
+}
+
+
+/*******************************************************************************
+* Function Name: KinDivide
+********************************************************************************
+*
+* Summary:
+*  Divides two 16-bit values through the reciprocal of the divisor.
+*
+* Parameters:
+*  dividend: Dividend.
+*  divisor: Divisor.
+*
+* Return:
+*  dividend / divisor rounded to nearest, 0 if the divisor is 0.
+*
+*******************************************************************************/
+uint16 KinDivide(uint16 dividend, uint16 divisor)
+{
+    uint32 recip;
+    uint8 shift;
+
+    if(0u == divisor)
+    {
+        return(0u);
+    }
+
+    recip = KinReciprocal(divisor, &shift);
+
+    return((uint16) KinRoundQuotient(((uint32) dividend * recip) >> (KIN_RECIP_FRAC_BITS - shift),
+                                     dividend, divisor));
+}
+
+
+/*******************************************************************************
+* Function Name: KinSqrt
+********************************************************************************
+*
+* Summary:
+*  Calculates the integer square root bit by bit.
+*
+* Parameters:
+*  value: Radicand.
+*
+* Return:
+*  The square root rounded down.
+*
+*******************************************************************************/
+uint16 KinSqrt(uint32 value)
+{
+    uint32 root = 0u;
+    uint32 bit = KIN_SQRT_TOP_BIT;
+
+    while(bit > value)
+    {
+        bit >>= 2u;
+    }
+    while(0u != bit)
+    {
+        if(value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1u) + bit;
+        }
+        else
+        {
+            root >>= 1u;
+        }
+        bit >>= 2u;
+    }
+    return((uint16) root);
+}
+
+
+/* [] END OF FILE */
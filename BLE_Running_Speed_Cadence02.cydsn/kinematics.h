@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: kinematics.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the fixed-point speed,
+*  distance and pace calculations. The Cortex-M0 has no hardware divider, so
+*  every division by a constant is a multiply by a precomputed reciprocal and
+*  a shift, and the pace reciprocal is refined with Newton-Raphson steps.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Conversion constants */
+#define KIN_CM_TO_METER_VALUE               (100u)
+#define KIN_CM_TO_DM_VALUE                  (10u)
+#define KIN_MIN_TO_SEC_VALUE                (60u)
+#define KIN_METERS_PER_KM                   (1000u)
+
+/* Speed is reported in m/s with resolution of 1/256 (Q8.8) */
+#define KIN_SPEED_FRAC_BITS                 (8u)
+
+/* One stride per two steps, so the speed in 1/256 m/s is
+*  cadence * stride[cm] * 2 * 256 / (60 * 100) = cadence * stride * 32 / 375.
+* KIN_SPEED_MUL is round(2^19 * 32 / 375): the result is within 0.03 LSB of the
+* exact value for every product up to KIN_CADENCE_STRIDE_MAX and the product
+* with the multiplier still fits 32 bits.
+*/
+#define KIN_SPEED_MUL                       (44739u)
+#define KIN_SPEED_SHIFT                     (19u)
+
+/* Larger cadence * stride products (above 21.8 m/s) are clamped */
+#define KIN_CADENCE_STRIDE_MAX              (0xFFFFu)
+
+/* Centimetres to whole decimetres for KinAddDistance(), the Cortex-M0 has no
+* divide instruction. round(2^19 / 10) gives the exact quotient below 81920, and
+* the carry of at most 9 cm plus a 16-bit stride stays below 65545.
+*/
+#define KIN_DIV_BY_10_MUL                   (52429u)
+#define KIN_DIV_BY_10_SHIFT                 (19u)
+#define KIN_DIV_BY_10(x)                    ((uint32)(((uint32)(x) * KIN_DIV_BY_10_MUL) >> KIN_DIV_BY_10_SHIFT))
+
+/* Pace in seconds per kilometre. Speeds too low to express, including a
+* standstill, report KIN_PACE_MAX.
+*/
+#define KIN_PACE_MAX                        (0xFFFFu)
+
+/* Reciprocal of the normalised speed: 2^31 / d for d in [2^15, 2^16) */
+#define KIN_RECIP_ONE                       (0x80000000u)
+#define KIN_RECIP_NORM_MIN                  (0x8000u)
+#define KIN_RECIP_FRAC_BITS                 (31u)
+#define KIN_RECIP_SEED_BITS                 (5u)
+#define KIN_RECIP_SEED_COUNT                (1u << KIN_RECIP_SEED_BITS)
+#define KIN_RECIP_SEED_SHIFT                (15u - KIN_RECIP_SEED_BITS)
+#define KIN_RECIP_SEED_MASK                 (KIN_RECIP_SEED_COUNT - 1u)
+#define KIN_RECIP_ITERATIONS                (2u)
+#define KIN_RECIP_MAX                       (0x10000u)
+
+/* The error term is pre-shifted so error * reciprocal stays within 31 bits:
+* the seed is good to 1/65, so the error is below 2^31 / 65.
+*/
+#define KIN_RECIP_ERR_SHIFT                 (12u)
+#define KIN_RECIP_CORR_SHIFT                (KIN_RECIP_FRAC_BITS - KIN_RECIP_ERR_SHIFT)
+
+#define KIN_PACE_NUMERATOR                  (KIN_METERS_PER_KM << KIN_SPEED_FRAC_BITS)
+
+/* pace = 1000 * 256 / speed = (1000 * recip) >> (23 - normalisation shift) */
+#define KIN_PACE_SHIFT                      (KIN_RECIP_FRAC_BITS - KIN_SPEED_FRAC_BITS)
+
+/* Highest power of four in 32 bits */
+#define KIN_SQRT_TOP_BIT                    (0x40000000u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+uint16 KinSpeed(uint8 cadence, uint16 strideCm);
+void KinAddDistance(uint32 * distanceDm, uint8 * remainderCm, uint16 strideCm);
+uint16 KinPace(uint16 speed);
+uint16 KinDivide(uint16 dividend, uint16 divisor);
+uint16 KinSqrt(uint32 value);
+
+
+/* [] END OF FILE */
@@ -20,6 +20,24 @@
 #include <project.h>
 #include "common.h"
 #include "rscs.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "stride.h"
+#include "evtqueue.h"
+#include "connparam.h"
+#include "odometer.h"
+#include "workout.h"
+#include "transfer.h"
+#include "reconnect.h"
+#include "motion.h"
+#include "txpower.h"
+#include "powerstats.h"
+#include "profiler.h"
+#include "airlatency.h"
+#include "evtrace.h"
+
+#define DEBUG_MODULE_LEVEL      (MAIN_DEBUG_LEVEL)
+#include "debug.h"
 
 
 /***************************************
@@ -27,6 +45,13 @@
 ***************************************/
 void HandleLeds(void);
 void AppCallBack(uint32 event, void * eventParam);
+void StartProfileTimers(void);
+void StopProfileTimers(void);
+void NotificationTimerCallback(void);
+void PaceTimerCallback(void);
+void ProfileTimerCallback(void);
+void LedTimerCallback(void);
+void HandleEvents(void);
 
 
 /***************************************
@@ -36,11 +61,10 @@ CYBLE_CONN_HANDLE_T  connectionHandle;
 uint8                state = DISCONNECTED;
 uint16               advBlinkDelayCount;
 uint8                advLedState = LED_OFF;
-uint16               justWakeFromDeepSleep = 0u;
-uint16               profileTimer = WALKING_PROFILE_TIMER_VALUE;
-uint16               paceTimer = PACE_TIMER_VALUE;
-uint16               notificationTimer = NOTIFICATION_TIMER_VALUE;
-volatile uint32      mainTimer = 0u;
+uint16               eventsDropped = 0u;
+
+/* Set by the disconnect handler, so the dump isn't profiled with it */
+uint8                profilerDumpPending = NO;
 
 
 /*******************************************************************************
@@ -63,34 +87,33 @@ volatile uint32      mainTimer = 0u;
 void AppCallBack(uint32 event, void *eventParam)
 {
     CYBLE_API_RESULT_T apiResult;
-    CYBLE_GAP_AUTH_INFO_T *authInfo;
     CYBLE_GAP_BD_ADDR_T localAddr;
     uint8 i;
     
+    EVTRACE_RECORD(EVTRACE_SOURCE_APP, event, eventParam);
+    PROFILER_START(PROFILER_APP_CALLBACK);
+
     switch(event)
 	{
     /**********************************************************
     *                       General Events
     ***********************************************************/
 	case CYBLE_EVT_STACK_ON: /* This event received when component is started */
-        printf("Bluetooth On, Start advertisement with addr: ");
+        LOG_INFO("Bluetooth On, Start advertisement with addr: ");
         
         localAddr.type = 0u;
         CyBle_GetDeviceAddress(&localAddr);
         
         for(i = CYBLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
         {
-            printf("%2.2x", localAddr.bdAddr[i-1]);
+            LOG_INFO("%2.2x", localAddr.bdAddr[i-1]);
         }
-        printf("\r\n");
-        
-        /* Enter discoverable mode so that remote Client could find the device. */
-        apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
+        LOG_INFO("\r\n");
         
-        if(apiResult != CYBLE_ERROR_OK)
-        {
-            printf("StartAdvertisement API Error: %d \r\n", apiResult);
-        }
+        /* Enter discoverable mode so that remote Client could find the device,
+        * directed at the bonded Client first. */
+        ReconnectInit();
+        (void) ReconnectStartAdvertising();
 		break;
         
 	case CYBLE_EVT_TIMEOUT:
@@ -99,71 +122,106 @@ void AppCallBack(uint32 event, void *eventParam)
     	/* CYBLE_GAP_AUTH_TO - Authentication procedure timeout */
         /* CYBLE_GAP_SCAN_TO - Scan time set by application has expired */
         /* CYBLE_GATT_RSP_TO - GATT procedure timeout */
-        printf("TimeOut: %x \r\n", *(uint8 *) eventParam);
+        LOG_WARN("TimeOut: %x \r\n", *(uint8 *) eventParam);
 		break;
 	case CYBLE_EVT_HARDWARE_ERROR:    /* This event indicates that some internal HW error has occurred. */
-        printf("Hardware Error \r\n");
+        LOG_ERROR("Hardware Error \r\n");
 		break;
+    case CYBLE_EVT_STACK_BUSY_STATUS:
+        /* The main loop fills the freed buffers, see TransferProcess() */
+        break;
         
     /**********************************************************
     *                       GAP Events
     ***********************************************************/
     case CYBLE_EVT_GAP_AUTH_REQ:
-        printf("CYBLE_EVT_GAP_AUTH_REQ: security: 0x%x, bonding: 0x%x, ekeySize: 0x%x, authErr: 0x%x \r\n", 
+        LOG_INFO("CYBLE_EVT_GAP_AUTH_REQ: security: 0x%x, bonding: 0x%x, ekeySize: 0x%x, authErr: 0x%x \r\n", 
                 (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).security, 
                 (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).bonding, 
                 (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).ekeySize, 
                 (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).authErr);
         break;
     case CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST:
-        printf("\r\n");
-        printf("CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST press 'p' to enter passkey.\r\n");
+        LOG_INFO("\r\n");
+        LOG_INFO("CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST press 'p' to enter passkey.\r\n");
         break;
     case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
-        printf("\r\n");
-        printf("CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST. Passkey is: %d%d.\r\n", 
+        LOG_INFO("\r\n");
+        LOG_INFO("CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST. Passkey is: %d%d.\r\n", 
             HI16(*(uint32 *)eventParam), 
             LO16(*(uint32 *)eventParam));
-        printf("Please enter the passkey on your Server device.\r\n"); 
+        LOG_INFO("Please enter the passkey on your Server device.\r\n"); 
         break;
     case CYBLE_EVT_GAP_AUTH_COMPLETE:
-        authInfo = (CYBLE_GAP_AUTH_INFO_T *)eventParam;
-
-        printf("\r\n");
-        printf("CYBLE_EVT_GAP_AUTH_COMPLETE: security: 0x%x, bonding: 0x%x, ekeySize: 0x%x, authErr 0x%x \r\n", 
-                                authInfo->security, authInfo->bonding, authInfo->ekeySize, authInfo->authErr);
-        printf("Bonding complete.\r\n");
+        LOG_INFO("\r\n");
+        LOG_INFO("CYBLE_EVT_GAP_AUTH_COMPLETE: security: 0x%x, bonding: 0x%x, ekeySize: 0x%x, authErr 0x%x \r\n", 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).security, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).bonding, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).ekeySize, 
+                (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).authErr);
+        LOG_INFO("Bonding complete.\r\n");
+        if(CYBLE_GAP_BONDING == (*(CYBLE_GAP_AUTH_INFO_T *)eventParam).bonding)
+        {
+            ReconnectBonded(connectionHandle.bdHandle);
+        }
         break;
     case CYBLE_EVT_GAP_AUTH_FAILED:
-        printf("EVT_AUTH_FAILED: %x \r\n", *(uint8 *) eventParam);
+        LOG_WARN("EVT_AUTH_FAILED: %x \r\n", *(uint8 *) eventParam);
         break;
     case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
         if(0u == *(uint8 *) eventParam)
         {
             if(ADVERTISING == state)
             {
-                printf("Advertisement is disabled \r\n");
+                LOG_INFO("Advertisement is disabled \r\n");
                 state = DISCONNECTED;
 
-                if(CYBLE_STATE_DISCONNECTED == CyBle_GetState())
+                if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (YES == ReconnectAdvertisingStopped()))
+                {
+                    /* The next directed burst or the undirected advertising */
+                }
+                else if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (YES == MotionAdvertisingStopped()))
+                {
+                    /* The next advertising round, the pod is not still */
+                }
+                else if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (YES == WorkoutIsActive()))
+                {
+                    /* The strides are drained from the sensor on the WDT,
+                     * which Hibernate stops. Record on and stay discoverable. */
+                    LOG_INFO("Recording a workout, advertising goes on \r\n");
+#if (MOTION_ADAPTIVE_ADV)
+                    apiResult = CyBle_GappStartAdvertisement(MotionAdvertisingType());
+#else
+                    apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_SLOW);
+#endif /* (MOTION_ADAPTIVE_ADV) */
+                    if(apiResult != CYBLE_ERROR_OK)
+                    {
+                        LOG_ERROR("StartAdvertisement API Error: %d \r\n", apiResult);
+                    }
+                }
+                else if(CYBLE_STATE_DISCONNECTED == CyBle_GetState())
                 {
                     /* Fast and slow advertising periods complete, go to low power  
                      * mode (Hibernate mode) and wait for an external
                      * user event to wake up the device again */
-                    printf("Hibernate \r\n");
+                    LOG_INFO("Hibernate \r\n");
                     Disconnect_LED_Write(LED_ON);
                     Advertising_LED_Write(LED_OFF);
                     Running_LED_Write(LED_OFF);
                     SW2_ClearInterrupt();
                     SW2_Interrupt_ClearPending();
                     SW2_Interrupt_Start();
+                    MotionPrepareHibernate();
+                    /* RAM doesn't survive Hibernate */
+                    OdometerSave(rscMeasurement.totalDistance);
+                    BinLogFlush();
                     while((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) != 0);
                     CySysPmHibernate();
                 }
             }
             else
             {
-                printf("Advertisement is enabled \r\n");
+                LOG_INFO("Advertisement is enabled \r\n");
                 /* Device now is in Advertising state */
                 state = ADVERTISING;
             }
@@ -173,42 +231,64 @@ void AppCallBack(uint32 event, void *eventParam)
             /* Error occurred in the BLE Stack */
             if(ADVERTISING == state)
             {
-                printf("Failed to stop advertising \r\n");
+                LOG_ERROR("Failed to stop advertising \r\n");
             }
             else
             {
-                printf("Failed to start advertising \r\n");
+                LOG_ERROR("Failed to start advertising \r\n");
             }
         }
         break;
     case CYBLE_EVT_GAP_DEVICE_CONNECTED:
-        printf("CYBLE_EVT_DEVICE_CONNECTED: %d \r\n", connectionHandle.bdHandle);
+        LOG_INFO("CYBLE_EVT_DEVICE_CONNECTED: %d \r\n", connectionHandle.bdHandle);
         state = CONNECTED;
+        ConnParamConnected((CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *) eventParam);
+        TxPowerConnected();
+        /* The Client gets the strides live, end the workout */
+        WorkoutArm(NO);
+        StartProfileTimers();
         break;
     case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
         connectionHandle.bdHandle = 0u;
-        printf("CYBLE_EVT_DEVICE_DISCONNECTED\r\n");
+        LOG_INFO("CYBLE_EVT_DEVICE_DISCONNECTED\r\n");
+        StopProfileTimers();
+        ConnParamDisconnected();
+        TxPowerDisconnected();
+        WorkoutArm(YES);
+        ReconnectDisconnected();
+        AirLatencyReport();
+        profilerDumpPending = YES;
         /* Put the device to discoverable mode so that remote can search it. */
         
-        state = CONNECTED;
+        state = DISCONNECTED;
         
-        apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-        if(apiResult != CYBLE_ERROR_OK)
-        {
-            printf("StartAdvertisement API Error: %d \r\n", apiResult);
-        }
+        (void) ReconnectStartAdvertising();
         break;
     case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
-        printf("ENCRYPT_CHANGE: %x \r\n", *(uint8 *) eventParam);
+        LOG_INFO("ENCRYPT_CHANGE: %x \r\n", *(uint8 *) eventParam);
         break;
     case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
-        printf("\r\n");
-        printf("CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE: %x \r\n", *(uint8 *) eventParam);
+        LOG_INFO("\r\n");
+        LOG_INFO("CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE: %x \r\n", *(uint8 *) eventParam);
+        ConnParamUpdated((CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *) eventParam);
+        if(YES == SwTimerIsActive(SWTIMER_NOTIFICATION))
+        {
+            /* Keep the notifications in step with the new connection events */
+            SwTimerStart(SWTIMER_NOTIFICATION, ConnParamNotificationTicks(), &NotificationTimerCallback);
+        }
         break;
 
     case CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT:
-        printf("\r\n");
-        printf("CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT\r\n");
+        LOG_INFO("\r\n");
+        LOG_INFO("CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT\r\n");
+        break;
+
+    /**********************************************************
+    *                       L2CAP Events
+    ***********************************************************/
+    case CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP:
+        LOG_TRACE("CYBLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP: %x \r\n", *(uint16 *) eventParam);
+        ConnParamResponse(*(uint16 *) eventParam);
         break;
 
     /**********************************************************
@@ -216,19 +296,25 @@ void AppCallBack(uint32 event, void *eventParam)
     ***********************************************************/
     case CYBLE_EVT_GATT_CONNECT_IND:
         connectionHandle = *(CYBLE_CONN_HANDLE_T *)eventParam;
-        printf("CYBLE_EVT_GATT_CONNECT_IND: %x \r\n", connectionHandle.attId);
+        LOG_TRACE("CYBLE_EVT_GATT_CONNECT_IND: %x \r\n", connectionHandle.attId);
+        RscOpenConnection(connectionHandle);
+        ReconnectConnected();
         break;
     case CYBLE_EVT_GATT_DISCONNECT_IND:
-        printf("EVT_GATT_DISCONNECT_IND: \r\n");
+        LOG_TRACE("EVT_GATT_DISCONNECT_IND: \r\n");
+        TransferDisconnected(((CYBLE_CONN_HANDLE_T *)eventParam)->bdHandle);
+        RscCloseConnection();
         connectionHandle.attId = 0;
         break;
     case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
-        printf("MTU exchange request received\r\n");
+        LOG_TRACE("MTU exchange request received\r\n");
+        TransferMtuExchanged((CYBLE_GATT_XCHG_MTU_PARAM_T *) eventParam);
         break;
     case CYBLE_EVT_GATTS_INDICATION_ENABLED:
         break;
     case CYBLE_EVT_GATTS_WRITE_REQ:
-        printf("CYBLE_EVT_GATTS_WRITE_REQ:\r\n");
+        LOG_TRACE("CYBLE_EVT_GATTS_WRITE_REQ:\r\n");
+        TransferWriteRequest((CYBLE_GATTS_WRITE_REQ_PARAM_T *) eventParam);
         break;
         
     /**********************************************************
@@ -236,59 +322,125 @@ void AppCallBack(uint32 event, void *eventParam)
     ***********************************************************/
 
     default:
-        printf("Unknown event - %x \r\n", LO16(event));
+        LOG_TRACE("Unknown event - %x \r\n", LO16(event));
         break;
 	}
+
+    PROFILER_END(PROFILER_APP_CALLBACK);
+}
+
+
+/*******************************************************************************
+* Function Name: StartProfileTimers
+********************************************************************************
+*
+* Summary:
+*  Starts the notification, pace and profile simulation timers. With the
+*  accelerometer the profile timer drains the sensor FIFO instead.
+*
+*******************************************************************************/
+void StartProfileTimers(void)
+{
+    SwTimerStart(SWTIMER_NOTIFICATION, ConnParamNotificationTicks(), &NotificationTimerCallback);
+#if (STRIDE_SENSOR_ENABLED)
+    SwTimerStart(SWTIMER_PROFILE, SWTIMER_MS_TO_TICKS(STRIDE_FIFO_PERIOD_MS), &StrideProcessFifo);
+#else
+    SwTimerStart(SWTIMER_PACE, SWTIMER_MS_TO_TICKS(PACE_PERIOD_MS), &PaceTimerCallback);
+    SwTimerStart(SWTIMER_PROFILE, SWTIMER_MS_TO_TICKS(WALKING_PROFILE_PERIOD_MS), &ProfileTimerCallback);
+#endif /* (STRIDE_SENSOR_ENABLED) */
+}
+
+
+/*******************************************************************************
+* Function Name: StopProfileTimers
+********************************************************************************
+*
+* Summary:
+*  Stops the notification, pace and profile simulation timers. The sensor
+*  FIFO is drained on for the workout recorder.
+*
+*******************************************************************************/
+void StopProfileTimers(void)
+{
+    SwTimerStop(SWTIMER_NOTIFICATION);
+#if (!STRIDE_SENSOR_ENABLED)
+    SwTimerStop(SWTIMER_PACE);
+    SwTimerStop(SWTIMER_PROFILE);
+#endif /* (!STRIDE_SENSOR_ENABLED) */
 }
 
 
 /*******************************************************************************
-* Function Name: WDT_Interrupt
+* Function Name: NotificationTimerCallback
 ********************************************************************************
 *
 * Summary:
-*  Handles the Interrupt Service Routine for the WDT timer.
+*  Sends the RSC Measurement notification once a notification period, see
+*  ConnParamNotificationTicks(), at the TX power the last RSSI calls for.
 *
 *******************************************************************************/
-CY_ISR(WDT_Interrupt)
+void NotificationTimerCallback(void)
 {
-    if(CySysWdtGetInterruptSource() & WDT_INTERRUPT_SOURCE)
+    if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
     {
-        /* Indicate that timer is raised to the main loop */
-        mainTimer++;
+        TxPowerSample();
+        if(ENABLED == rscConnection.notificationState)
+        {
+            HandleRscNotifications();
+        }
+    }
+}
+
 
-        /* Clears interrupt request  */
-        CySysWdtClearInterrupt(WDT_INTERRUPT_SOURCE);
+/*******************************************************************************
+* Function Name: PaceTimerCallback
+********************************************************************************
+*
+* Summary:
+*  Updates walking/running pace once in PACE_PERIOD_MS.
+*
+*******************************************************************************/
+void PaceTimerCallback(void)
+{
+    UpdatePace();
+}
+
+
+/*******************************************************************************
+* Function Name: ProfileTimerCallback
+********************************************************************************
+*
+* Summary:
+*  Simulates a stride once in a second when walking or twice in a second when
+*  running.
+*
+*******************************************************************************/
+void ProfileTimerCallback(void)
+{
+    SimulateProfile();
+
+    if(WALKING == profile)
+    {
+        SwTimerStart(SWTIMER_PROFILE, SWTIMER_MS_TO_TICKS(WALKING_PROFILE_PERIOD_MS), &ProfileTimerCallback);
+    }
+    else
+    {
+        SwTimerStart(SWTIMER_PROFILE, SWTIMER_MS_TO_TICKS(RUNNING_PROFILE_PERIOD_MS), &ProfileTimerCallback);
     }
 }
 
 
 /*******************************************************************************
-* Function Name: WDT_Start
+* Function Name: LedTimerCallback
 ********************************************************************************
 *
 * Summary:
-*  Configures WDT to trigger an interrupt every second.
+*  Toggles the advertising indication LED.
 *
 *******************************************************************************/
-void WDT_Start(void)
+void LedTimerCallback(void)
 {
-    /* Unlock the WDT registers for modification */
-    CySysWdtUnlock();
-    /* Setup ISR */
-    WDT_Interrupt_StartEx(&WDT_Interrupt);
-    /* Write the mode to generate interrupt on match */
-    CySysWdtWriteMode(WDT_COUNTER, CY_SYS_WDT_MODE_INT);
-    /* Configure the WDT counter clear on a match setting */
-    CySysWdtWriteClearOnMatch(WDT_COUNTER, WDT_COUNTER_ENABLE);
-    /* Configure the WDT counter match comparison value */
-    CySysWdtWriteMatch(WDT_COUNTER, WDT_500MSEC);
-    /* Reset WDT counter */
-    CySysWdtResetCounters(WDT_COUNTER);
-    /* Enable the specified WDT counter */
-    CySysWdtEnable(WDT_COUNTER_MASK);
-    /* Lock out configuration changes to the Watchdog timer registers */
-    CySysWdtLock();
+    advLedState ^= LED_OFF;
 }
 
 
@@ -312,6 +464,7 @@ void HandleLeds(void)
     if(DISCONNECTED == state)
     {
         /* ... turn on disconnect indication LED and turn off advertising LED. */
+        SwTimerStop(SWTIMER_LED);
         Disconnect_LED_Write(LED_ON);
         Advertising_LED_Write(LED_OFF);
         Running_LED_Write(LED_OFF);
@@ -324,11 +477,9 @@ void HandleLeds(void)
         Running_LED_Write(LED_OFF);
         
         /* ... blink advertising indication LED. */
-        
-        if(0u != mainTimer)
-        {            
-            mainTimer = 0u;
-            advLedState ^= LED_OFF;    
+        if(NO == SwTimerIsActive(SWTIMER_LED))
+        {
+            SwTimerStart(SWTIMER_LED, SWTIMER_MS_TO_TICKS(LED_BLINK_PERIOD_MS), &LedTimerCallback);
         }
         
         Advertising_LED_Write(advLedState);
@@ -337,6 +488,7 @@ void HandleLeds(void)
     else
     {
         /* ... turn off disconnect indication and advertising indication LEDs. */
+        SwTimerStop(SWTIMER_LED);
         Disconnect_LED_Write(LED_OFF);
         Advertising_LED_Write(LED_OFF);
         
@@ -353,11 +505,15 @@ void HandleLeds(void)
 
 
 /*******************************************************************************
-* Function Name: ButtonPressInt
+* Function Name: HandleEvents
 ********************************************************************************
 *
 * Summary:
-*   Handles the mechanical button press.
+*  Processes the events queued by the button interrupt. The measurement is
+*  only changed here, in the main loop, so a notification never carries a mix
+*  of walking and running values. SW2 toggles the simulated profile, with the
+*  accelerometer the gait is classified from the strides instead. Also writes
+*  the profile dump the disconnect handler asked for.
 *
 * Parameters:
 *   None
@@ -366,29 +522,87 @@ void HandleLeds(void)
 *   None
 *
 *******************************************************************************/
-CY_ISR(ButtonPressInt)
+void HandleEvents(void)
 {
-    if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
+    EVTQ_EVENT_T event;
+    uint16 dropped;
+
+    while(YES == EvtQueueGet(&event))
     {
-        if(WALKING == profile)
-        {
-            /* Update device with running simulation data */
-            profile = RUNNING;
-            rscMeasurement.flags |= RSC_FEATURE_WALK_RUN_STATUS_MASK;
-            rscMeasurement.instStridelen = RUNNING_INST_STRIDE_LENGTH_MIN;
-            rscMeasurement.instCadence = RUNNING_INST_CADENCE_MIN;
-        }
-        else
+        switch(event.type)
         {
-            /* Update device with walking simulation data */
-            profile = WALKING;
-            rscMeasurement.flags &= ~RSC_FEATURE_WALK_RUN_STATUS_MASK;
-            rscMeasurement.instStridelen = WALKING_INST_STRIDE_LENGTH_MIN;
-            rscMeasurement.instCadence = WALKING_INST_CADENCE_MIN;
+        case EVTQ_EVT_BUTTON:
+            /* A press shows the pod is in use */
+            MotionDetected();
+            if(CyBle_GetState() != CYBLE_STATE_CONNECTED)
+            {
+                ProfilerDump();
+            }
+#if (!STRIDE_SENSOR_ENABLED)
+            if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
+            {
+                if(WALKING == profile)
+                {
+                    /* Update device with running simulation data */
+                    SetProfile(RUNNING);
+                    rscMeasurement.instStridelen = RUNNING_INST_STRIDE_LENGTH_MIN;
+                    rscMeasurement.instCadence = RUNNING_INST_CADENCE_MIN;
+                }
+                else
+                {
+                    /* Update device with walking simulation data */
+                    SetProfile(WALKING);
+                    rscMeasurement.instStridelen = WALKING_INST_STRIDE_LENGTH_MIN;
+                    rscMeasurement.instCadence = WALKING_INST_CADENCE_MIN;
+                }
+            }
+#endif /* (!STRIDE_SENSOR_ENABLED) */
+            break;
+        default:
+            LOG_WARN("Unknown queued event - %x \r\n", event.type);
+            break;
         }
     }
 
+    if(YES == profilerDumpPending)
+    {
+        profilerDumpPending = NO;
+        ProfilerDump();
+    }
+
+    dropped = EvtQueueGetDropped();
+    if(dropped != eventsDropped)
+    {
+        LOG_WARN("Event queue full, %u events dropped \r\n", (uint16) (dropped - eventsDropped));
+        eventsDropped = dropped;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ButtonPressInt
+********************************************************************************
+*
+* Summary:
+*   Handles the mechanical button press. The press is queued for the main
+*   loop, see HandleEvents().
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+CY_ISR(ButtonPressInt)
+{
+    PROFILER_START(PROFILER_BUTTON_ISR);
+
+    (void) EvtQueuePut(EVTQ_EVT_BUTTON, 0u, 0u);
+
     SW2_ClearInterrupt();
+
+    PROFILER_END(PROFILER_BUTTON_ISR);
 }
 
 
@@ -420,14 +634,32 @@ int main()
     CyBle_RscsRegisterAttrCallback(RscServiceAppEventHandler);
     
     /* Configure button interrupt */
+    EvtQueueInit();
     SW2_Interrupt_StartEx(&ButtonPressInt);
  
     UART_DEB_Start();
     
     /* Global Resources initialization */
-    WDT_Start();
+    SwTimerInit();
+    BinLogInit();
+    PowerStatsInit();
+    ProfilerInit();
     
     InitProfile();
+    StrideInit();
+
+    /* Carry on with the distance saved before the last reset or Hibernate */
+    rscMeasurement.totalDistance = OdometerInit();
+
+    /* Record the strides while no Client is connected */
+    WorkoutInit();
+    WorkoutArm(YES);
+
+    /* Advertise fast until the pod is found or laid down */
+    MotionInit();
+#if (STRIDE_SENSOR_ENABLED)
+    SwTimerStart(SWTIMER_PROFILE, SWTIMER_MS_TO_TICKS(STRIDE_FIFO_PERIOD_MS), &StrideProcessFifo);
+#endif /* (STRIDE_SENSOR_ENABLED) */
     
     while(1)
     {
@@ -448,86 +680,81 @@ int main()
                     /* Put the device into the Deep Sleep mode only when all debug information has been sent */
                     if((UART_DEB_SpiUartGetTxBufferSize() + UART_DEB_GET_TX_FIFO_SR_VALID) == 0u)
                     {
+                        PowerStatsSleepStart();
                         CySysPmDeepSleep();
-                        
-                        /* This variable will set only once per connection interval. This is required
-                        * to implement SW timers. Connection interval depends on Client settings.
-                        */
-                        justWakeFromDeepSleep = 1u;
+                        PowerStatsSleepEnd(POWERSTATS_DEEPSLEEP);
                     }
                     else
                     {
+                        PowerStatsDenied(POWERSTATS_DENIED_UART);
+                        PowerStatsSleepStart();
                         CySysPmSleep();
+                        PowerStatsSleepEnd(POWERSTATS_SLEEP);
                     }
                 }
+                else
+                {
+                    PowerStatsAwake(POWERSTATS_DENIED_BLESS);
+                }
             }
             else
             {
                 if(blessState != CYBLE_BLESS_STATE_EVENT_CLOSE)
                 {
+                    PowerStatsDenied(POWERSTATS_DENIED_LPM);
+                    PowerStatsSleepStart();
                     CySysPmSleep();
+                    PowerStatsSleepEnd(POWERSTATS_SLEEP);
+                }
+                else
+                {
+                    PowerStatsAwake(POWERSTATS_DENIED_EVENT_CLOSE);
                 }
             }
             CyGlobalIntEnable;
         }
+        else
+        {
+            PowerStatsAwake(POWERSTATS_DENIED_INITIALIZING);
+        }
+
+        /* Run the software timers that expired while sleeping. The WDT only
+        * wakes the device when the earliest deadline is reached, so this is a
+        * no-op after wakeups caused by the BLE connection events.
+        */
+        SwTimerProcess();
+
+        /* Send the buffered debug log in one burst when a flush is due */
+        BinLogProcess();
+
+        /* Apply the button events queued by the interrupt */
+        HandleEvents();
 
         /* Handle advertising LED blinking */
         HandleLeds();
 
+        /* Save the total distance every ODOMETER_SAVE_DISTANCE_DM */
+        OdometerProcess(rscMeasurement.totalDistance);
+
+        /* Store the workout once it ended */
+        WorkoutProcess();
+
+        /* Follow the motion with the advertising interval */
+        MotionProcess();
+
         if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
         {
-            if(0u != justWakeFromDeepSleep)
-            {
-                if(0u == notificationTimer)
-                {
-                    /* Send notification once in 3 seconds in case of 30 ms connection interval */
-                    if(rscNotificationState == ENABLED)
-                    {
-                        HandleRscNotifications();
-                    }
-                    notificationTimer = NOTIFICATION_TIMER_VALUE;
-                }
+            /* Follow the profile with the connection parameters */
+            ConnParamProcess();
 
-                notificationTimer--;
-                
-                if(0u == paceTimer)
-                {
-                    /* Update walking/running pace once in 10 seconds in case of 30 ms connection
-                    * interval.
-                    */
-                    UpdatePace();
-                    paceTimer = PACE_TIMER_VALUE;
-                }
-                
-                paceTimer--;
+            /* Send the indications that are pending */
+            HandleRscIndications();
 
-                if(0u == profileTimer)
-                {
-                    /* Simulate walking/running once in a second/half of a second
-                    * in case of 30 ms connection interval.
-                    */
-                    SimulateProfile();
-                    
-                    if(WALKING == profile)
-                    {
-                        profileTimer = WALKING_PROFILE_TIMER_VALUE;
-                    }
-                    else
-                    {
-                        profileTimer = RUNNING_PROFILE_TIMER_VALUE;
-                    }
-                }
-                
-                profileTimer--;
-                
-                justWakeFromDeepSleep = 0u;
-            }
+            /* Stream the stored workouts to a Client that asked for them */
+            TransferProcess();
 
-            /* Send indication if one is pending */
-            if((rscIndicationState == ENABLED) && (YES == rscIndicationPending))
-            {
-                HandleRscIndications();
-            }
+            /* Keep the Power Statistics recent for a Client reading them */
+            PowerStatsProcess();
             
             /* Store bonding data to flash only when all debug information has been sent */
             if((cyBle_pendingFlashWrite != 0u) &&
@@ -535,7 +762,8 @@ int main()
             {
                 CYBLE_API_RESULT_T apiResult;
                 apiResult = CyBle_StoreBondingData(0u);
-                printf("Store bonding data, status: %x \r\n", apiResult);
+                LOG_INFO("Store bonding data, status: %x \r\n", apiResult);
+                (void) apiResult;
             }
         }
     }
@@ -0,0 +1,348 @@
+/*******************************************************************************
+* File Name: motion.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the motion tracker and the advertising scheduler: the
+*  motion level, the advertising round of each level and the motion wake
+*  from Hibernate.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "stride.h"
+#include "motion.h"
+
+#define DEBUG_MODULE_LEVEL      (MAIN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Advertising interval range and timeout of the rounds, indexed by the
+* motion level
+*/
+static const uint16 motionAdvIntMin[MOTION_LEVEL_COUNT] =
+{
+    MOTION_ADV_STILL_INT_MIN, MOTION_ADV_MOVING_INT_MIN, MOTION_ADV_ACTIVE_INT_MIN
+};
+static const uint16 motionAdvIntMax[MOTION_LEVEL_COUNT] =
+{
+    MOTION_ADV_STILL_INT_MAX, MOTION_ADV_MOVING_INT_MAX, MOTION_ADV_ACTIVE_INT_MAX
+};
+static const uint16 motionAdvTimeout[MOTION_LEVEL_COUNT] =
+{
+    MOTION_ADV_STILL_ROUND_SEC, MOTION_ADV_ROUND_SEC, MOTION_ADV_ROUND_SEC
+};
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* Advertising rounds started at each motion level */
+uint16                  motionAdvRounds[MOTION_LEVEL_COUNT];
+
+/* Last motion, and the start of the motion that goes on since */
+static uint32           motionLastTicks;
+static uint32           motionStartTicks;
+static uint32           motionStrides;
+
+/* Level of the running round, MOTION_LEVEL_NONE while none runs */
+static uint8            motionAdvLevel = MOTION_LEVEL_NONE;
+static uint8            motionStopping = NO;
+
+#if (STRIDE_SENSOR_ENABLED)
+static uint8            motionArmed = NO;
+
+/* Set by MotionInt(). A flag of its own rather than the event queue, whose
+* single producer is ButtonPressInt().
+*/
+static volatile uint8   motionIntPending = NO;
+#endif /* (STRIDE_SENSOR_ENABLED) */
+
+
+/*******************************************************************************
+* Function Name: MotionInit
+********************************************************************************
+*
+* Summary:
+*  Starts in motion: the pod was just switched on, woken by SW2 or by motion.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void MotionInit(void)
+{
+    motionLastTicks = SwTimerGetTicks();
+    motionStartTicks = motionLastTicks;
+    motionStrides = strideCount;
+#if (STRIDE_SENSOR_ENABLED)
+    Motion_Interrupt_StartEx(&MotionInt);
+#endif /* (STRIDE_SENSOR_ENABLED) */
+}
+
+
+/*******************************************************************************
+* Function Name: MotionDetected
+********************************************************************************
+*
+* Summary:
+*  Records motion. Motion after MOTION_STILL_MS without starts a new period
+*  of fast advertising.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void MotionDetected(void)
+{
+    uint32 now = SwTimerGetTicks();
+
+    if((now - motionLastTicks) >= SWTIMER_MS_TO_TICKS(MOTION_STILL_MS))
+    {
+        motionStartTicks = now;
+    }
+    motionLastTicks = now;
+}
+
+
+/*******************************************************************************
+* Function Name: MotionGetLevel
+********************************************************************************
+*
+* Summary:
+*  Returns the motion level of now.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint8: MOTION_LEVEL_STILL, MOTION_LEVEL_MOVING or MOTION_LEVEL_ACTIVE.
+*
+*******************************************************************************/
+uint8 MotionGetLevel(void)
+{
+    uint32 now = SwTimerGetTicks();
+    uint8 level = MOTION_LEVEL_ACTIVE;
+
+    if((now - motionLastTicks) >= SWTIMER_MS_TO_TICKS(MOTION_STILL_MS))
+    {
+        level = MOTION_LEVEL_STILL;
+    }
+    else if((now - motionStartTicks) >= SWTIMER_MS_TO_TICKS(MOTION_ACTIVE_MS))
+    {
+        level = MOTION_LEVEL_MOVING;
+    }
+    else
+    {
+        /* Motion started lately */
+    }
+    return(level);
+}
+
+
+/*******************************************************************************
+* Function Name: MotionAdvertisingType
+********************************************************************************
+*
+* Summary:
+*  Sets up the undirected advertising round of the motion level. The caller
+*  passes the result to CyBle_GappStartAdvertisement().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint8: CYBLE_ADVERTISING_CUSTOM for the round, or CYBLE_ADVERTISING_FAST
+*         without MOTION_ADAPTIVE_ADV.
+*
+*******************************************************************************/
+uint8 MotionAdvertisingType(void)
+{
+    CYBLE_GAPP_DISC_PARAM_T *advParam = cyBle_discoveryModeInfo.advParam;
+    uint8 type = CYBLE_ADVERTISING_FAST;
+
+    motionAdvLevel = MOTION_LEVEL_NONE;
+    motionStopping = NO;
+    if(0u != MOTION_ADAPTIVE_ADV)
+    {
+        motionAdvLevel = MotionGetLevel();
+        advParam->advIntvMin = motionAdvIntMin[motionAdvLevel];
+        advParam->advIntvMax = motionAdvIntMax[motionAdvLevel];
+        cyBle_discoveryModeInfo.advTo = motionAdvTimeout[motionAdvLevel];
+        motionAdvRounds[motionAdvLevel]++;
+        BINLOG_INFO(BINLOG_EVT_MOTION_ADV, motionAdvLevel, advParam->advIntvMin, advParam->advIntvMax,
+            cyBle_discoveryModeInfo.advTo);
+        type = CYBLE_ADVERTISING_CUSTOM;
+    }
+    return(type);
+}
+
+
+/*******************************************************************************
+* Function Name: MotionAdvertisingStopped
+********************************************************************************
+*
+* Summary:
+*  Starts the next round when a round ended, unless it was the round at
+*  MOTION_LEVEL_STILL and the pod is still.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint8: YES when the advertising was started again, NO when the pod can
+*         hibernate.
+*
+*******************************************************************************/
+uint8 MotionAdvertisingStopped(void)
+{
+    uint8 restarted = NO;
+    uint8 level = motionAdvLevel;
+
+    motionAdvLevel = MOTION_LEVEL_NONE;
+    if((MOTION_LEVEL_NONE != level) && ((MOTION_LEVEL_STILL != level) || (MOTION_LEVEL_STILL != MotionGetLevel())))
+    {
+        if(CYBLE_ERROR_OK == CyBle_GappStartAdvertisement(MotionAdvertisingType()))
+        {
+            restarted = YES;
+        }
+    }
+    return(restarted);
+}
+
+
+/*******************************************************************************
+* Function Name: MotionProcess
+********************************************************************************
+*
+* Summary:
+*  Counts new strides and the activity interrupt as motion and restarts the
+*  advertising round when the motion level rose. Arms the activity interrupt
+*  once the pod is still.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void MotionProcess(void)
+{
+    uint8 level;
+
+    if(strideCount != motionStrides)
+    {
+        motionStrides = strideCount;
+        MotionDetected();
+    }
+
+#if (STRIDE_SENSOR_ENABLED)
+    if(YES == motionIntPending)
+    {
+        motionIntPending = NO;
+        MotionDetected();
+    }
+#endif /* (STRIDE_SENSOR_ENABLED) */
+
+    level = MotionGetLevel();
+    if((MOTION_LEVEL_NONE != motionAdvLevel) && (level > motionAdvLevel) && (NO == motionStopping) &&
+       (CYBLE_STATE_ADVERTISING == CyBle_GetState()) &&
+       (CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV == cyBle_discoveryModeInfo.advParam->advType))
+    {
+        /* The next round starts on CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP */
+        motionStopping = YES;
+        CyBle_GappStopAdvertisement();
+    }
+
+#if (STRIDE_SENSOR_ENABLED)
+    if(MOTION_LEVEL_STILL != level)
+    {
+        motionArmed = NO;
+    }
+    else if(NO == motionArmed)
+    {
+        /* Picked up without a stride, e.g. to put the pod on the shoe */
+        MotionSensorArm(MOTION_WAKE_THRESHOLD_MG);
+        Motion_Int_ClearInterrupt();
+        motionArmed = YES;
+        BINLOG_INFO(BINLOG_EVT_MOTION_ARMED, MOTION_WAKE_THRESHOLD_MG);
+    }
+    else
+    {
+        /* Waiting for the activity interrupt */
+    }
+#endif /* (STRIDE_SENSOR_ENABLED) */
+}
+
+
+/*******************************************************************************
+* Function Name: MotionPrepareHibernate
+********************************************************************************
+*
+* Summary:
+*  Lets the accelerometer's activity interrupt wake the pod from Hibernate,
+*  next to SW2.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void MotionPrepareHibernate(void)
+{
+#if (STRIDE_SENSOR_ENABLED)
+    MotionSensorArm(MOTION_WAKE_THRESHOLD_MG);
+    Motion_Int_ClearInterrupt();
+    Motion_Interrupt_ClearPending();
+    Motion_Interrupt_Start();
+#endif /* (STRIDE_SENSOR_ENABLED) */
+}
+
+
+#if (STRIDE_SENSOR_ENABLED)
+/*******************************************************************************
+* Function Name: MotionInt
+********************************************************************************
+*
+* Summary:
+*  Handles the accelerometer's activity interrupt. The motion is flagged for
+*  the main loop, see MotionProcess().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+CY_ISR(MotionInt)
+{
+    motionIntPending = YES;
+
+    Motion_Int_ClearInterrupt();
+}
+#endif /* (STRIDE_SENSOR_ENABLED) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,97 @@
+/*******************************************************************************
+* File Name: motion.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the motion tracker and
+*  the advertising scheduler. The strides, the accelerometer activity
+*  interrupt and SW2 count as motion. The undirected advertising runs in
+*  rounds whose interval follows the motion level:
+*
+*   MOTION_LEVEL_ACTIVE - motion started less than MOTION_ACTIVE_MS ago: the
+*                         fast interval, so the phone finds the pod as soon
+*                         as the run starts
+*   MOTION_LEVEL_MOVING - still in motion: the interval Apple recommends for
+*                         accessories, found within a few seconds
+*   MOTION_LEVEL_STILL  - no motion for MOTION_STILL_MS: the slow interval
+*                         for a last round, then Hibernate
+*
+*  A round ends after its advertising timeout and the next one takes the
+*  level of then; a level that rises during a round restarts it at once.
+*
+*  With the accelerometer the pod also wakes from Hibernate on motion. The
+*  sensor's activity interrupt output is wired to a digital input pin
+*  "Motion_Int" with a rising edge interrupt and an interrupt component
+*  "Motion_Interrupt" in the schematic, like SW2. The accelerometer driver
+*  provides MotionSensorArm(). Include common.h first.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+#define MOTION_LEVEL_STILL                  (0u)
+#define MOTION_LEVEL_MOVING                 (1u)
+#define MOTION_LEVEL_ACTIVE                 (2u)
+#define MOTION_LEVEL_COUNT                  (3u)
+#define MOTION_LEVEL_NONE                   (0xFFu)
+
+#define MOTION_ACTIVE_MS                    (30000u)
+#define MOTION_STILL_MS                     (30000u)
+
+/* Advertising intervals in 0.625 ms units: 20-30 ms, 152.5-211.25 ms and
+* 1022.5-1285 ms
+*/
+#define MOTION_ADV_ACTIVE_INT_MIN           (0x0020u)
+#define MOTION_ADV_ACTIVE_INT_MAX           (0x0030u)
+#define MOTION_ADV_MOVING_INT_MIN           (0x00F4u)
+#define MOTION_ADV_MOVING_INT_MAX           (0x0152u)
+#define MOTION_ADV_STILL_INT_MIN            (0x0664u)
+#define MOTION_ADV_STILL_INT_MAX            (0x0808u)
+
+/* Advertising timeout of a round in seconds */
+#define MOTION_ADV_ROUND_SEC                (10u)
+#define MOTION_ADV_STILL_ROUND_SEC          (60u)
+
+/* Change of the acceleration that raises the activity interrupt */
+#define MOTION_WAKE_THRESHOLD_MG            (200u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void MotionInit(void);
+void MotionDetected(void);
+uint8 MotionGetLevel(void);
+uint8 MotionAdvertisingType(void);
+uint8 MotionAdvertisingStopped(void);
+void MotionProcess(void);
+void MotionPrepareHibernate(void);
+
+#if (STRIDE_SENSOR_ENABLED)
+CY_ISR_PROTO(MotionInt);
+
+/* Provided by the accelerometer driver: raises the activity interrupt on the
+* INT pin once the acceleration changes by more than thresholdMg. The
+* interrupt stays raised until the next call.
+*/
+void MotionSensorArm(uint16 thresholdMg);
+#endif /* (STRIDE_SENSOR_ENABLED) */
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint16                   motionAdvRounds[MOTION_LEVEL_COUNT];
+
+
+/* [] END OF FILE */
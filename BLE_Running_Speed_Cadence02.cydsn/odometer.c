@@ -0,0 +1,243 @@
+/*******************************************************************************
+* File Name: odometer.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the flash odometer that keeps the total distance over
+*  resets and Hibernate. It owns the last ODOMETER_ROWS rows of the flash and
+*  writes them in turn, one record per row.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "odometer.h"
+
+#define DEBUG_MODULE_LEVEL      (RSCS_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+#define ODOMETER_ROW_RECORD(row)            ((const ODOMETER_RECORD_T *) (CY_FLASH_BASE + \
+                                             ((uint32) (ODOMETER_FIRST_ROW + (row)) * CY_FLASH_SIZEOF_ROW)))
+
+#define ODOMETER_CRC_INIT                   (0xFFFFu)
+#define ODOMETER_CRC_POLY                   (0x1021u)
+#define ODOMETER_CRC_MSB                    (0x8000u)
+
+
+/***************************************
+*        Global Variables
+***************************************/
+uint16                  odometerWrites = 0u;
+uint16                  odometerWriteErrors = 0u;
+/* Time the CPU was stalled by the row writes, in WDT ticks */
+uint32                  odometerWriteTicksMax = 0u;
+uint32                  odometerWriteTicksTotal = 0u;
+
+/* Rows of the log, read through ODOMETER_ROW_RECORD() */
+const uint8 CY_SECTION(".cy_odometer_rows") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+                        odometerRows[ODOMETER_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* Newest record in the flash */
+static uint8            odometerRow = ODOMETER_NO_ROW;
+static uint32           odometerSequence;
+static uint32           odometerSaved;
+
+
+/*******************************************************************************
+* Function Name: OdometerCheck
+********************************************************************************
+*
+* Summary:
+*  Computes the CRC-16/CCITT of the record contents.
+*
+*******************************************************************************/
+static uint16 OdometerCheck(uint32 sequence, uint32 totalDistance)
+{
+    uint8 data[2u * sizeof(uint32)];
+    uint16 crc = ODOMETER_CRC_INIT;
+    uint8 i;
+    uint8 bit;
+
+    for(i = 0u; i < sizeof(uint32); i++)
+    {
+        data[i] = (uint8) (sequence >> (i * ONE_BYTE_SHIFT));
+        data[sizeof(uint32) + i] = (uint8) (totalDistance >> (i * ONE_BYTE_SHIFT));
+    }
+
+    for(i = 0u; i < sizeof(data); i++)
+    {
+        crc ^= (uint16) ((uint16) data[i] << ONE_BYTE_SHIFT);
+        for(bit = 0u; bit < ONE_BYTE_SHIFT; bit++)
+        {
+            crc = (0u != (crc & ODOMETER_CRC_MSB)) ? (uint16) ((crc << 1u) ^ ODOMETER_CRC_POLY) : (uint16) (crc << 1u);
+        }
+    }
+    return(crc);
+}
+
+
+/*******************************************************************************
+* Function Name: OdometerInit
+********************************************************************************
+*
+* Summary:
+*  Finds the newest valid record. Erased rows, rows of an interrupted write and
+*  rows of another application fail the magic or the CRC check.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  The total distance in decimetres, 0 when no record is found.
+*
+*******************************************************************************/
+uint32 OdometerInit(void)
+{
+    const ODOMETER_RECORD_T *record;
+    uint8 row;
+
+    odometerRow = ODOMETER_NO_ROW;
+    odometerSequence = 0u;
+    odometerSaved = 0u;
+
+    for(row = 0u; row < ODOMETER_ROWS; row++)
+    {
+        record = ODOMETER_ROW_RECORD(row);
+        if((ODOMETER_MAGIC == record->magic) &&
+           (record->check == OdometerCheck(record->sequence, record->totalDistance)) &&
+           ((ODOMETER_NO_ROW == odometerRow) || (record->sequence > odometerSequence)))
+        {
+            odometerRow = row;
+            odometerSequence = record->sequence;
+            odometerSaved = record->totalDistance;
+        }
+    }
+
+    BINLOG_INFO(BINLOG_EVT_ODOMETER_RESTORED, odometerSaved, odometerSequence);
+    return(odometerSaved);
+}
+
+
+/*******************************************************************************
+* Function Name: OdometerSave
+********************************************************************************
+*
+* Summary:
+*  Appends a record with the total distance to the row after the newest one,
+*  unless that distance is saved already. The CPU is stalled while the row is
+*  erased and programmed.
+*
+* Parameters:
+*  totalDistance: Total distance in decimetres.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void OdometerSave(uint32 totalDistance)
+{
+    uint8 rowData[CY_FLASH_SIZEOF_ROW];
+    ODOMETER_RECORD_T record;
+    uint8 row = (ODOMETER_NO_ROW == odometerRow) ? 0u : (uint8) ((odometerRow + 1u) % ODOMETER_ROWS);
+    uint32 start;
+    uint32 ticks;
+    uint32 result;
+
+    if((ODOMETER_NO_ROW != odometerRow) && (totalDistance == odometerSaved))
+    {
+        return;
+    }
+
+    record.magic = ODOMETER_MAGIC;
+    record.sequence = odometerSequence + 1u;
+    record.totalDistance = totalDistance;
+    record.check = OdometerCheck(record.sequence, record.totalDistance);
+
+    memset(rowData, 0, sizeof(rowData));
+    memcpy(rowData, &record, sizeof(record));
+
+    start = SwTimerGetTicks();
+    result = CySysFlashWriteRow(ODOMETER_FIRST_ROW + row, rowData);
+    ticks = SwTimerGetTicks() - start;
+
+    odometerWriteTicksTotal += ticks;
+    if(ticks > odometerWriteTicksMax)
+    {
+        odometerWriteTicksMax = ticks;
+    }
+    if(ticks > SWTIMER_MS_TO_TICKS(ODOMETER_WRITE_BUDGET_MS))
+    {
+        BINLOG_WARN(BINLOG_EVT_ODOMETER_SLOW, (ticks * 1000u) / SWTIMER_TICKS_PER_SEC);
+    }
+
+    if(CY_SYS_FLASH_SUCCESS == result)
+    {
+        odometerWrites++;
+        odometerSequence = record.sequence;
+        BINLOG_TRACE(BINLOG_EVT_ODOMETER_SAVED, totalDistance, row);
+    }
+    else
+    {
+        /* The next write goes to the row after and keeps the sequence going */
+        odometerWriteErrors++;
+        BINLOG_ERROR(BINLOG_EVT_ODOMETER_ERROR, result);
+    }
+
+    /* Try again with the next save, not on every pass of the main loop */
+    odometerRow = row;
+    odometerSaved = totalDistance;
+}
+
+
+/*******************************************************************************
+* Function Name: OdometerProcess
+********************************************************************************
+*
+* Summary:
+*  Saves the total distance once it moved ODOMETER_SAVE_DISTANCE_DM on from the
+*  saved one, or went back. During a connection the row is written only while
+*  the radio is idle, so the stalled CPU doesn't hold up a connection event.
+*
+* Parameters:
+*  totalDistance: Total distance in decimetres.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void OdometerProcess(uint32 totalDistance)
+{
+    CYBLE_BLESS_STATE_T blessState;
+
+    if((totalDistance >= odometerSaved) && ((totalDistance - odometerSaved) < ODOMETER_SAVE_DISTANCE_DM))
+    {
+        return;
+    }
+
+    if(CYBLE_STATE_CONNECTED == CyBle_GetState())
+    {
+        blessState = CyBle_GetBleSsState();
+        if((CYBLE_BLESS_STATE_EVENT_CLOSE != blessState) && (CYBLE_BLESS_STATE_ECO_ON != blessState) &&
+           (CYBLE_BLESS_STATE_DEEPSLEEP != blessState))
+        {
+            return;
+        }
+    }
+
+    OdometerSave(totalDistance);
+}
+
+
+/* [] END OF FILE */
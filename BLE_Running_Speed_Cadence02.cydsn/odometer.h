@@ -0,0 +1,86 @@
+/*******************************************************************************
+* File Name: odometer.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the flash odometer. The
+*  total distance is appended as a checked record to the next of
+*  ODOMETER_ROWS flash rows in turn, so the rows wear evenly. A record takes a
+*  whole row: a write that is cut short by a reset only loses that record, and
+*  the newest valid one is recovered at startup.
+*
+*  Flash is written at most once every ODOMETER_SAVE_DISTANCE_DM, when the
+*  distance goes back (the Client set a lower cumulative value) and before
+*  Hibernate.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* The log takes the last rows of the flash. odometerRows reserves them in
+* the flash image: the linker options of the project place its section at
+* ODOMETER_FIRST_ROW, 0x1FC00, and the link fails when the application grows
+* into it.
+*/
+#define ODOMETER_ROWS                       (8u)
+#define ODOMETER_FIRST_ROW                  (CY_FLASH_NUMBER_ROWS - ODOMETER_ROWS)
+
+/* Distance between two writes in decimetres: 100 m. With 100k erase cycles
+* per row the log lasts 80,000 km.
+*/
+#define ODOMETER_SAVE_DISTANCE_DM           (1000u)
+
+/* A row write erases and programs the row with the CPU stalled; it takes about
+* 20 ms. Longer writes are reported.
+*/
+#define ODOMETER_WRITE_BUDGET_MS            (25u)
+
+#define ODOMETER_MAGIC                      (0x4F44u)
+#define ODOMETER_NO_ROW                     (0xFFu)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Record at the start of a row */
+typedef struct
+{
+    uint16 magic;
+    /* CRC-16/CCITT of sequence and totalDistance */
+    uint16 check;
+    uint32 sequence;
+    uint32 totalDistance;
+} ODOMETER_RECORD_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+uint32 OdometerInit(void);
+void OdometerProcess(uint32 totalDistance);
+void OdometerSave(uint32 totalDistance);
+
+
+/***************************************
+* External data references
+***************************************/
+extern const uint8              odometerRows[ODOMETER_ROWS * CY_FLASH_SIZEOF_ROW];
+extern uint16                   odometerWrites;
+extern uint16                   odometerWriteErrors;
+extern uint32                   odometerWriteTicksMax;
+extern uint32                   odometerWriteTicksTotal;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,212 @@
+/*******************************************************************************
+* File Name: powerstats.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the residency and transition counters of the low power
+*  modes and the Power Statistics service that a Client reads them from.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "powerstats.h"
+
+#define DEBUG_MODULE_LEVEL      (CONN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+POWERSTATS_T            powerStats;
+
+/* Tick count when the device went to sleep and when the Counters
+* characteristic was last refreshed
+*/
+static uint32           powerStatsSleepTicks;
+#if (POWERSTATS_SERVICE)
+static uint32           powerStatsUpdateTicks;
+#endif /* (POWERSTATS_SERVICE) */
+
+
+/*******************************************************************************
+* Function Name: PowerStatsInit
+********************************************************************************
+*
+* Summary:
+*  Clears the counters. Called after SwTimerInit().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsInit(void)
+{
+    memset(&powerStats, 0, sizeof(powerStats));
+    powerStats.startTicks = SwTimerGetTicks();
+#if (POWERSTATS_SERVICE)
+    powerStatsUpdateTicks = powerStats.startTicks;
+#endif /* (POWERSTATS_SERVICE) */
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStatsSleepStart
+********************************************************************************
+*
+* Summary:
+*  Takes the tick count before CySysPmDeepSleep() or CySysPmSleep(). Called
+*  with the interrupts disabled.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsSleepStart(void)
+{
+    powerStatsSleepTicks = SwTimerGetTicks();
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStatsSleepEnd
+********************************************************************************
+*
+* Summary:
+*  Counts a Deep-Sleep or Sleep entry and the ticks spent in it. Called after
+*  the wakeup with the interrupts still disabled.
+*
+* Parameters:
+*  mode: POWERSTATS_DEEPSLEEP or POWERSTATS_SLEEP.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsSleepEnd(uint8 mode)
+{
+    powerStats.sleepTicks[mode] += SwTimerGetTicks() - powerStatsSleepTicks;
+    powerStats.entries[mode]++;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStatsAwake
+********************************************************************************
+*
+* Summary:
+*  Counts a pass of the main() loop that stayed awake and the reason.
+*
+* Parameters:
+*  reason: POWERSTATS_DENIED_BLESS, POWERSTATS_DENIED_EVENT_CLOSE or
+*          POWERSTATS_DENIED_INITIALIZING.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsAwake(uint8 reason)
+{
+    powerStats.entries[POWERSTATS_AWAKE]++;
+    powerStats.denials[reason]++;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStatsDenied
+********************************************************************************
+*
+* Summary:
+*  Counts a pass of the main() loop that slept instead of entering
+*  Deep-Sleep and the reason.
+*
+* Parameters:
+*  reason: POWERSTATS_DENIED_UART or POWERSTATS_DENIED_LPM.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsDenied(uint8 reason)
+{
+    powerStats.denials[reason]++;
+}
+
+
+#if (POWERSTATS_SERVICE)
+/*******************************************************************************
+* Function Name: PowerStatsProcess
+********************************************************************************
+*
+* Summary:
+*  Writes the counters to the Counters characteristic every
+*  POWERSTATS_UPDATE_MS, so a read gets a recent value without waking the
+*  device. Called from the main() loop while connected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void PowerStatsProcess(void)
+{
+    uint8 value[POWERSTATS_VALUE_SIZE];
+    uint32 words[POWERSTATS_WORDS];
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValPair;
+    uint32 now = SwTimerGetTicks();
+    uint8 i;
+
+    if((now - powerStatsUpdateTicks) < SWTIMER_MS_TO_TICKS(POWERSTATS_UPDATE_MS))
+    {
+        return;
+    }
+    powerStatsUpdateTicks = now;
+
+    words[POWERSTATS_WORD_TICKS] = now - powerStats.startTicks;
+    words[POWERSTATS_WORD_DEEPSLEEP_TICKS] = powerStats.sleepTicks[POWERSTATS_DEEPSLEEP];
+    words[POWERSTATS_WORD_SLEEP_TICKS] = powerStats.sleepTicks[POWERSTATS_SLEEP];
+    for(i = 0u; i < POWERSTATS_MODES; i++)
+    {
+        words[POWERSTATS_WORD_ENTRIES + i] = powerStats.entries[i];
+    }
+    for(i = 0u; i < POWERSTATS_DENIALS; i++)
+    {
+        words[POWERSTATS_WORD_DENIALS + i] = powerStats.denials[i];
+    }
+    for(i = 0u; i < POWERSTATS_WORDS; i++)
+    {
+        value[(i * 4u)] = LO8(words[i]);
+        value[(i * 4u) + 1u] = HI8(words[i]);
+        value[(i * 4u) + 2u] = LO8(words[i] >> TWO_BYTES_SHIFT);
+        value[(i * 4u) + 3u] = HI8(words[i] >> TWO_BYTES_SHIFT);
+    }
+
+    handleValPair.attrHandle = CYBLE_POWER_STATISTICS_COUNTERS_CHAR_HANDLE;
+    handleValPair.value.val = value;
+    handleValPair.value.len = POWERSTATS_VALUE_SIZE;
+    if(CYBLE_GATT_ERR_NONE != CyBle_GattsWriteAttributeValue(&handleValPair, 0u, NULL,
+                                                             CYBLE_GATT_DB_LOCALLY_INITIATED))
+    {
+        LOG_ERROR("Power Statistics write error \r\n");
+    }
+}
+#endif /* (POWERSTATS_SERVICE) */
+
+
+/* [] END OF FILE */
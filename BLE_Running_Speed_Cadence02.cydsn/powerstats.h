@@ -0,0 +1,100 @@
+/*******************************************************************************
+* File Name: powerstats.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the low power
+*  statistics. The main() loop counts how often it enters Deep-Sleep and
+*  Sleep or stays awake, why it was denied the deeper mode, and how many
+*  ticks it spent in each mode. Reading the WDT tick count around the sleep
+*  calls costs a few cycles a wakeup.
+*
+*  A Client reads the counters from the Counters characteristic as
+*  POWERSTATS_WORDS 32-bit little-endian words in the order of the
+*  POWERSTATS_WORD_* indexes. The value is refreshed every
+*  POWERSTATS_UPDATE_MS while connected. The ticks are of the 32.768 kHz
+*  clock and the awake ticks are the total less the two sleep residencies.
+*
+*  The service is added to the BLE component in the customizer as a custom
+*  service "Power Statistics" with the UUIDs below and the Counters
+*  characteristic (Read) with a POWERSTATS_VALUE_SIZE byte value. The
+*  characteristic is refreshed with POWERSTATS_SERVICE only.
+*
+*   Service:  6e3a0010-5d3c-4b0e-9a8c-3f0b2d8e5c71
+*   Counters: 6e3a0011-5d3c-4b0e-9a8c-3f0b2d8e5c71
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Low power modes the main() loop ends up in */
+#define POWERSTATS_DEEPSLEEP                (0u)
+#define POWERSTATS_SLEEP                    (1u)
+#define POWERSTATS_AWAKE                    (2u)
+#define POWERSTATS_MODES                    (3u)
+
+/* Reasons a pass of the main() loop didn't reach Deep-Sleep */
+#define POWERSTATS_DENIED_UART              (0u)    /* Debug UART still sending, slept */
+#define POWERSTATS_DENIED_BLESS             (1u)    /* BLESS neither ECO_ON nor in Deep-Sleep, stayed awake */
+#define POWERSTATS_DENIED_LPM               (2u)    /* Stack refused Deep-Sleep, slept */
+#define POWERSTATS_DENIED_EVENT_CLOSE       (3u)    /* Stack refused Deep-Sleep closing an event, stayed awake */
+#define POWERSTATS_DENIED_INITIALIZING      (4u)    /* Stack initializing, stayed awake */
+#define POWERSTATS_DENIALS                  (5u)
+
+/* Words of the Counters characteristic */
+#define POWERSTATS_WORD_TICKS               (0u)
+#define POWERSTATS_WORD_DEEPSLEEP_TICKS     (1u)
+#define POWERSTATS_WORD_SLEEP_TICKS         (2u)
+#define POWERSTATS_WORD_ENTRIES             (3u)
+#define POWERSTATS_WORD_DENIALS             (POWERSTATS_WORD_ENTRIES + POWERSTATS_MODES)
+#define POWERSTATS_WORDS                    (POWERSTATS_WORD_DENIALS + POWERSTATS_DENIALS)
+#define POWERSTATS_VALUE_SIZE               (POWERSTATS_WORDS * 4u)
+
+#define POWERSTATS_UPDATE_MS                (5000u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint32 startTicks;
+    uint32 sleepTicks[POWERSTATS_AWAKE];
+    uint32 entries[POWERSTATS_MODES];
+    uint32 denials[POWERSTATS_DENIALS];
+} POWERSTATS_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void PowerStatsInit(void);
+void PowerStatsSleepStart(void);
+void PowerStatsSleepEnd(uint8 mode);
+void PowerStatsAwake(uint8 reason);
+void PowerStatsDenied(uint8 reason);
+#if (POWERSTATS_SERVICE)
+void PowerStatsProcess(void);
+#else
+    #define PowerStatsProcess()                 do { } while(0)
+#endif /* (POWERSTATS_SERVICE) */
+
+
+/***************************************
+* External data references
+***************************************/
+extern POWERSTATS_T             powerStats;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: profiler.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the cycle profiler of the event handlers and the
+*  interrupt service routines.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "binlog.h"
+#include "profiler.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* SysTick value at the start of the open region of each tag */
+uint32                  profilerStart[PROFILER_TAGS];
+
+PROFILER_TAG_T          profilerTags[PROFILER_TAGS];
+
+
+/*******************************************************************************
+* Function Name: ProfilerInit
+********************************************************************************
+*
+* Summary:
+*  Clears the statistics and lets SysTick run free over its full 24 bits
+*  without the interrupt. Does nothing without CYCLE_PROFILER.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ProfilerInit(void)
+{
+    if(0u != CYCLE_PROFILER)
+    {
+        memset(profilerTags, 0, sizeof(profilerTags));
+
+        CySysTickStart();
+        CySysTickDisableInterrupt();
+        CySysTickSetReload(CY_SYS_SYST_RVR_CNT_MASK);
+        CySysTickClear();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProfilerRecord
+********************************************************************************
+*
+* Summary:
+*  Ends a region of a tag, see PROFILER_END().
+*
+* Parameters:
+*  tag:   Profiled region, PROFILER_APP_CALLBACK to PROFILER_BUTTON_ISR.
+*  start: SysTick value at the start of the region.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ProfilerRecord(uint8 tag, uint32 start)
+{
+    PROFILER_TAG_T *stats = &profilerTags[tag];
+    uint32 cycles;
+    uint8 bucket = 0u;
+
+    /* SysTick counts down */
+    cycles = (start - CySysTickGetValue()) & CY_SYS_SYST_CVR_CNT_MASK;
+
+    if((0u == stats->calls) || (cycles < stats->min))
+    {
+        stats->min = cycles;
+    }
+    if(cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    stats->calls++;
+
+    if((stats->sum + cycles) < stats->sum)
+    {
+        stats->sum >>= 1u;
+        stats->sumCalls >>= 1u;
+    }
+    stats->sum += cycles;
+    stats->sumCalls++;
+
+    while((cycles >> (bucket + 1u)) != 0u)
+    {
+        bucket++;
+    }
+    if(stats->buckets[bucket] < 0xFFFFu)
+    {
+        stats->buckets[bucket]++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProfilerDump
+********************************************************************************
+*
+* Summary:
+*  Writes the statistics of the tags called so far to the binary log and
+*  sends it after each tag, so the histograms don't overrun the log buffer.
+*  Does nothing without CYCLE_PROFILER.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ProfilerDump(void)
+{
+    PROFILER_TAG_T *stats;
+    uint8 tag;
+    uint8 bucket;
+
+    if(0u == CYCLE_PROFILER)
+    {
+        return;
+    }
+
+    for(tag = 0u; tag < PROFILER_TAGS; tag++)
+    {
+        stats = &profilerTags[tag];
+        if(0u == stats->calls)
+        {
+            continue;
+        }
+
+        BINLOG(BINLOG_EVT_PROFILE, tag, stats->calls, stats->min, stats->max);
+        BINLOG(BINLOG_EVT_PROFILE_MEAN, tag, stats->sum / stats->sumCalls);
+        for(bucket = 0u; bucket < PROFILER_BUCKETS; bucket++)
+        {
+            if(0u != stats->buckets[bucket])
+            {
+                BINLOG(BINLOG_EVT_PROFILE_BUCKET, tag, stats->buckets[bucket],
+                    (0u != bucket) ? (1uL << bucket) : 0u, (2uL << bucket) - 1u);
+            }
+        }
+        BinLogFlush();
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,99 @@
+/*******************************************************************************
+* File Name: profiler.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the cycle profiler. With
+*  CYCLE_PROFILER the tagged regions read the SysTick counter on entry and
+*  exit and keep the calls, the minimum, maximum and mean cycles and a log2
+*  histogram for each tag. Without it the tags expand to nothing.
+*
+*  SysTick runs free from the CPU clock with the interrupt disabled, so a
+*  region must be shorter than 2^24 cycles, 350 ms at 48 MHz. It stops in
+*  Deep-Sleep, which no tagged region enters. The time of the interrupts
+*  that preempt a region is counted in the region.
+*
+*  ProfilerDump() writes a BINLOG_EVT_PROFILE record for each tag called so
+*  far and a BINLOG_EVT_PROFILE_BUCKET record for each histogram bucket that
+*  is not empty. The dump is written when the Client disconnects and when
+*  SW2 is pressed while not connected. The tags are numbered as below.
+*
+*  The host build reads the host's monotonic clock through the same SysTick
+*  API, scaled to CYDEV_BCLK__SYSCLK__HZ.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Profiled regions */
+#define PROFILER_APP_CALLBACK               (0u)
+#define PROFILER_RSCS_HANDLER               (1u)
+#define PROFILER_NOTIFICATIONS              (2u)
+#define PROFILER_INDICATIONS                (3u)
+#define PROFILER_WDT_ISR                    (4u)
+#define PROFILER_BUTTON_ISR                 (5u)
+#define PROFILER_TAGS                       (6u)
+
+/* Bucket n counts the regions of 2^n to 2^(n+1) - 1 cycles, bucket 0 also
+* the ones of 0 cycles
+*/
+#define PROFILER_BUCKETS                    (24u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint32 calls;
+    uint32 min;
+    uint32 max;
+    /* Sum of the cycles over sumCalls calls, both halved on overflow */
+    uint32 sum;
+    uint32 sumCalls;
+    uint16 buckets[PROFILER_BUCKETS];
+} PROFILER_TAG_T;
+
+
+/***************************************
+*        Macros
+***************************************/
+/* PROFILER_START(tag) and PROFILER_END(tag) enclose a region. A tag must
+* not be entered again before it ends.
+*/
+#if (CYCLE_PROFILER)
+    #define PROFILER_START(tag)             (profilerStart[(tag)] = CySysTickGetValue())
+    #define PROFILER_END(tag)               ProfilerRecord((tag), profilerStart[(tag)])
+#else
+    #define PROFILER_START(tag)             do { } while(0)
+    #define PROFILER_END(tag)               do { } while(0)
+#endif /* (CYCLE_PROFILER) */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void ProfilerInit(void);
+void ProfilerRecord(uint8 tag, uint32 start);
+void ProfilerDump(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint32                   profilerStart[PROFILER_TAGS];
+extern PROFILER_TAG_T           profilerTags[PROFILER_TAGS];
+
+
+/* [] END OF FILE */
@@ -0,0 +1,250 @@
+/*******************************************************************************
+* File Name: reconnect.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the reconnect policy: the directed advertising to the
+*  bonded Client after a disconnect or a reset, the fallback to undirected
+*  advertising and the time it took to reconnect.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "reconnect.h"
+#include "motion.h"
+
+#define DEBUG_MODULE_LEVEL      (CONN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* Reconnections since the start, those to directed advertising, and the
+* time from the disconnect to the last and to the slowest one
+*/
+uint16                  reconnectCount = 0u;
+uint16                  reconnectDirectedCount = 0u;
+uint32                  reconnectLastMs = 0u;
+uint32                  reconnectMaxMs = 0u;
+
+static CYBLE_GAP_BD_ADDR_T reconnectPeer;
+static uint8            reconnectPeerValid = NO;
+
+/* Directed bursts left to start, and whether the running advertising is one */
+static uint8            reconnectBursts = 0u;
+static uint8            reconnectDirected = NO;
+
+/* Disconnected since reconnectDownTicks */
+static uint8            reconnectPending = NO;
+static uint32           reconnectDownTicks;
+
+
+/*******************************************************************************
+* Function Name: ReconnectInit
+********************************************************************************
+*
+* Summary:
+*  Takes the Client bonded last from the bond list as the reconnect target, so
+*  the device advertises directed at it after a reset too. Called on
+*  CYBLE_EVT_STACK_ON, once the stack restored the bonding data.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ReconnectInit(void)
+{
+    CYBLE_GAP_BONDED_DEV_ADDR_LIST_T bondList;
+
+    reconnectPeerValid = NO;
+    if((CYBLE_ERROR_OK == CyBle_GapGetBondedDevicesList(&bondList)) && (0u != bondList.count))
+    {
+        reconnectPeer = bondList.bdAddrList[bondList.count - 1u];
+        reconnectPeerValid = YES;
+        BINLOG_INFO(BINLOG_EVT_RECONNECT_BONDED, reconnectPeer.type);
+    }
+    reconnectBursts = RECONNECT_DIRECTED_BURSTS;
+}
+
+
+/*******************************************************************************
+* Function Name: ReconnectStartAdvertising
+********************************************************************************
+*
+* Summary:
+*  Starts the next directed burst to the bonded Client while there are any
+*  left, otherwise the undirected advertising round of the motion level.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  CYBLE_API_RESULT_T: The result of CyBle_GappStartAdvertisement().
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T ReconnectStartAdvertising(void)
+{
+    CYBLE_GAPP_DISC_PARAM_T *advParam = cyBle_discoveryModeInfo.advParam;
+    CYBLE_API_RESULT_T apiResult;
+    uint8 type = CYBLE_ADVERTISING_FAST;
+
+    if((0u != DIRECTED_RECONNECT) && (YES == reconnectPeerValid) && (0u != reconnectBursts))
+    {
+        /* The controller ends a high duty cycle burst after 1.28 s */
+        advParam->advType = CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV;
+        advParam->directAddrType = reconnectPeer.type;
+        memcpy(advParam->directAddr, reconnectPeer.bdAddr, CYBLE_GAP_BD_ADDR_SIZE);
+        reconnectBursts--;
+        reconnectDirected = YES;
+        BINLOG_INFO(BINLOG_EVT_RECONNECT_DIRECTED, RECONNECT_DIRECTED_BURSTS - reconnectBursts,
+            RECONNECT_DIRECTED_BURSTS);
+    }
+    else
+    {
+        if(YES == reconnectDirected)
+        {
+            BINLOG_INFO(BINLOG_EVT_RECONNECT_UNDIRECTED);
+        }
+        advParam->advType = CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV;
+        reconnectBursts = 0u;
+        reconnectDirected = NO;
+        type = MotionAdvertisingType();
+    }
+
+    apiResult = CyBle_GappStartAdvertisement(type);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+        LOG_ERROR("StartAdvertisement API Error: %d \r\n", apiResult);
+    }
+    return(apiResult);
+}
+
+
+/*******************************************************************************
+* Function Name: ReconnectAdvertisingStopped
+********************************************************************************
+*
+* Summary:
+*  Follows a directed burst that ended without a connection with the next
+*  one, or with the undirected advertising after the last.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  uint8: YES when the advertising was started again, NO when the undirected
+*         advertising ended.
+*
+*******************************************************************************/
+uint8 ReconnectAdvertisingStopped(void)
+{
+    uint8 restarted = NO;
+
+    if((YES == reconnectDirected) && (CYBLE_ERROR_OK == ReconnectStartAdvertising()))
+    {
+        restarted = YES;
+    }
+    return(restarted);
+}
+
+
+/*******************************************************************************
+* Function Name: ReconnectConnected
+********************************************************************************
+*
+* Summary:
+*  Records the time it took to reconnect and leaves the advertising of the
+*  next Client undirected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ReconnectConnected(void)
+{
+    if(YES == reconnectPending)
+    {
+        reconnectLastMs = RECONNECT_TICKS_TO_MS(SwTimerGetTicks() - reconnectDownTicks);
+        if(reconnectLastMs > reconnectMaxMs)
+        {
+            reconnectMaxMs = reconnectLastMs;
+        }
+        reconnectCount++;
+        if(YES == reconnectDirected)
+        {
+            reconnectDirectedCount++;
+        }
+        reconnectPending = NO;
+        BINLOG_INFO(BINLOG_EVT_RECONNECTED, reconnectLastMs, reconnectDirected);
+    }
+
+    cyBle_discoveryModeInfo.advParam->advType = CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV;
+    reconnectBursts = 0u;
+    reconnectDirected = NO;
+}
+
+
+/*******************************************************************************
+* Function Name: ReconnectBonded
+********************************************************************************
+*
+* Summary:
+*  Makes the Client that just bonded the reconnect target.
+*
+* Parameters:
+*  bdHandle: Peer device handle.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ReconnectBonded(uint8 bdHandle)
+{
+    if(CYBLE_ERROR_OK == CyBle_GapGetPeerBdAddr(bdHandle, &reconnectPeer))
+    {
+        reconnectPeerValid = YES;
+        BINLOG_INFO(BINLOG_EVT_RECONNECT_BONDED, reconnectPeer.type);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ReconnectDisconnected
+********************************************************************************
+*
+* Summary:
+*  Starts the time to reconnect and arms the directed bursts. The caller
+*  starts the advertising with ReconnectStartAdvertising().
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void ReconnectDisconnected(void)
+{
+    reconnectDownTicks = SwTimerGetTicks();
+    reconnectPending = YES;
+    reconnectBursts = RECONNECT_DIRECTED_BURSTS;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/*******************************************************************************
+* File Name: reconnect.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the reconnect policy.
+*  With DIRECTED_RECONNECT and a bonded central the device advertises
+*  directed at it in RECONNECT_DIRECTED_BURSTS high duty cycle bursts of
+*  1.28 s after a disconnect or a reset, before it falls back to the
+*  undirected advertising any Client can find. A central that kept the
+*  connection pending, like a phone after a link loss, connects at the first
+*  directed packet it hears.
+*
+*  The directed packets go to the address the central bonded with. A central
+*  that rotates resolvable private addresses without the stack resolving
+*  them doesn't answer and is found by the undirected advertising.
+*
+*  The time from the disconnect to the next connection is tracked in
+*  reconnectLastMs and reconnectMaxMs.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* About 5 s of directed advertising, the time a phone that lost the link
+* usually needs to come back in range
+*/
+#define RECONNECT_DIRECTED_BURSTS           (4u)
+
+/* 1000 / SWTIMER_TICKS_PER_SEC is 125 / 4096, split so it doesn't overflow */
+#define RECONNECT_MS_MUL                    (125u)
+#define RECONNECT_MS_DIV                    (4096u)
+#define RECONNECT_TICKS_TO_MS(ticks)        ((((ticks) / RECONNECT_MS_DIV) * RECONNECT_MS_MUL) + \
+                                             ((((ticks) % RECONNECT_MS_DIV) * RECONNECT_MS_MUL) / RECONNECT_MS_DIV))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void ReconnectInit(void);
+CYBLE_API_RESULT_T ReconnectStartAdvertising(void);
+uint8 ReconnectAdvertisingStopped(void);
+void ReconnectConnected(void);
+void ReconnectBonded(uint8 bdHandle);
+void ReconnectDisconnected(void);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint16                   reconnectCount;
+extern uint16                   reconnectDirectedCount;
+extern uint32                   reconnectLastMs;
+extern uint32                   reconnectMaxMs;
+
+
+/* [] END OF FILE */
@@ -18,6 +18,16 @@
 
 #include "common.h"
 #include "rscs.h"
+#include "kinematics.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "txpower.h"
+#include "profiler.h"
+#include "airlatency.h"
+#include "evtrace.h"
+
+#define DEBUG_MODULE_LEVEL      (RSCS_DEBUG_LEVEL)
+#include "debug.h"
 
 
 /***************************************
@@ -25,11 +35,14 @@
 ***************************************/
 uint8                   profile = WALKING;
 uint16                  currSpeed = 0u;
-uint8                   rscNotificationState = DISABLED;
-uint8                   rscIndicationState = DISABLED;
-uint8                   rscIndicationPending = NO;
-uint8                   rcsOpCode = RSC_SC_CP_INVALID_OP_CODE;
-uint8                   rcsRespValue = RSC_SC_CP_INVALID_OP_CODE;
+
+/* Connected Client */
+RSC_CONNECTION_T        rscConnection;
+
+/* SC Control Point writes without room for the response */
+uint16                  rscCpDropped = 0u;
+/* Indications that were never confirmed */
+uint16                  rscCpTimeouts = 0u;
 
 /* Sensor locations supported by the device */
 uint8                   rscSensors[RSC_SENSORS_NUMBER];
@@ -37,10 +50,128 @@ uint8                   rscSensors[RSC_SENSORS_NUMBER];
 /* This variable contains profile simulation data */
 RSC_RSC_MEASUREMENT_T   rscMeasurement;
 
+/* Tick count when the measurement was last changed */
+uint32                  rscMeasurementTicks = 0u;
+
+/* Centimetres travelled that are not yet accounted in totalDistance */
+uint8                   totalDistanceCm = 0u;
+
 /* This variable contains profile simulation data */
 uint16                  rscFeature;
 
 
+/*******************************************************************************
+* Function Name: RscExecuteControlPoint
+********************************************************************************
+*
+* Summary:
+*  Executes an SC Control Point procedure and returns its response value.
+*
+*******************************************************************************/
+static uint8 RscExecuteControlPoint(const CYBLE_GATT_VALUE_T * value)
+{
+    uint8 respValue = CYBLE_RSCS_ERR_SUCCESS;
+
+    switch(value->val[RSC_SC_CP_OP_CODE_IDX])
+    {
+    case CYBLE_RSCS_SET_CUMMULATIVE_VALUE:
+        /* Validate command length */
+        if(value->len == RSC_SET_CUMMULATIVE_VALUE_LEN)
+        {
+            if(0u != (rscFeature & RSC_FEATURE_TOTAL_DISTANCE_PRESENT))
+            {
+                rscMeasurement.totalDistance = (value->val[RSC_SC_CUM_VAL_BYTE3_IDX] << THREE_BYTES_SHIFT) |
+                                (value->val[RSC_SC_CUM_VAL_BYTE2_IDX] << TWO_BYTES_SHIFT) |
+                                (value->val[RSC_SC_CUM_VAL_BYTE1_IDX] << ONE_BYTE_SHIFT) |
+                                value->val[RSC_SC_CUM_VAL_BYTE0_IDX];
+
+                BINLOG_INFO(BINLOG_EVT_CP_SET_CUMULATIVE);
+                totalDistanceCm = 0u;
+                respValue = CYBLE_RSCS_ERR_SUCCESS;
+            }
+            else
+            {
+                BINLOG_WARN(BINLOG_EVT_CP_NOT_SUPPORTED);
+                respValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
+            }
+        }
+        else
+        {
+            respValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
+        }
+        break;
+
+    case CYBLE_RSCS_START_SENSOR_CALIBRATION:
+        BINLOG_INFO(BINLOG_EVT_CP_CALIBRATION);
+        respValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
+        break;
+
+    case CYBLE_RSCS_UPDATE_SENSOR_LOCATION:
+        /* Validate command length */
+        if(value->len == RSC_UPDATE_SENSOR_LOCATION_LEN)
+        {
+            if(0u != (rscFeature & RSC_FEATURE_MULTIPLE_SENSOR_LOC_PRESENT))
+            {
+                BINLOG_INFO(BINLOG_EVT_CP_UPDATE_LOCATION);
+                
+                /* Check if the requested sensor location is supported */
+                if(YES == IsSensorLocationSupported(value->val[RSC_SC_SENSOR_LOC_IDX]))
+                {
+                    BINLOG_INFO(BINLOG_EVT_CP_LOCATION_SET);
+                    /* Set requested sensor location */
+                    CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_SENSOR_LOCATION, 1u, 
+                        &value->val[RSC_SC_SENSOR_LOC_IDX]);
+                }
+                else
+                {
+                    BINLOG_WARN(BINLOG_EVT_CP_LOCATION_INVALID);
+                    /* Invalid sensor location is received */
+                    respValue = CYBLE_RSCS_ERR_INVALID_PARAMETER;
+                }
+            }
+            else
+            {
+                BINLOG_WARN(BINLOG_EVT_CP_NOT_SUPPORTED);
+                respValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
+            }
+        }
+        else
+        {
+            respValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
+        }
+        break;
+
+    case CYBLE_RSCS_REQ_SUPPORTED_SENSOR_LOCATION:
+        /* Validate command length */
+        if(value->len == RSC_REQ_SUPPORTED_SENSOR_LOCATION_LEN)
+        {
+            if(0u != (rscFeature & RSC_FEATURE_MULTIPLE_SENSOR_LOC_PRESENT))
+            {
+                BINLOG_INFO(BINLOG_EVT_CP_SUPPORTED_LOCATIONS);
+                respValue = CYBLE_RSCS_ERR_SUCCESS;
+            }
+            else
+            {
+                BINLOG_WARN(BINLOG_EVT_CP_NOT_SUPPORTED);
+                respValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
+            }
+        }
+        else
+        {
+            respValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
+        }
+        break;
+
+    default:
+        BINLOG_WARN(BINLOG_EVT_CP_UNKNOWN);
+        respValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
+        break;
+    }
+
+    return(respValue);
+}
+
+
 /*******************************************************************************
 * Function Name: RscServiceAppEventHandler
 ********************************************************************************
@@ -59,151 +190,75 @@ uint16                  rscFeature;
 *******************************************************************************/
 void RscServiceAppEventHandler(uint32 event, void *eventParam)
 {
+#if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE)
     uint8 i;
-    CYBLE_RSCS_CHAR_VALUE_T *wrReqParam;
-    
+    uint32 param;
+#endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE) */
+    CYBLE_RSCS_CHAR_VALUE_T *wrReqParam = (CYBLE_RSCS_CHAR_VALUE_T *) eventParam;
+
+    EVTRACE_RECORD(EVTRACE_SOURCE_RSCS, event, eventParam);
+    PROFILER_START(PROFILER_RSCS_HANDLER);
+
     switch(event)
     {
     /***************************************
     *        RSCS Server events
     ***************************************/
     case CYBLE_EVT_RSCSS_NOTIFICATION_ENABLED:
-        printf("Notifications for RSC Measurement Characteristic are enabled\r\n");
-        rscNotificationState = ENABLED;
+        BINLOG_INFO(BINLOG_EVT_NTF_ENABLED);
+        rscConnection.notificationState = ENABLED;
         break;
         
     case CYBLE_EVT_RSCSS_NOTIFICATION_DISABLED:
-        printf("Notifications for RSC Measurement Characteristic are disabled\r\n");
-        rscNotificationState = DISABLED;
+        BINLOG_INFO(BINLOG_EVT_NTF_DISABLED);
+        rscConnection.notificationState = DISABLED;
 		break;
 
     case CYBLE_EVT_RSCSS_INDICATION_ENABLED:
-        printf("Indications for SC Control point Characteristic are enabled\r\n");
-        rscIndicationState = ENABLED;
+        BINLOG_INFO(BINLOG_EVT_IND_ENABLED);
+        rscConnection.indicationState = ENABLED;
 		break;
         
     case CYBLE_EVT_RSCSS_INDICATION_DISABLED:
-        printf("Indications for SC Control point Characteristic are disabled\r\n");
-        rscIndicationState = DISABLED;
+        BINLOG_INFO(BINLOG_EVT_IND_DISABLED);
+        rscConnection.indicationState = DISABLED;
+        rscConnection.indicationInFlight = NO;
+        /* The responses can't be delivered anymore */
+        rscConnection.cpCount = 0u;
 		break;
 
     case CYBLE_EVT_RSCSS_INDICATION_CONFIRMATION:
-        printf("Indication Confirmation for SC Control point was received\r\n");
+        BINLOG_TRACE(BINLOG_EVT_IND_CONFIRMED);
+        rscConnection.indicationInFlight = NO;
 		break;
 	
     case CYBLE_EVT_RSCSS_CHAR_WRITE:
-        
-        wrReqParam = (CYBLE_RSCS_CHAR_VALUE_T *) eventParam;
-        printf("Write to SC Control Point Characteristic occurred\r\n");
-        printf("Data length: %d\r\n", wrReqParam->value->len);
-        printf("Received data:");
 
-        for(i = 0u; i < wrReqParam->value->len; i++)
+    #if (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE)
+        /* Log up to four parameter bytes following the Op Code */
+        param = 0u;
+        for(i = 1u; (i < wrReqParam->value->len) && (i <= sizeof(param)); i++)
         {
-             printf(" %x", wrReqParam->value->val[i]);
+            param |= ((uint32) wrReqParam->value->val[i]) << ((i - 1u) * ONE_BYTE_SHIFT);
         }
-         printf("\r\n");
+        BINLOG_TRACE(BINLOG_EVT_CP_WRITE, wrReqParam->value->len, wrReqParam->value->val[RSC_SC_CP_OP_CODE_IDX], param);
+    #endif /* (DEBUG_MODULE_LEVEL >= DEBUG_LEVEL_TRACE) */
         
-        rcsOpCode = wrReqParam->value->val[RSC_SC_CP_OP_CODE_IDX];
-
-        switch(rcsOpCode)
+        if(rscConnection.cpCount < RSC_CP_QUEUE_SIZE)
         {
-        case CYBLE_RSCS_SET_CUMMULATIVE_VALUE:
-            /* Validate command length */
-            if(wrReqParam->value->len == RSC_SET_CUMMULATIVE_VALUE_LEN)
-            {
-                if(0u != (rscFeature && RSC_FEATURE_INST_STRIDE_PRESENT))
-                {
-                    rscMeasurement.totalDistance = (wrReqParam->value->val[RSC_SC_CUM_VAL_BYTE3_IDX] << THREE_BYTES_SHIFT) |
-                                    (wrReqParam->value->val[RSC_SC_CUM_VAL_BYTE2_IDX] << TWO_BYTES_SHIFT) |
-                                    (wrReqParam->value->val[RSC_SC_CUM_VAL_BYTE1_IDX] << ONE_BYTE_SHIFT) |
-                                    wrReqParam->value->val[RSC_SC_CUM_VAL_BYTE0_IDX];
-
-                    printf("Set cumulative value command was received.\r\n");
-                    rscMeasurement.totalDistance *= RSCS_CM_TO_DM_VALUE;
-                    rcsRespValue = CYBLE_RSCS_ERR_SUCCESS;
-                }
-                else
-                {
-                    printf("The procedure is not supported.\r\n");
-                    rcsRespValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
-                }
-            }
-            else
-            {
-                rcsRespValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
-            }
-            break;
-
-        case CYBLE_RSCS_START_SENSOR_CALIBRATION:
-            printf("Start Sensor calibration command was received.\r\n");
-            rcsRespValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
-            rcsOpCode = CYBLE_RSCS_START_SENSOR_CALIBRATION;
-            break;
+            RSC_CP_RESPONSE_T *resp =
+                &rscConnection.cpQueue[(rscConnection.cpHead + rscConnection.cpCount) % RSC_CP_QUEUE_SIZE];
 
-        case CYBLE_RSCS_UPDATE_SENSOR_LOCATION:
-            /* Validate command length */
-            if(wrReqParam->value->len == RSC_UPDATE_SENSOR_LOCATION_LEN)
-            {
-                if(0u != (rscFeature & RSC_FEATURE_MULTIPLE_SENSOR_LOC_PRESENT))
-                {
-                    printf("Update sensor location command was received.\r\n");
-                    
-                    /* Check if the requested sensor location is supported */
-                    if(YES == IsSensorLocationSupported(wrReqParam->value->val[RSC_SC_SENSOR_LOC_IDX]))
-                    {
-                        printf("New Sensor location was set.\r\n");
-                        /* Set requested sensor location */
-                        CyBle_RscssSetCharacteristicValue(CYBLE_RSCS_SENSOR_LOCATION, 1u, 
-                            &wrReqParam->value->val[RSC_SC_SENSOR_LOC_IDX]);
-                    }
-                    else
-                    {
-                        printf("The requested sensor location is not supported.\r\n");
-                        /* Invalid sensor location is received */
-                        rcsRespValue = CYBLE_RSCS_ERR_INVALID_PARAMETER;
-                    }
-                }
-                else
-                {
-                    printf("The procedure is not supported.\r\n");
-                    rcsRespValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
-                }
-            }
-            else
-            {
-                rcsRespValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
-            }
-            break;
-
-        case CYBLE_RSCS_REQ_SUPPORTED_SENSOR_LOCATION:
-            /* Validate command length */
-            if(wrReqParam->value->len == RSC_REQ_SUPPORTED_SENSOR_LOCATION_LEN)
-            {
-                if(0u != (rscFeature & RSC_FEATURE_MULTIPLE_SENSOR_LOC_PRESENT))
-                {
-                    printf("Supported sensor location command was received.\r\n");
-                    rcsRespValue = CYBLE_RSCS_ERR_SUCCESS;
-                }
-                else
-                {
-                    printf("The procedure is not supported.\r\n");
-                    rcsRespValue = CYBLE_RSCS_ERR_OP_CODE_NOT_SUPPORTED;
-                }
-            }
-            else
-            {
-                rcsRespValue = CYBLE_RSCS_ERR_OPERATION_FAILED;
-            }
-            break;
-
-        default:
-            printf("Unsupported command.\r\n");
-            break;
+            /* Execute the procedure now, the response waits for its turn in main() */
+            resp->opCode = wrReqParam->value->val[RSC_SC_CP_OP_CODE_IDX];
+            resp->respValue = RscExecuteControlPoint(wrReqParam->value);
+            rscConnection.cpCount++;
+        }
+        else
+        {
+            BINLOG_WARN(BINLOG_EVT_CP_QUEUE_FULL, wrReqParam->value->val[RSC_SC_CP_OP_CODE_IDX]);
+            rscCpDropped++;
         }
-
-        /* Set the flag to sent indication from main() */
-        rscIndicationPending = YES;
 		break;
 
     /***************************************
@@ -223,9 +278,11 @@ void RscServiceAppEventHandler(uint32 event, void *eventParam)
         break;
 
 	default:
-        printf("Unrecognised RSCS event.\r\n");
+        BINLOG_WARN(BINLOG_EVT_RSCS_UNKNOWN, event);
 	    break;
     }
+
+    PROFILER_END(PROFILER_RSCS_HANDLER);
 }
 
 
@@ -245,12 +302,12 @@ void RscServiceAppEventHandler(uint32 event, void *eventParam)
 *******************************************************************************/
 void InitProfile(void)
 {
-    uint8 buff[RSC_RSC_MEASUREMENT_CHAR_SIZE];
+    uint8 buff[RSC_CHAR_FLAGS_SIZE];
     
-    if(CyBle_RscssGetCharacteristicValue(CYBLE_RSCS_RSC_MEASUREMENT, RSC_RSC_MEASUREMENT_CHAR_SIZE, buff) !=
+    if(CyBle_RscssGetCharacteristicValue(CYBLE_RSCS_RSC_MEASUREMENT, RSC_CHAR_FLAGS_SIZE, buff) !=
             CYBLE_ERROR_OK)
     {
-        printf("Failed to read the RSC Measurement value.\r\n");
+        LOG_ERROR("Failed to read the RSC Measurement value.\r\n");
     }
 
     /* Set initial RSC Characteristic flags as per values set in the customizer */
@@ -259,9 +316,15 @@ void InitProfile(void)
     /* Get the RSC Feature */
     GetRscFeatureChar(&rscFeature);
 
+    /* Don't announce fields the sensor doesn't support. This also shortens the
+    * notification to 4, 6 or 8 bytes when stride or distance is not supported.
+    */
+    rscMeasurement.flags &= (uint8) ~(RSC_CHAR_FEATURE_FLAGS_MASK & ~rscFeature);
+
     rscMeasurement.instCadence = WALKING_INST_CADENCE_MIN;
     rscMeasurement.instStridelen = WALKING_INST_STRIDE_LENGTH_MIN;
     rscMeasurement.totalDistance = 0u;
+    totalDistanceCm = 0u;
 
     /* Set supported sensor locations */
     rscSensors[RSC_SENSOR1_IDX] = RSC_SENSOR_LOC_IN_SHOE;
@@ -287,12 +350,68 @@ void InitProfile(void)
 *******************************************************************************/
 void SimulateProfile(void)
 {
+    ProcessStride(rscMeasurement.instCadence, rscMeasurement.instStridelen);
+}
+
+
+/*******************************************************************************
+* Function Name: ProcessStride
+********************************************************************************
+*
+* Summary:
+*  Stores the cadence and the stride length of a completed stride and updates
+*  the speed and the total distance values.
+*
+* Parameters:  
+*  cadence: Instantaneous cadence in steps per minute.
+*  strideCm: Instantaneous stride length in centimetres.
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+void ProcessStride(uint8 cadence, uint16 strideCm)
+{
+    rscMeasurement.instCadence = cadence;
+    rscMeasurement.instStridelen = strideCm;
+
     /* Update total distance */
-    rscMeasurement.totalDistance += rscMeasurement.instStridelen;
+    KinAddDistance(&rscMeasurement.totalDistance, &totalDistanceCm, strideCm);
 
     /* Calculate speed in m/s with resolution of 1/256 of second */
-    currSpeed = (((uint16)(2 * rscMeasurement.instCadence * rscMeasurement.instStridelen)) << 8u) /
-                    (RSCS_MIN_TO_SEC_VALUE * RSCS_CM_TO_METER_VALUE);
+    currSpeed = KinSpeed(cadence, strideCm);
+
+    rscMeasurementTicks = SwTimerGetTicks();
+}
+
+
+/*******************************************************************************
+* Function Name: SetProfile
+********************************************************************************
+*
+* Summary:
+*  Switches between the walking and the running profile and updates the
+*  Walking or Running Status flag, if the sensor supports it.
+*
+* Parameters:  
+*  newProfile: WALKING or RUNNING.
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+void SetProfile(uint8 newProfile)
+{
+    profile = newProfile;
+
+    if((RUNNING == newProfile) && (0u != (rscFeature & RSC_FEATURE_WALK_RUN_STATUS_MASK)))
+    {
+        rscMeasurement.flags |= RSC_FEATURE_WALK_RUN_STATUS_MASK;
+    }
+    else
+    {
+        rscMeasurement.flags &= (uint8) ~RSC_FEATURE_WALK_RUN_STATUS_MASK;
+    }
 }
 
 
@@ -328,6 +447,51 @@ uint8 IsSensorLocationSupported(uint8 sensorLocation)
 }
 
 
+/*******************************************************************************
+* Function Name: EncodeRscMeasurement
+********************************************************************************
+*
+* Summary:
+*  Packs the RSC Measurement Characteristic value in the over-the-air format.
+*  Instantaneous Stride Length and Total Distance are written only when the
+*  corresponding bit is set in rscMeasurement.flags, so the resulting length
+*  matches RSC_CHAR_SIZE(flags).
+*
+* Parameters:
+*  buff: Destination buffer of at least RSC_RSC_MEASUREMENT_CHAR_SIZE bytes.
+*
+* Return:
+*  Number of bytes written.
+*
+*******************************************************************************/
+uint8 EncodeRscMeasurement(uint8 * buff)
+{
+    uint8 *ptr = buff;
+    uint8 flags = rscMeasurement.flags;
+
+    *ptr++ = flags;
+    *ptr++ = LO8(currSpeed);
+    *ptr++ = HI8(currSpeed);
+    *ptr++ = rscMeasurement.instCadence;
+
+    if(0u != (flags & RSC_FEATURE_INST_STRIDE_PRESENT))
+    {
+        *ptr++ = LO8(rscMeasurement.instStridelen);
+        *ptr++ = HI8(rscMeasurement.instStridelen);
+    }
+
+    if(0u != (flags & RSC_FEATURE_TOTAL_DISTANCE_PRESENT))
+    {
+        *ptr++ = LO8(LO16(rscMeasurement.totalDistance));
+        *ptr++ = HI8(LO16(rscMeasurement.totalDistance));
+        *ptr++ = LO8(HI16(rscMeasurement.totalDistance));
+        *ptr++ = HI8(HI16(rscMeasurement.totalDistance));
+    }
+
+    return((uint8) (ptr - buff));
+}
+
+
 /*******************************************************************************
 * Function Name: HandleRscNotifications
 ********************************************************************************
@@ -346,91 +510,67 @@ void HandleRscNotifications(void)
 {
     uint8 rcsValue[RSC_RSC_MEASUREMENT_CHAR_SIZE];
     CYBLE_API_RESULT_T apiResult;
-    uint32 totalDistanceDm;
-
-    /* Convert total distance to decimeters per BLE RSCS spec */
-    totalDistanceDm = rscMeasurement.totalDistance / RSCS_CM_TO_DM_VALUE;
-
-    /* Update the characteristic */
-    rcsValue[RSC_CHAR_FLAGS_OFFSET]                    = rscMeasurement.flags;
-    rcsValue[RSC_CHAR_INST_SPEED_OFFSET]               = LO8(currSpeed);
-    rcsValue[RSC_CHAR_INST_SPEED_OFFSET + 1u]          = HI8(currSpeed);
-    rcsValue[RSC_CHAR_INST_CADENCE_OFFSET]             = LO8(rscMeasurement.instCadence);
-    rcsValue[RSC_CHAR_INST_STRIDE_LEN_OFFSET]          = LO8(rscMeasurement.instStridelen);
-    rcsValue[RSC_CHAR_INST_STRIDE_LEN_OFFSET + 1u]     = HI8(rscMeasurement.instStridelen);
-    rcsValue[RSC_CHAR_TOTAL_DISTANCE_OFFSET]           = LO8(LO16(totalDistanceDm));
-    rcsValue[RSC_CHAR_TOTAL_DISTANCE_OFFSET + 1u]      = HI8(LO16(totalDistanceDm));
-    rcsValue[RSC_CHAR_TOTAL_DISTANCE_OFFSET + 2u]      = LO8(HI16(totalDistanceDm));
-    rcsValue[RSC_CHAR_TOTAL_DISTANCE_OFFSET + 3u]      = HI8(HI16(totalDistanceDm));
+    uint8 size;
+
+    PROFILER_START(PROFILER_NOTIFICATIONS);
+
+    /* Pack only the fields announced in the flags */
+    size = EncodeRscMeasurement(rcsValue);
 
     /* Send notification to the peer Client */
-    apiResult = CyBle_RscssSendNotification(connectionHandle, CYBLE_RSCS_RSC_MEASUREMENT, RSC_RSC_MEASUREMENT_CHAR_SIZE, rcsValue);
+    apiResult = CyBle_RscssSendNotification(rscConnection.connHandle, CYBLE_RSCS_RSC_MEASUREMENT,
+        size, rcsValue);
 
     /* Update the debug info if notification is sent */
     if(CYBLE_ERROR_OK == apiResult)
     {
-        printf("Notification is sent! \r\n");
-        printf("Cadence: %d, ", rscMeasurement.instCadence);
-        printf("Speed: %d, ", currSpeed);
-        printf("Stride length: %d, ", rscMeasurement.instStridelen);
-        printf("Total distance: %d, ", LO16(totalDistanceDm));
+        AirLatencyRecord(rscMeasurementTicks);
 
         if(WALKING == profile)
         {
-            printf("Status: Walking \r\n");
+            BINLOG_TRACE(BINLOG_EVT_NTF_SENT_WALKING, rscMeasurement.instCadence, currSpeed,
+                rscMeasurement.instStridelen, rscMeasurement.totalDistance);
         }
         else
         {
-            printf("Status: Running \r\n");
+            BINLOG_TRACE(BINLOG_EVT_NTF_SENT_RUNNING, rscMeasurement.instCadence, currSpeed,
+                rscMeasurement.instStridelen, rscMeasurement.totalDistance);
         }
     }
     else
     {
-        if(CYBLE_ERROR_INVALID_PARAMETER == apiResult)
-        {
-            printf("CyBle_RscssSendNotification() resulted with CYBLE_ERROR_INVALID_PARAMETER\r\n");
-        }
-        else if(CYBLE_ERROR_NTF_DISABLED == apiResult)
-        {
-            printf("CyBle_RscssSendNotification() resulted with CYBLE_ERROR_NTF_DISABLED\r\n");
-        }
-        else
-        {
-            printf("CyBle_RscssSendNotification() resulted with CYBLE_ERROR_INVALID_STATE\r\n");
-        }
+        /* CYBLE_ERROR_INVALID_PARAMETER, CYBLE_ERROR_NTF_DISABLED, CYBLE_ERROR_INVALID_STATE or
+        * CYBLE_ERROR_MEMORY_ALLOCATION_FAILED when the Client didn't acknowledge the earlier ones */
+        BINLOG_ERROR(BINLOG_EVT_NTF_ERROR, apiResult);
+        TxPowerNotificationFailed(apiResult);
     }
+
+    PROFILER_END(PROFILER_NOTIFICATIONS);
 }
 
 
 /*******************************************************************************
-* Function Name: HandleRscIndications
+* Function Name: RscSendIndication
 ********************************************************************************
 *
 * Summary:
-*  Handles SC Control Point indications to the Client device. With this 
-*  indication the Client receives a response for the previously send SC Control
-*  Point Procedure.
-*  
-* Parameters:  
-*  None.
-*
-* Return: 
-*  None
+*  Sends the oldest SC Control Point response in the queue.
 *
 *******************************************************************************/
-void HandleRscIndications(void)
+static void RscSendIndication(void)
 {
     uint8 i;
     uint8 size = RSC_SC_CP_SIZE;
     CYBLE_API_RESULT_T apiResult;
     uint8 buff[RSC_SC_CP_SIZE + RSC_SENSORS_NUMBER];
+    const RSC_CP_RESPONSE_T *resp = &rscConnection.cpQueue[rscConnection.cpHead];
 
     /* Handle the received SC Control Point Op Code */
-    switch(rcsOpCode)
+    switch(resp->opCode)
     {
     case CYBLE_RSCS_REQ_SUPPORTED_SENSOR_LOCATION:
-        buff[RSC_SC_CP_RESP_VAL_IDX] = rcsRespValue;
-        if(rcsRespValue == CYBLE_RSCS_ERR_SUCCESS)
+        buff[RSC_SC_CP_RESP_VAL_IDX] = resp->respValue;
+        if(resp->respValue == CYBLE_RSCS_ERR_SUCCESS)
         {
             for(i = 0u; i < RSC_SENSORS_NUMBER; i++)
             {
@@ -443,7 +583,7 @@ void HandleRscIndications(void)
     case CYBLE_RSCS_START_SENSOR_CALIBRATION:
     case CYBLE_RSCS_SET_CUMMULATIVE_VALUE:
     case CYBLE_RSCS_UPDATE_SENSOR_LOCATION:
-        buff[RSC_SC_CP_RESP_VAL_IDX] = rcsRespValue;
+        buff[RSC_SC_CP_RESP_VAL_IDX] = resp->respValue;
         break;
 
     default:
@@ -452,22 +592,143 @@ void HandleRscIndications(void)
     }
 
     buff[RSC_SC_CP_RESP_OP_CODE_IDX] = CYBLE_RSCS_RESPONSE_CODE;
-    buff[RSC_SC_CP_REQ_OP_CODE_IDX] = rcsOpCode;
+    buff[RSC_SC_CP_REQ_OP_CODE_IDX] = resp->opCode;
 
-    apiResult = CyBle_RscssSendIndication(connectionHandle, CYBLE_RSCS_SC_CONTROL_POINT, size, buff);
+    apiResult = CyBle_RscssSendIndication(rscConnection.connHandle, CYBLE_RSCS_SC_CONTROL_POINT, size, buff);
     
     if(CYBLE_ERROR_OK == apiResult)
     {
-        printf("CyBle_RscssSendIndication() succeeded\r\n");
+        BINLOG_TRACE(BINLOG_EVT_IND_SENT, resp->opCode, buff[RSC_SC_CP_RESP_VAL_IDX]);
+        rscConnection.indicationInFlight = YES;
+        rscConnection.indicationSentTicks = SwTimerGetTicks();
+    }
+    else if((CYBLE_ERROR_INVALID_OPERATION == apiResult) || (CYBLE_ERROR_MEMORY_ALLOCATION_FAILED == apiResult))
+    {
+        /* The stack is busy, try again on the next pass of the main loop */
+        return;
     }
     else
     {
-        printf("CyBle_RscssSendIndication() resulted with an error. Error code: %x\r\n", apiResult);
+        BINLOG_ERROR(BINLOG_EVT_IND_ERROR, apiResult);
     }
-        
-    /* Clear the Op Code and the indication pending flag */
-    rcsOpCode = RSC_SC_CP_INVALID_OP_CODE;
-    rscIndicationPending = NO;
+
+    /* Move on to the next response */
+    rscConnection.cpHead = (rscConnection.cpHead + 1u) % RSC_CP_QUEUE_SIZE;
+    rscConnection.cpCount--;
+}
+
+
+/*******************************************************************************
+* Function Name: HandleRscIndications
+********************************************************************************
+*
+* Summary:
+*  Handles SC Control Point indications to the Client device. With this 
+*  indication the Client receives a response for the previously send SC Control
+*  Point Procedure. Only one indication is outstanding: the next response goes
+*  out after the confirmation of the previous one, or after
+*  RSC_CP_CONFIRM_TIMEOUT_MS without a confirmation.
+*  
+* Parameters:  
+*  None.
+*
+* Return: 
+*  None
+*
+*******************************************************************************/
+void HandleRscIndications(void)
+{
+    PROFILER_START(PROFILER_INDICATIONS);
+
+    if((YES == rscConnection.indicationInFlight) &&
+       ((SwTimerGetTicks() - rscConnection.indicationSentTicks) >= SWTIMER_MS_TO_TICKS(RSC_CP_CONFIRM_TIMEOUT_MS)))
+    {
+        BINLOG_WARN(BINLOG_EVT_IND_TIMEOUT);
+        rscCpTimeouts++;
+        rscConnection.indicationInFlight = NO;
+    }
+
+    if((NO == rscConnection.indicationInFlight) && (ENABLED == rscConnection.indicationState) &&
+       (0u != rscConnection.cpCount))
+    {
+        RscSendIndication();
+    }
+
+    PROFILER_END(PROFILER_INDICATIONS);
+}
+
+
+/*******************************************************************************
+* Function Name: RscOpenConnection
+********************************************************************************
+*
+* Summary:
+*  Starts the state of a new Client. The notifications and indications stay
+*  disabled until the Client writes its CCCDs.
+*
+* Parameters:
+*  connHandle: Handle of the new connection.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RscOpenConnection(CYBLE_CONN_HANDLE_T connHandle)
+{
+    rscConnection.connHandle = connHandle;
+    rscConnection.notificationState = DISABLED;
+    rscConnection.indicationState = DISABLED;
+    rscConnection.cpHead = 0u;
+    rscConnection.cpCount = 0u;
+    rscConnection.indicationInFlight = NO;
+    rscConnection.mtu = CYBLE_GATT_DEFAULT_MTU;
+    rscConnection.transferNotify = DISABLED;
+}
+
+
+/*******************************************************************************
+* Function Name: RscCloseConnection
+********************************************************************************
+*
+* Summary:
+*  Clears the state of the disconnected Client together with its pending
+*  responses.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void RscCloseConnection(void)
+{
+    rscConnection.notificationState = DISABLED;
+    rscConnection.indicationState = DISABLED;
+    rscConnection.cpCount = 0u;
+    rscConnection.indicationInFlight = NO;
+    rscConnection.transferNotify = DISABLED;
+}
+
+
+/*******************************************************************************
+* Function Name: RscIsIndicationOutstanding
+********************************************************************************
+*
+* Summary:
+*  Tells if the Client waits for an SC Control Point response or its
+*  confirmation is still due.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  YES or NO.
+*
+*******************************************************************************/
+uint8 RscIsIndicationOutstanding(void)
+{
+    return(((0u != rscConnection.cpCount) || (YES == rscConnection.indicationInFlight)) ? YES : NO);
 }
 
 
@@ -531,6 +792,11 @@ void UpdatePace(void)
             rscMeasurement.instCadence = RUNNING_INST_CADENCE_MIN;
         }
     }
+
+    rscMeasurementTicks = SwTimerGetTicks();
+
+    BINLOG_TRACE(BINLOG_EVT_PACE_UPDATED, rscMeasurement.instCadence, rscMeasurement.instStridelen,
+        KinPace(KinSpeed(rscMeasurement.instCadence, rscMeasurement.instStridelen)));
 }
 
 
@@ -561,7 +827,7 @@ void GetRscFeatureChar(uint16 * feature)
     }
     else
     {
-        printf("Failed to read the RSC Featute value.\r\n");
+        LOG_ERROR("Failed to read the RSC Featute value.\r\n");
     }
 }
 
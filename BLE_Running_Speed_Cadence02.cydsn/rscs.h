@@ -14,21 +14,6 @@
 *******************************************************************************/
 
 
-/***************************************
-##Data Struct Definition
-***************************************/
-
-/* RSC measurement */
-typedef struct
-{
-    uint8 flags;
-    uint16 instSpeed;
-    uint8 instCadence;
-    uint16 instStridelen;
-    uint32 totalDistance;
-} RSC_RSC_MEASUREMENT_T;
-
-
 /***************************************
 *          Constants
 ***************************************/
@@ -60,11 +45,29 @@ typedef struct
 #define RSC_CHAR_INST_STRIDE_LEN_OFFSET         (4u)
 #define RSC_CHAR_TOTAL_DISTANCE_OFFSET          (6u)
 
+/* RSC Measurement field sizes. Instantaneous Stride Length and Total Distance
+* are only present on the air when the corresponding flag is set, so the
+* packet length follows directly from the flags byte.
+*/
+#define RSC_CHAR_FLAGS_SIZE                     (1u)
+#define RSC_CHAR_MANDATORY_SIZE                 (4u)
+#define RSC_CHAR_INST_STRIDE_LEN_SIZE           (2u)
+#define RSC_CHAR_TOTAL_DISTANCE_SIZE            (4u)
+
+#define RSC_CHAR_SIZE(flags)                    (RSC_CHAR_MANDATORY_SIZE + \
+    ((0u != ((flags) & RSC_FEATURE_INST_STRIDE_PRESENT)) ? RSC_CHAR_INST_STRIDE_LEN_SIZE : 0u) + \
+    ((0u != ((flags) & RSC_FEATURE_TOTAL_DISTANCE_PRESENT)) ? RSC_CHAR_TOTAL_DISTANCE_SIZE : 0u))
+
 #define RSC_FEATURE_INST_STRIDE_PRESENT         (0x01u)
 #define RSC_FEATURE_TOTAL_DISTANCE_PRESENT      (0x02u)
 #define RSC_FEATURE_WALK_RUN_STATUS_MASK        (0x04u)
 #define RSC_FEATURE_MULTIPLE_SENSOR_LOC_PRESENT (0x10u)
 
+/* Measurement flags that share their bit position with an RSC Feature bit */
+#define RSC_CHAR_FEATURE_FLAGS_MASK             (RSC_FEATURE_INST_STRIDE_PRESENT | \
+                                                 RSC_FEATURE_TOTAL_DISTANCE_PRESENT | \
+                                                 RSC_FEATURE_WALK_RUN_STATUS_MASK)
+
 #define RSC_SENSOR_LOC_OTHER                    (0u)
 #define RSC_SENSOR_LOC_TOP_OF_SHOE              (1u)
 #define RSC_SENSOR_LOC_IN_SHOE                  (2u)
@@ -86,11 +89,6 @@ typedef struct
 #define RSC_RSC_FEATURE_SIZE                    (2u)
 #define RSC_SC_CP_SIZE                          (3u)
 
-/* Conversion constants */
-#define RSCS_CM_TO_METER_VALUE                  (100u)
-#define RSCS_CM_TO_DM_VALUE                     (10u)
-#define RSCS_MIN_TO_SEC_VALUE                   (60u)
-
 /* SC Control Point Characteristic indexes */
 #define RSC_SC_CP_OP_CODE_IDX                   (0u)
 #define RSC_SC_CUM_VAL_BYTE0_IDX                (1u)
@@ -114,6 +112,56 @@ typedef struct
 #define RSC_UPDATE_SENSOR_LOCATION_LEN          (2u)
 #define RSC_REQ_SUPPORTED_SENSOR_LOCATION_LEN   (1u)
 
+/* SC Control Point responses a Client can have outstanding */
+#define RSC_CP_QUEUE_SIZE                       (4u)
+/* Give up on a confirmation after the ATT transaction timeout */
+#define RSC_CP_CONFIRM_TIMEOUT_MS               (30000u)
+
+
+/***************************************
+##Data Struct Definition
+***************************************/
+
+/* RSC measurement */
+typedef struct
+{
+    uint8 flags;
+    uint16 instSpeed;
+    uint8 instCadence;
+    uint16 instStridelen;
+    /* Total distance is kept in decimetres, the unit used on the air */
+    uint32 totalDistance;
+} RSC_RSC_MEASUREMENT_T;
+
+/* SC Control Point response waiting to be indicated */
+typedef struct
+{
+    uint8 opCode;
+    uint8 respValue;
+} RSC_CP_RESPONSE_T;
+
+/* State of the connected Client. The PSoC 4 BLE stack supports a single
+* connection, the next Client starts from a cleared block.
+*/
+typedef struct
+{
+    CYBLE_CONN_HANDLE_T connHandle;
+    uint8 notificationState;
+    uint8 indicationState;
+    /* Responses in the order of the writes, sent one indication at a time */
+    RSC_CP_RESPONSE_T cpQueue[RSC_CP_QUEUE_SIZE];
+    uint8 cpHead;
+    uint8 cpCount;
+    /* An indication was sent and waits for the confirmation */
+    uint8 indicationInFlight;
+    uint32 indicationSentTicks;
+    /* ATT MTU agreed in the MTU exchange and the Data notifications of the
+    * session transfer service, see transfer.h
+    */
+    uint16 mtu;
+    uint8 transferNotify;
+} RSC_CONNECTION_T;
+
 
 /***************************************
 *        Function Prototypes
@@ -121,8 +169,14 @@ typedef struct
 void InitProfile(void);
 void UpdatePace(void);
 void SimulateProfile(void);
+void ProcessStride(uint8 cadence, uint16 strideCm);
+void SetProfile(uint8 newProfile);
 void HandleRscNotifications(void);
+uint8 EncodeRscMeasurement(uint8 * buff);
 void HandleRscIndications(void);
+void RscOpenConnection(CYBLE_CONN_HANDLE_T connHandle);
+void RscCloseConnection(void);
+uint8 RscIsIndicationOutstanding(void);
 void GetRscFeatureChar(uint16 * feature);
 uint8 IsSensorLocationSupported(uint8 sensorLocation);
 void RscServiceAppEventHandler(uint32 event, void * eventParam);
@@ -131,15 +185,13 @@ void RscServiceAppEventHandler(uint32 event, void * eventParam);
 /***************************************
 * External data references
 ***************************************/
-extern CYBLE_CONN_HANDLE_T      connectionHandle;
 extern uint8                    profile;
-extern uint8                    rscNotificationState;
-extern uint8                    rscIndicationState;
+extern RSC_CONNECTION_T         rscConnection;
 extern RSC_RSC_MEASUREMENT_T    rscMeasurement;
+extern uint32                   rscMeasurementTicks;
 extern uint16                   rscFeature;
-extern uint8                    rscIndicationPending;
-extern uint8                    rcsOpCode;
-extern uint8                    rcsRespValue;
+extern uint16                   rscCpDropped;
+extern uint16                   rscCpTimeouts;
 extern uint8                    rscSensors[RSC_SENSORS_NUMBER];
 
 
@@ -0,0 +1,370 @@
+/*******************************************************************************
+* File Name: stride.c
+*
+* Version 1.0
+*
+* Description:
+*  This file contains the stride detection pipeline: accelerometer samples in,
+*  cadence and stride length out through ProcessStride(). The work per sample
+*  is a few additions, three multiplications and an integer square root, all
+*  on static state.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "rscs.h"
+#include "kinematics.h"
+#include "stride.h"
+#include "classify.h"
+#include "workout.h"
+
+
+/***************************************
+*        Global Variables
+***************************************/
+STRIDE_INFO_T           strideInfo;
+uint32                  strideCount = 0u;
+
+/* Gravity estimate with STRIDE_DC_SHIFT fraction bits */
+static int32            strideDc;
+
+static int16            strideSmooth[STRIDE_SMOOTH_LEN];
+static int32            strideSmoothSum;
+static uint8            strideSmoothIdx;
+
+static uint8            strideState;
+static int16            stridePeak;
+static uint32           stridePeakSample;
+static int16            stridePeakAvg;
+static int16            strideMax;
+static int16            strideMin;
+
+static uint32           strideSample;
+static uint32           strideLastSample;
+static uint8            strideStopped;
+
+static uint16           strideIntervals[STRIDE_INTERVAL_AVG_LEN];
+static uint16           strideIntervalSum;
+static uint8            strideIntervalIdx;
+static uint8            strideIntervalCount;
+
+
+/*******************************************************************************
+* Function Name: StrideInit
+********************************************************************************
+*
+* Summary:
+*  Resets the pipeline. The first stride is reported on the second impact.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StrideInit(void)
+{
+    uint8 i;
+
+    /* Start from 1 g, the sensor is expected to be at rest */
+    strideDc = ((int32) STRIDE_GRAVITY_MG) << STRIDE_DC_SHIFT;
+    for(i = 0u; i < STRIDE_SMOOTH_LEN; i++)
+    {
+        strideSmooth[i] = 0;
+    }
+    strideSmoothSum = 0;
+    strideSmoothIdx = 0u;
+
+    strideState = STRIDE_STATE_ARMED;
+    stridePeakAvg = STRIDE_MIN_PEAK_MG;
+    strideMax = 0;
+    strideMin = 0;
+
+    strideSample = 0u;
+    strideLastSample = 0u;
+    strideStopped = YES;
+    strideIntervalCount = 0u;
+    strideCount = 0u;
+
+    ClassifyInit();
+}
+
+
+/*******************************************************************************
+* Function Name: StrideReportStride
+********************************************************************************
+*
+* Summary:
+*  Estimates the cadence and the stride length of a completed stride,
+*  classifies the gait and passes them to the profile and to the workout
+*  recorder.
+*
+* Parameters:
+*  interval: Samples since the previous impact.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void StrideReportStride(uint16 interval)
+{
+    uint32 cadence;
+    uint32 peakToPeak;
+    uint32 root;
+    uint16 average = strideIntervalSum >> STRIDE_INTERVAL_AVG_SHIFT;
+    uint16 deviation = (interval > average) ? (interval - average) : (average - interval);
+    uint8 i;
+
+    /* Average the interval over the last STRIDE_INTERVAL_AVG_LEN strides. The
+    * first interval after a stop, or after a change of gait, fills the whole
+    * window so the cadence doesn't lag behind.
+    */
+    if((0u == strideIntervalCount) || (deviation > (average >> STRIDE_GAIT_CHANGE_SHIFT)))
+    {
+        for(i = 0u; i < STRIDE_INTERVAL_AVG_LEN; i++)
+        {
+            strideIntervals[i] = interval;
+        }
+        strideIntervalSum = (uint16) (interval << STRIDE_INTERVAL_AVG_SHIFT);
+        strideIntervalIdx = 0u;
+        strideIntervalCount = 1u;
+    }
+    else
+    {
+        strideIntervalSum -= strideIntervals[strideIntervalIdx];
+        strideIntervalSum += interval;
+        strideIntervals[strideIntervalIdx] = interval;
+        strideIntervalIdx = (strideIntervalIdx + 1u) & (STRIDE_INTERVAL_AVG_LEN - 1u);
+    }
+
+    /* Cadence in steps per minute from the average interval with one
+    * fraction bit, which keeps the dividend within 16 bits up to 273 Hz.
+    */
+    cadence = KinDivide(STRIDE_CADENCE_NUMERATOR << STRIDE_CADENCE_FRAC_BITS,
+        (uint16) ((strideIntervalSum + (1u << (STRIDE_CADENCE_AVG_SHIFT - 1u))) >> STRIDE_CADENCE_AVG_SHIFT));
+    if(cadence > STRIDE_CADENCE_MAX)
+    {
+        cadence = STRIDE_CADENCE_MAX;
+    }
+
+    peakToPeak = (uint32) ((int32) strideMax - strideMin);
+    if(peakToPeak > STRIDE_PEAK_TO_PEAK_MAX)
+    {
+        peakToPeak = STRIDE_PEAK_TO_PEAK_MAX;
+    }
+    root = KinSqrt(KinSqrt(peakToPeak << STRIDE_ROOT4_SCALE_SHIFT));
+
+    strideInfo.interval = interval;
+    strideInfo.peak = (uint16) stridePeak;
+    strideInfo.peakToPeak = (uint16) peakToPeak;
+    strideInfo.cadence = (uint8) cadence;
+    strideInfo.strideCm = (uint16) ((STRIDE_LENGTH_K_Q8 * root) >> STRIDE_LENGTH_SHIFT);
+    strideCount++;
+
+    (void) ClassifyStride(&strideInfo);
+    ProcessStride(strideInfo.cadence, strideInfo.strideCm);
+    WorkoutRecordStride(stridePeakSample, strideInfo.cadence, strideInfo.strideCm);
+}
+
+
+/*******************************************************************************
+* Function Name: StrideProcessSample
+********************************************************************************
+*
+* Summary:
+*  Runs one accelerometer sample through the pipeline:
+*   1. magnitude of the acceleration vector;
+*   2. gravity removal with a first order high-pass;
+*   3. moving average over STRIDE_SMOOTH_LEN samples;
+*   4. impact detection with an adaptive threshold and a refractory period.
+*  After STRIDE_MAX_INTERVAL samples without an impact the cadence and the
+*  speed are reported as zero.
+*
+* Parameters:
+*  sample: Accelerometer sample in mg.
+*
+* Return:
+*  YES if the sample completed a stride, NO otherwise.
+*
+*******************************************************************************/
+uint8 StrideProcessSample(const STRIDE_SAMPLE_T * sample)
+{
+    int32 x = sample->x;
+    int32 y = sample->y;
+    int32 z = sample->z;
+    int32 magnitude;
+    int32 filtered;
+    int16 threshold;
+    uint32 interval;
+    uint32 sinceLast;
+    uint8 stride = NO;
+
+    strideSample++;
+    sinceLast = strideSample - strideLastSample;
+
+    /* The sum of the squares of three 16-bit values fits 32 bits unsigned */
+    magnitude = (int32) KinSqrt((uint32) (x * x) + (uint32) (y * y) + (uint32) (z * z));
+
+    strideDc += magnitude - (strideDc >> STRIDE_DC_SHIFT);
+    filtered = magnitude - (strideDc >> STRIDE_DC_SHIFT);
+    if(filtered > STRIDE_MG_MAX)
+    {
+        filtered = STRIDE_MG_MAX;
+    }
+    else if(filtered < STRIDE_MG_MIN)
+    {
+        filtered = STRIDE_MG_MIN;
+    }
+
+    strideSmoothSum += filtered - strideSmooth[strideSmoothIdx];
+    strideSmooth[strideSmoothIdx] = (int16) filtered;
+    strideSmoothIdx = (strideSmoothIdx + 1u) & (STRIDE_SMOOTH_LEN - 1u);
+    filtered = strideSmoothSum >> STRIDE_SMOOTH_SHIFT;
+
+    if(filtered > strideMax)
+    {
+        strideMax = (int16) filtered;
+    }
+    if(filtered < strideMin)
+    {
+        strideMin = (int16) filtered;
+    }
+
+    /* An overdue impact may be weaker, e.g. when slowing down from running
+    * to walking, so the threshold decays until it is found.
+    */
+    if((0u != strideIntervalCount) &&
+       (sinceLast > (strideIntervalSum >> (STRIDE_INTERVAL_AVG_SHIFT - STRIDE_OVERDUE_SHIFT))) &&
+       (stridePeakAvg > STRIDE_MIN_PEAK_MG))
+    {
+        stridePeakAvg -= stridePeakAvg >> STRIDE_PEAK_DECAY_SHIFT;
+    }
+
+    threshold = (int16) (stridePeakAvg >> 1u);
+    if(threshold < STRIDE_MIN_PEAK_MG)
+    {
+        threshold = STRIDE_MIN_PEAK_MG;
+    }
+
+    switch(strideState)
+    {
+    case STRIDE_STATE_ARMED:
+        if(filtered > threshold)
+        {
+            stridePeak = (int16) filtered;
+            stridePeakSample = strideSample;
+            strideState = STRIDE_STATE_IN_PEAK;
+        }
+        break;
+
+    case STRIDE_STATE_IN_PEAK:
+        if(filtered > stridePeak)
+        {
+            stridePeak = (int16) filtered;
+            stridePeakSample = strideSample;
+        }
+        else if(filtered < threshold)
+        {
+            strideState = STRIDE_STATE_REARM;
+            interval = stridePeakSample - strideLastSample;
+
+            /* The average follows a stronger impact at once, so the weaker
+            * impact of the other foot stays below the threshold when the
+            * gait changes from walking to running.
+            */
+            if(stridePeak > stridePeakAvg)
+            {
+                stridePeakAvg = stridePeak;
+            }
+            else
+            {
+                stridePeakAvg += (int16) ((stridePeak - stridePeakAvg) >> STRIDE_PEAK_AVG_SHIFT);
+            }
+
+            if(YES == strideStopped)
+            {
+                /* First impact, the stride starts here */
+                strideStopped = NO;
+                strideLastSample = stridePeakSample;
+                strideMax = (int16) filtered;
+                strideMin = (int16) filtered;
+            }
+            else if(interval >= STRIDE_MIN_INTERVAL)
+            {
+                StrideReportStride((uint16) interval);
+                strideLastSample = stridePeakSample;
+                strideMax = (int16) filtered;
+                strideMin = (int16) filtered;
+                stride = YES;
+            }
+            else
+            {
+                /* Rebound within the refractory period */
+            }
+        }
+        else
+        {
+            /* Still on the falling edge of the impact */
+        }
+        break;
+
+    default:
+        if(filtered < STRIDE_REARM_MG)
+        {
+            strideState = STRIDE_STATE_ARMED;
+        }
+        break;
+    }
+
+    if((NO == strideStopped) && (sinceLast > STRIDE_MAX_INTERVAL))
+    {
+        strideStopped = YES;
+        strideIntervalCount = 0u;
+        stridePeakAvg = STRIDE_MIN_PEAK_MG;
+        ProcessStride(0u, 0u);
+    }
+
+    return(stride);
+}
+
+
+/*******************************************************************************
+* Function Name: StrideProcessFifo
+********************************************************************************
+*
+* Summary:
+*  Drains the accelerometer FIFO through the pipeline. Called once in
+*  STRIDE_FIFO_PERIOD_MS.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void StrideProcessFifo(void)
+{
+    static STRIDE_SAMPLE_T samples[STRIDE_FIFO_SIZE];
+    uint8 count;
+    uint8 i;
+
+    do
+    {
+        count = StrideSensorRead(samples, STRIDE_FIFO_SIZE);
+        for(i = 0u; i < count; i++)
+        {
+            (void) StrideProcessSample(&samples[i]);
+        }
+    }
+    while(STRIDE_FIFO_SIZE == count);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/*******************************************************************************
+* File Name: stride.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the stride detection
+*  pipeline. Accelerometer samples are read from the sensor FIFO at a fixed
+*  rate, the gravity is removed from the magnitude, the result is smoothed and
+*  the foot impacts are detected with an adaptive threshold. Every impact of
+*  the foot the sensor is mounted on completes a stride.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Accelerometer sample in mg */
+typedef struct
+{
+    int16 x;
+    int16 y;
+    int16 z;
+} STRIDE_SAMPLE_T;
+
+/* Features of the last detected stride */
+typedef struct
+{
+    /* Samples between this impact and the previous one */
+    uint16 interval;
+    /* Impact peak above gravity in mg */
+    uint16 peak;
+    /* Peak-to-peak acceleration over the stride in mg */
+    uint16 peakToPeak;
+    uint8 cadence;
+    uint16 strideCm;
+} STRIDE_INFO_T;
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Accelerometer output data rate, 100 to 200 Hz */
+#if !defined(STRIDE_SAMPLE_RATE_HZ)
+    #define STRIDE_SAMPLE_RATE_HZ           (128u)
+#endif /* !defined(STRIDE_SAMPLE_RATE_HZ) */
+
+#define STRIDE_MS_TO_SAMPLES(ms)            ((uint32) (((uint32) (ms) * STRIDE_SAMPLE_RATE_HZ) / 1000u))
+
+/* The sensor FIFO is drained once in STRIDE_FIFO_PERIOD_MS */
+#define STRIDE_FIFO_PERIOD_MS               (250u)
+#define STRIDE_FIFO_SIZE                    (64u)
+
+/* Range of the filtered signal in mg */
+#define STRIDE_MG_MAX                       (32767)
+#define STRIDE_MG_MIN                       (-32768)
+#define STRIDE_GRAVITY_MG                   (1000)
+
+/* Gravity estimate time constant, 2^7 samples */
+#define STRIDE_DC_SHIFT                     (7u)
+
+/* Moving average over 2^2 samples */
+#define STRIDE_SMOOTH_SHIFT                 (2u)
+#define STRIDE_SMOOTH_LEN                   (1u << STRIDE_SMOOTH_SHIFT)
+
+/* An impact must rise above half of the average peak, and at least above
+* STRIDE_MIN_PEAK_MG, and the signal must drop below gravity before the next
+* one. The impacts of the other foot stay below the threshold.
+*/
+#define STRIDE_MIN_PEAK_MG                  (300)
+#define STRIDE_PEAK_AVG_SHIFT               (2u)
+#define STRIDE_REARM_MG                     (0)
+
+/* Past twice the average interval the average peak decays by 1/2^5 a sample */
+#define STRIDE_OVERDUE_SHIFT                (1u)
+#define STRIDE_PEAK_DECAY_SHIFT             (5u)
+
+/* 150 to 24 strides per minute */
+#define STRIDE_MIN_INTERVAL                 (STRIDE_MS_TO_SAMPLES(400u))
+#define STRIDE_MAX_INTERVAL                 (STRIDE_MS_TO_SAMPLES(2500u))
+
+/* Cadence is averaged over the last 2^2 strides */
+#define STRIDE_INTERVAL_AVG_SHIFT           (2u)
+#define STRIDE_INTERVAL_AVG_LEN             (1u << STRIDE_INTERVAL_AVG_SHIFT)
+
+/* An interval more than 1/2^2 off the average restarts the average */
+#define STRIDE_GAIT_CHANGE_SHIFT            (2u)
+
+/* Two steps per stride: steps/min = 2 * 60 * rate / interval */
+#define STRIDE_CADENCE_NUMERATOR            (2u * 60u * STRIDE_SAMPLE_RATE_HZ)
+#define STRIDE_CADENCE_MAX                  (0xFFu)
+#define STRIDE_CADENCE_FRAC_BITS            (1u)
+#define STRIDE_CADENCE_AVG_SHIFT            (STRIDE_INTERVAL_AVG_SHIFT - STRIDE_CADENCE_FRAC_BITS)
+
+/* Stride length model after Weinberg: K * (peak-to-peak)^(1/4). The fourth
+* root is taken of the value scaled by 2^16, so it has 4 fraction bits, and K
+* has 8.
+*/
+#define STRIDE_LENGTH_K_Q8                  (3379u)
+#define STRIDE_ROOT4_SCALE_SHIFT            (16u)
+#define STRIDE_ROOT4_FRAC_BITS              (4u)
+#define STRIDE_LENGTH_SHIFT                 (8u + STRIDE_ROOT4_FRAC_BITS)
+#define STRIDE_PEAK_TO_PEAK_MAX             (0xFFFFu)
+
+/* Detector states */
+#define STRIDE_STATE_ARMED                  (0u)
+#define STRIDE_STATE_IN_PEAK                (1u)
+#define STRIDE_STATE_REARM                  (2u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void StrideInit(void);
+uint8 StrideProcessSample(const STRIDE_SAMPLE_T * sample);
+void StrideProcessFifo(void);
+
+/* Provided by the accelerometer driver: copies up to maxCount samples out of
+* the sensor FIFO and returns the number copied.
+*/
+uint8 StrideSensorRead(STRIDE_SAMPLE_T * samples, uint8 maxCount);
+
+
+/***************************************
+* External data references
+***************************************/
+extern STRIDE_INFO_T            strideInfo;
+extern uint32                   strideCount;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,412 @@
+/*******************************************************************************
+* File Name: swtimer.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the software timers used by the main loop. The timers
+*  are kept in a list ordered by deadline and are driven by the free-running
+*  WDT counter, so periods are kept in real time regardless of the connection
+*  interval. The WDT match is always programmed to the earliest deadline, so
+*  the device is woken up by the timers only when one of them is due.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "swtimer.h"
+#include "profiler.h"
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef struct
+{
+    uint32 deadline;
+    uint32 period;
+    SWTIMER_CALLBACK_T callback;
+    uint8 next;
+    uint8 active;
+} SWTIMER_T;
+
+
+/***************************************
+*        Global Variables
+***************************************/
+static SWTIMER_T        swTimers[SWTIMER_COUNT];
+static uint8            swTimerHead = SWTIMER_INVALID;
+static uint32           swTimerTicks = 0u;
+static uint16           swTimerLastCount = 0u;
+static volatile uint8   swTimerWakeup = 0u;
+
+
+/*******************************************************************************
+* Function Name: SwTimerIsBefore
+********************************************************************************
+*
+* Summary:
+*  Compares two tick values, taking the 32-bit wrap around into account.
+*
+*******************************************************************************/
+static uint8 SwTimerIsBefore(uint32 a, uint32 b)
+{
+    return((((int32) (a - b)) < 0) ? YES : NO);
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerUnlink
+********************************************************************************
+*
+* Summary:
+*  Removes the timer from the deadline ordered list.
+*
+*******************************************************************************/
+static void SwTimerUnlink(uint8 id)
+{
+    uint8 *link = &swTimerHead;
+
+    while(SWTIMER_INVALID != *link)
+    {
+        if(id == *link)
+        {
+            *link = swTimers[id].next;
+            break;
+        }
+        link = &swTimers[*link].next;
+    }
+    swTimers[id].next = SWTIMER_INVALID;
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerInsert
+********************************************************************************
+*
+* Summary:
+*  Inserts the timer into the list after all timers due earlier or at the same
+*  time.
+*
+*******************************************************************************/
+static void SwTimerInsert(uint8 id)
+{
+    uint8 *link = &swTimerHead;
+
+    while((SWTIMER_INVALID != *link) &&
+          (NO == SwTimerIsBefore(swTimers[id].deadline, swTimers[*link].deadline)))
+    {
+        link = &swTimers[*link].next;
+    }
+    swTimers[id].next = *link;
+    *link = id;
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerArm
+********************************************************************************
+*
+* Summary:
+*  Programs the WDT match to the earliest deadline, but no further than
+*  SWTIMER_MAX_SLEEP_TICKS away. The count is read and the match written
+*  with the interrupts disabled, so an ISR can't eat into the lead. If the
+*  counter still reaches the match before it takes effect, the interrupt
+*  would come only after the wrap around: the main loop runs the timers on
+*  the next pass instead.
+*
+*******************************************************************************/
+static void SwTimerArm(void)
+{
+    uint8 interruptState;
+    uint32 now;
+    uint32 delta = SWTIMER_MAX_SLEEP_TICKS;
+    uint16 elapsed;
+
+    interruptState = CyEnterCriticalSection();
+    now = SwTimerGetTicks();
+
+    if(SWTIMER_INVALID != swTimerHead)
+    {
+        if(YES == SwTimerIsBefore(now, swTimers[swTimerHead].deadline))
+        {
+            delta = swTimers[swTimerHead].deadline - now;
+        }
+        else
+        {
+            delta = 0u;
+        }
+    }
+
+    if(delta > SWTIMER_MAX_SLEEP_TICKS)
+    {
+        delta = SWTIMER_MAX_SLEEP_TICKS;
+    }
+    else if(delta < SWTIMER_MIN_LEAD_TICKS)
+    {
+        delta = SWTIMER_MIN_LEAD_TICKS;
+    }
+    else
+    {
+        /* Deadline is within range */
+    }
+
+    CySysWdtUnlock();
+    CySysWdtWriteMatch(WDT_COUNTER, (swTimerLastCount + delta) & SWTIMER_COUNTER_MASK);
+    CySysWdtLock();
+
+    elapsed = (uint16) ((uint16) CySysWdtGetCount(WDT_COUNTER) - swTimerLastCount);
+    if(((uint32) elapsed + SWTIMER_MIN_LEAD_TICKS) > delta)
+    {
+        swTimerWakeup = 1u;
+    }
+    else
+    {
+        /* The match is ahead of the counter */
+    }
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: WDT_Interrupt
+********************************************************************************
+*
+* Summary:
+*  Handles the Interrupt Service Routine for the WDT timer. The timers
+*  themselves are serviced from the main loop by SwTimerProcess().
+*
+*******************************************************************************/
+CY_ISR(WDT_Interrupt)
+{
+    PROFILER_START(PROFILER_WDT_ISR);
+
+    if(CySysWdtGetInterruptSource() & WDT_INTERRUPT_SOURCE)
+    {
+        /* Indicate that timer is raised to the main loop */
+        swTimerWakeup = 1u;
+
+        /* Clears interrupt request  */
+        CySysWdtClearInterrupt(WDT_INTERRUPT_SOURCE);
+    }
+
+    PROFILER_END(PROFILER_WDT_ISR);
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerInit
+********************************************************************************
+*
+* Summary:
+*  Configures the WDT counter as a free-running time base with an interrupt on
+*  match and stops all software timers.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SwTimerInit(void)
+{
+    uint8 i;
+
+    for(i = 0u; i < SWTIMER_COUNT; i++)
+    {
+        swTimers[i].active = NO;
+        swTimers[i].next = SWTIMER_INVALID;
+    }
+    swTimerHead = SWTIMER_INVALID;
+    swTimerTicks = 0u;
+    swTimerLastCount = 0u;
+
+    /* Unlock the WDT registers for modification */
+    CySysWdtUnlock();
+    /* Setup ISR */
+    WDT_Interrupt_StartEx(&WDT_Interrupt);
+    /* Write the mode to generate interrupt on match */
+    CySysWdtWriteMode(WDT_COUNTER, CY_SYS_WDT_MODE_INT);
+    /* Let the counter run through the whole 16-bit range */
+    CySysWdtWriteClearOnMatch(WDT_COUNTER, 0u);
+    /* Configure the WDT counter match comparison value */
+    CySysWdtWriteMatch(WDT_COUNTER, SWTIMER_MAX_SLEEP_TICKS);
+    /* Reset WDT counter */
+    CySysWdtResetCounters(WDT_COUNTER);
+    /* Enable the specified WDT counter */
+    CySysWdtEnable(WDT_COUNTER_MASK);
+    /* Lock out configuration changes to the Watchdog timer registers */
+    CySysWdtLock();
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerStart
+********************************************************************************
+*
+* Summary:
+*  Starts or restarts a software timer. The callback is called from
+*  SwTimerProcess() once the period has elapsed and then every period.
+*
+* Parameters:
+*  id:       Software timer identifier.
+*  period:   Period in WDT ticks, see SWTIMER_MS_TO_TICKS().
+*  callback: Function called on expiration.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SwTimerStart(uint8 id, uint32 period, SWTIMER_CALLBACK_T callback)
+{
+    if(YES == swTimers[id].active)
+    {
+        SwTimerUnlink(id);
+    }
+
+    swTimers[id].deadline = SwTimerGetTicks() + period;
+    swTimers[id].period = period;
+    swTimers[id].callback = callback;
+    swTimers[id].active = YES;
+    SwTimerInsert(id);
+
+    if(id == swTimerHead)
+    {
+        SwTimerArm();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerStop
+********************************************************************************
+*
+* Summary:
+*  Stops a software timer.
+*
+* Parameters:
+*  id: Software timer identifier.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SwTimerStop(uint8 id)
+{
+    if(YES == swTimers[id].active)
+    {
+        SwTimerUnlink(id);
+        swTimers[id].active = NO;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerIsActive
+********************************************************************************
+*
+* Summary:
+*  Checks whether a software timer is running.
+*
+* Parameters:
+*  id: Software timer identifier.
+*
+* Return:
+*  YES - the timer is running;
+*  NO - the timer is stopped.
+*
+*******************************************************************************/
+uint8 SwTimerIsActive(uint8 id)
+{
+    return(swTimers[id].active);
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerGetTicks
+********************************************************************************
+*
+* Summary:
+*  Extends the 16-bit WDT counter to a 32-bit tick count.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  Ticks of the 32.768 kHz clock since SwTimerInit().
+*
+*******************************************************************************/
+uint32 SwTimerGetTicks(void)
+{
+    uint16 count = (uint16) CySysWdtGetCount(WDT_COUNTER);
+
+    swTimerTicks += (uint16) (count - swTimerLastCount);
+    swTimerLastCount = count;
+
+    return(swTimerTicks);
+}
+
+
+/*******************************************************************************
+* Function Name: SwTimerProcess
+********************************************************************************
+*
+* Summary:
+*  Calls the callbacks of the expired timers and re-arms the WDT for the next
+*  deadline. Returns immediately when the WDT has not fired since the last
+*  call, so it is cheap to call after every wakeup.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void SwTimerProcess(void)
+{
+    uint32 now;
+    uint8 id;
+
+    if(0u != swTimerWakeup)
+    {
+        swTimerWakeup = 0u;
+        now = SwTimerGetTicks();
+
+        while((SWTIMER_INVALID != swTimerHead) && (NO == SwTimerIsBefore(now, swTimers[swTimerHead].deadline)))
+        {
+            id = swTimerHead;
+            SwTimerUnlink(id);
+
+            if(0u != swTimers[id].period)
+            {
+                /* Keep the period phase unless a whole period was missed */
+                swTimers[id].deadline += swTimers[id].period;
+                if(NO == SwTimerIsBefore(now, swTimers[id].deadline))
+                {
+                    swTimers[id].deadline = now + swTimers[id].period;
+                }
+                SwTimerInsert(id);
+            }
+            else
+            {
+                swTimers[id].active = NO;
+            }
+
+            swTimers[id].callback();
+        }
+
+        SwTimerArm();
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,66 @@
+/*******************************************************************************
+* File Name: swtimer.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the software timers that
+*  are driven by the WDT counter.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Software timer identifiers */
+#define SWTIMER_NOTIFICATION                (0u)
+#define SWTIMER_PACE                        (1u)
+#define SWTIMER_PROFILE                     (2u)
+#define SWTIMER_LED                         (3u)
+#define SWTIMER_LOG                         (4u)
+#define SWTIMER_CONN_PARAM                  (5u)
+#define SWTIMER_COUNT                       (6u)
+#define SWTIMER_INVALID                     (0xFFu)
+
+/* The WDT counter is clocked from the 32.768 kHz LFCLK */
+#define SWTIMER_TICKS_PER_SEC               (32768u)
+#define SWTIMER_MS_TO_TICKS(ms)             ((uint32) (((uint32) (ms) * SWTIMER_TICKS_PER_SEC) / 1000u))
+
+/* The hardware counter is 16 bits wide and wraps every two seconds. Waking
+* up at least once a second keeps the extended tick count unambiguous.
+*/
+#define SWTIMER_MAX_SLEEP_TICKS             (SWTIMER_TICKS_PER_SEC)
+
+/* A new match value takes up to three LFCLK cycles to become effective */
+#define SWTIMER_MIN_LEAD_TICKS              (4u)
+
+#define SWTIMER_COUNTER_MASK                (0xFFFFu)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+typedef void (* SWTIMER_CALLBACK_T)(void);
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void SwTimerInit(void);
+void SwTimerStart(uint8 id, uint32 period, SWTIMER_CALLBACK_T callback);
+void SwTimerStop(uint8 id);
+uint8 SwTimerIsActive(uint8 id);
+uint32 SwTimerGetTicks(void);
+void SwTimerProcess(void);
+
+
+/* [] END OF FILE */
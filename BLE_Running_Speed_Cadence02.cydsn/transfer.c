@@ -0,0 +1,401 @@
+/*******************************************************************************
+* File Name: transfer.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the session transfer service: the MTU exchange, the
+*  Control and Data characteristic writes and the stream of the stored
+*  workout pages, sent back to back while the stack has buffers free.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "rscs.h"
+#include "binlog.h"
+#include "odometer.h"
+#include "workout.h"
+#include "transfer.h"
+
+#define DEBUG_MODULE_LEVEL      (MAIN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+#if (SESSION_TRANSFER)
+/***************************************
+*        Global Variables
+***************************************/
+/* Totals of the current or last download */
+uint32                  transferBytes = 0u;
+uint16                  transferNotifications = 0u;
+
+static uint8            transferActive = NO;
+static CYBLE_CONN_HANDLE_T transferConn;
+
+/* Page and position of the next byte of the stream */
+static uint16           transferSequence;
+static uint8            transferPos;
+
+static uint8            transferBuff[TRANSFER_BUFFER_SIZE];
+
+
+/*******************************************************************************
+* Function Name: TransferErrorRsp
+********************************************************************************
+*
+* Summary:
+*  Answers a write request with an error response.
+*
+*******************************************************************************/
+static void TransferErrorRsp(const CYBLE_GATTS_WRITE_REQ_PARAM_T * wrReqParam, uint8 errorCode)
+{
+    CYBLE_GATTS_ERR_PARAM_T errParam;
+
+    errParam.attrHandle = wrReqParam->handleValPair.attrHandle;
+    errParam.opcode = CYBLE_GATT_WRITE_REQ;
+    errParam.errorCode = (CYBLE_GATT_ERR_CODE_T) errorCode;
+    (void) CyBle_GattsErrorRsp(wrReqParam->connHandle, &errParam);
+}
+
+
+/*******************************************************************************
+* Function Name: TransferStart
+********************************************************************************
+*
+* Summary:
+*  Starts the stream at the offset. An offset of a page that was overwritten
+*  starts at the oldest stored page, one beyond the stored pages, e.g. from
+*  before the flash was erased, at the end.
+*
+*******************************************************************************/
+static void TransferStart(CYBLE_CONN_HANDLE_T connHandle, uint32 offset)
+{
+    uint16 next = WorkoutGetSequence();
+    uint16 age;
+
+    transferSequence = (uint16) (offset / CY_FLASH_SIZEOF_ROW);
+    transferPos = (uint8) (offset % CY_FLASH_SIZEOF_ROW);
+
+    age = next - transferSequence;
+    if((int16) age < 0)
+    {
+        transferSequence = next;
+        transferPos = 0u;
+    }
+    else if(age > WORKOUT_ROWS)
+    {
+        transferSequence = next - WORKOUT_ROWS;
+        transferPos = 0u;
+    }
+    else
+    {
+        /* The offset is stored */
+    }
+
+    transferConn = connHandle;
+    transferActive = YES;
+    transferBytes = 0u;
+    transferNotifications = 0u;
+    BINLOG_INFO(BINLOG_EVT_TRANSFER_STARTED, TRANSFER_OFFSET(transferSequence, transferPos),
+        TRANSFER_OFFSET(next, 0u));
+}
+
+
+/*******************************************************************************
+* Function Name: TransferStop
+********************************************************************************
+*
+* Summary:
+*  Ends the stream before its end.
+*
+*******************************************************************************/
+static void TransferStop(void)
+{
+    if(YES == transferActive)
+    {
+        transferActive = NO;
+        BINLOG_INFO(BINLOG_EVT_TRANSFER_STOPPED, TRANSFER_OFFSET(transferSequence, transferPos), transferBytes);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TransferFill
+********************************************************************************
+*
+* Summary:
+*  Copies the stream from the page and position on into the buffer, up to
+*  the size, the end of the stored pages or a page that is missing: the
+*  offsets in a notification are contiguous. Returns the number of bytes and
+*  leaves the page and position after them.
+*
+*******************************************************************************/
+static uint16 TransferFill(uint8 *buff, uint16 size, uint16 *sequence, uint8 *pos)
+{
+    const WORKOUT_PAGE_T *page;
+    uint16 length = 0u;
+    uint16 count;
+
+    while((length < size) && (*sequence != WorkoutGetSequence()))
+    {
+        page = WorkoutFindPage(*sequence);
+        if(NULL == page)
+        {
+            break;
+        }
+
+        count = CY_FLASH_SIZEOF_ROW - *pos;
+        if(count > (size - length))
+        {
+            count = size - length;
+        }
+        memcpy(&buff[length], &((const uint8 *) page)[*pos], count);
+        length += count;
+        *pos += (uint8) count;
+        if(CY_FLASH_SIZEOF_ROW == *pos)
+        {
+            (*sequence)++;
+            *pos = 0u;
+        }
+    }
+    return(length);
+}
+
+
+/*******************************************************************************
+* Function Name: TransferMtuExchanged
+********************************************************************************
+*
+* Summary:
+*  Records the ATT MTU of the connection after the Client's exchange request.
+*  The stack answers with CYBLE_GATT_MTU, the smaller of the two is used.
+*
+* Parameters:
+*  param: The Client's receive MTU.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TransferMtuExchanged(const CYBLE_GATT_XCHG_MTU_PARAM_T * param)
+{
+    rscConnection.mtu = (param->mtu < CYBLE_GATT_MTU) ? param->mtu : CYBLE_GATT_MTU;
+    if(rscConnection.mtu < CYBLE_GATT_DEFAULT_MTU)
+    {
+        rscConnection.mtu = CYBLE_GATT_DEFAULT_MTU;
+    }
+    BINLOG_INFO(BINLOG_EVT_TRANSFER_MTU, param->mtu, rscConnection.mtu);
+}
+
+
+/*******************************************************************************
+* Function Name: TransferWriteRequest
+********************************************************************************
+*
+* Summary:
+*  Handles the writes to the Data CCCD and to the Control characteristic.
+*  Writes to the other attributes are left to the caller.
+*
+* Parameters:
+*  wrReqParam: The write request.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TransferWriteRequest(const CYBLE_GATTS_WRITE_REQ_PARAM_T * wrReqParam)
+{
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValPair = wrReqParam->handleValPair;
+    CYBLE_CONN_HANDLE_T connHandle = wrReqParam->connHandle;
+    const uint8 *val = handleValPair.value.val;
+    uint32 offset;
+
+    if(CYBLE_SESSION_TRANSFER_DATA_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE == handleValPair.attrHandle)
+    {
+        if(TRANSFER_CCCD_LEN != handleValPair.value.len)
+        {
+            TransferErrorRsp(wrReqParam, CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
+        }
+        else
+        {
+            (void) CyBle_GattsWriteAttributeValue(&handleValPair, 0u, &connHandle, CYBLE_GATT_DB_PEER_INITIATED);
+            rscConnection.transferNotify = (0u != (val[0u] & TRANSFER_CCCD_NOTIFICATION)) ? ENABLED : DISABLED;
+            if((DISABLED == rscConnection.transferNotify) && (connHandle.bdHandle == transferConn.bdHandle))
+            {
+                TransferStop();
+            }
+            (void) CyBle_GattsWriteRsp(connHandle);
+        }
+    }
+    else if(CYBLE_SESSION_TRANSFER_CONTROL_CHAR_HANDLE == handleValPair.attrHandle)
+    {
+        if((TRANSFER_START_LEN == handleValPair.value.len) && (TRANSFER_OP_START == val[0u]))
+        {
+            if(ENABLED != rscConnection.transferNotify)
+            {
+                TransferErrorRsp(wrReqParam, CYBLE_GATT_ERR_CCCD_IMPROPERLY_CONFIGURED);
+            }
+            else
+            {
+                offset = (uint32) val[1u] | ((uint32) val[2u] << ONE_BYTE_SHIFT) |
+                         ((uint32) val[3u] << TWO_BYTES_SHIFT) | ((uint32) val[4u] << THREE_BYTES_SHIFT);
+                TransferStart(connHandle, offset);
+                (void) CyBle_GattsWriteRsp(connHandle);
+            }
+        }
+        else if((TRANSFER_STOP_LEN == handleValPair.value.len) && (TRANSFER_OP_STOP == val[0u]))
+        {
+            TransferStop();
+            (void) CyBle_GattsWriteRsp(connHandle);
+        }
+        else if((0u != handleValPair.value.len) &&
+                ((TRANSFER_OP_START == val[0u]) || (TRANSFER_OP_STOP == val[0u])))
+        {
+            TransferErrorRsp(wrReqParam, CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
+        }
+        else
+        {
+            TransferErrorRsp(wrReqParam, TRANSFER_ERR_OP_CODE_NOT_SUPPORTED);
+        }
+    }
+    else
+    {
+        /* Not an attribute of the service */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TransferDisconnected
+********************************************************************************
+*
+* Summary:
+*  Stops the stream to a Client that disconnected. It resumes from the offset
+*  after the last notification it got.
+*
+* Parameters:
+*  bdHandle: Peer device handle of the connection.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TransferDisconnected(uint8 bdHandle)
+{
+    if(bdHandle == transferConn.bdHandle)
+    {
+        TransferStop();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TransferProcess
+********************************************************************************
+*
+* Summary:
+*  Sends the next parts of the stream, each filling a notification of the
+*  connection's MTU, until the stack runs out of buffers. The stack sends
+*  them at the next connection events and the main loop carries on after
+*  the wakeup. Called from the main loop while connected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TransferProcess(void)
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T ntfParam;
+    CYBLE_API_RESULT_T apiResult;
+    uint16 sequence;
+    uint16 length;
+    uint32 offset;
+    uint8 pos;
+
+    if(NO == transferActive)
+    {
+        return;
+    }
+
+    if(ENABLED != rscConnection.transferNotify)
+    {
+        TransferStop();
+        return;
+    }
+
+    while((YES == transferActive) && (CYBLE_STACK_STATE_FREE == CyBle_GattGetBusyStatus()))
+    {
+        /* Start after the pages that are gone */
+        sequence = transferSequence;
+        pos = transferPos;
+        while((sequence != WorkoutGetSequence()) && (NULL == WorkoutFindPage(sequence)))
+        {
+            sequence++;
+            pos = 0u;
+        }
+
+        offset = TRANSFER_OFFSET(sequence, pos);
+        length = TransferFill(&transferBuff[TRANSFER_OFFSET_SIZE],
+            rscConnection.mtu - TRANSFER_NTF_HEADER_SIZE - TRANSFER_OFFSET_SIZE, &sequence, &pos);
+        transferBuff[0u] = LO8(offset);
+        transferBuff[1u] = HI8(offset);
+        transferBuff[2u] = LO8(offset >> TWO_BYTES_SHIFT);
+        transferBuff[3u] = HI8(offset >> TWO_BYTES_SHIFT);
+
+        ntfParam.attrHandle = CYBLE_SESSION_TRANSFER_DATA_CHAR_HANDLE;
+        ntfParam.value.val = transferBuff;
+        ntfParam.value.len = TRANSFER_OFFSET_SIZE + length;
+        apiResult = CyBle_GattsNotification(transferConn, &ntfParam);
+        if(CYBLE_ERROR_OK != apiResult)
+        {
+            /* The Client resumes from the last offset it got */
+            BINLOG_WARN(BINLOG_EVT_TRANSFER_ERROR, apiResult);
+            TransferStop();
+            break;
+        }
+
+        transferSequence = sequence;
+        transferPos = pos;
+        transferBytes += length;
+        transferNotifications++;
+        if(0u == length)
+        {
+            /* The offset alone ends the stream */
+            transferActive = NO;
+            BINLOG_INFO(BINLOG_EVT_TRANSFER_DONE, transferBytes, transferNotifications, offset);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TransferIsActive
+********************************************************************************
+*
+* Summary:
+*  Tells whether a download is in progress.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  YES while the stream is being sent, NO otherwise.
+*
+*******************************************************************************/
+uint8 TransferIsActive(void)
+{
+    return(transferActive);
+}
+#endif /* (SESSION_TRANSFER) */
+
+
+/* [] END OF FILE */
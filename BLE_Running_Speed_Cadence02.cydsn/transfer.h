@@ -0,0 +1,96 @@
+/*******************************************************************************
+* File Name: transfer.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the session transfer
+*  service. A Client downloads the workout pages stored by workout.c as a
+*  stream of notifications on the Data characteristic, each as long as the
+*  ATT MTU allows, instead of the 10 byte RSC Measurement.
+*
+*  The stream is the flash image of the pages in the order they were
+*  written. The stream offset of a byte is the sequence number of its page
+*  times CY_FLASH_SIZEOF_ROW plus its position in the page, so an offset
+*  stays valid across connections and resets. Every notification starts with
+*  the offset of its first byte, 32-bit little-endian; the pages that are no
+*  longer stored are skipped, which the offsets show. A notification with the
+*  offset alone ends the stream and tells where the next download resumes.
+*
+*  Control characteristic, write with response:
+*   TRANSFER_OP_START, offset (uint32) - stream from the offset, 0 for all
+*                                        the pages still stored
+*   TRANSFER_OP_STOP                   - stop the stream
+*
+*  The service is added to the BLE component in the customizer as a custom
+*  service "Session Transfer" with the UUIDs below: the Control
+*  characteristic (Write) and the Data characteristic (Notify) with its
+*  Client Characteristic Configuration descriptor. The component's Maximum
+*  MTU size is set to 512 so the stack answers the MTU exchange with it.
+*  The service is built with SESSION_TRANSFER only; without it the calls
+*  expand to nothing.
+*
+*   Service: 6e3a0001-5d3c-4b0e-9a8c-3f0b2d8e5c71
+*   Control: 6e3a0002-5d3c-4b0e-9a8c-3f0b2d8e5c71
+*   Data:    6e3a0003-5d3c-4b0e-9a8c-3f0b2d8e5c71
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Control characteristic op codes */
+#define TRANSFER_OP_START                   (0x01u)
+#define TRANSFER_OP_STOP                    (0x02u)
+#define TRANSFER_START_LEN                  (5u)
+#define TRANSFER_STOP_LEN                   (1u)
+
+/* Application error of the write response to an unknown op code */
+#define TRANSFER_ERR_OP_CODE_NOT_SUPPORTED  (0x80u)
+
+#define TRANSFER_CCCD_LEN                   (2u)
+#define TRANSFER_CCCD_NOTIFICATION          (0x01u)
+
+/* Notification: the ATT header and the stream offset before the data */
+#define TRANSFER_NTF_HEADER_SIZE            (3u)
+#define TRANSFER_OFFSET_SIZE                (4u)
+#define TRANSFER_BUFFER_SIZE                (CYBLE_GATT_MTU - TRANSFER_NTF_HEADER_SIZE)
+
+#define TRANSFER_OFFSET(sequence, pos)      (((uint32) (sequence) * CY_FLASH_SIZEOF_ROW) + (pos))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+#if (SESSION_TRANSFER)
+void TransferMtuExchanged(const CYBLE_GATT_XCHG_MTU_PARAM_T * param);
+void TransferWriteRequest(const CYBLE_GATTS_WRITE_REQ_PARAM_T * wrReqParam);
+void TransferDisconnected(uint8 bdHandle);
+void TransferProcess(void);
+uint8 TransferIsActive(void);
+#else
+    #define TransferMtuExchanged(param)         do { } while(0)
+    #define TransferWriteRequest(wrReqParam)    do { } while(0)
+    #define TransferDisconnected(bdHandle)      do { } while(0)
+    #define TransferProcess()                   do { } while(0)
+    #define TransferIsActive()                  (0u)
+#endif /* (SESSION_TRANSFER) */
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint32                   transferBytes;
+extern uint16                   transferNotifications;
+
+
+/* [] END OF FILE */
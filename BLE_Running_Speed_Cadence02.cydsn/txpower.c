@@ -0,0 +1,250 @@
+/*******************************************************************************
+* File Name: txpower.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the TX power controller of the connection channels: it
+*  follows the RSSI of the central's packets down to the lowest TX power with
+*  margin and returns to the customizer's TX power when notifications fail.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "binlog.h"
+#include "transfer.h"
+#include "txpower.h"
+
+#define DEBUG_MODULE_LEVEL      (CONN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Output power of the levels in dBm, indexed by CYBLE_BLESS_PWR_LVL_T */
+static const int8 txPowerLevelDbm[CYBLE_LL_PWR_LVL_MAX] =
+{
+    0, -18, -12, -6, -3, -2, -1, 0, 3
+};
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* TX power changes and notifications that failed on a full stack */
+uint16                  txPowerChanges = 0u;
+uint16                  txPowerErrors = 0u;
+
+/* Customizer's level, the level of the connection channels and the margin
+* they are chosen with
+*/
+static uint8            txPowerMax = CYBLE_LL_PWR_LVL_0_DBM;
+static uint8            txPowerLevel = CYBLE_LL_PWR_LVL_0_DBM;
+static int8             txPowerMarginDb = TXPOWER_MARGIN_DB;
+static uint8            txPowerHold;
+
+/* Average RSSI in 1/TXPOWER_RSSI_SCALE dBm */
+static int16            txPowerRssiAvg;
+static uint8            txPowerRssiValid = NO;
+
+
+/*******************************************************************************
+* Function Name: TxPowerSet
+********************************************************************************
+*
+* Summary:
+*  Sets the TX power of the connection channels.
+*
+*******************************************************************************/
+static void TxPowerSet(uint8 level)
+{
+    CYBLE_BLESS_PWR_IN_DB_T power;
+    CYBLE_API_RESULT_T apiResult;
+
+    power.blePwrLevelInDbm = (CYBLE_BLESS_PWR_LVL_T) level;
+    power.bleSsChId = CYBLE_LL_CONN_CH_TYPE;
+    apiResult = CyBle_SetTxPowerLevel(&power);
+    if(CYBLE_ERROR_OK == apiResult)
+    {
+        txPowerLevel = level;
+        txPowerChanges++;
+        BINLOG_INFO(BINLOG_EVT_TXPOWER, txPowerLevelDbm[txPowerMax] - txPowerLevelDbm[txPowerLevel],
+            -(txPowerRssiAvg / TXPOWER_RSSI_SCALE));
+    }
+    else
+    {
+        LOG_ERROR("SetTxPowerLevel API Error: %d \r\n", apiResult);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxPowerConnected
+********************************************************************************
+*
+* Summary:
+*  Starts a connection at the customizer's TX power.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TxPowerConnected(void)
+{
+    CYBLE_BLESS_PWR_IN_DB_T power;
+
+    power.bleSsChId = CYBLE_LL_CONN_CH_TYPE;
+    if(CYBLE_ERROR_OK == CyBle_GetTxPowerLevel(&power))
+    {
+        txPowerMax = (uint8) power.blePwrLevelInDbm;
+    }
+    txPowerLevel = txPowerMax;
+    txPowerMarginDb = TXPOWER_MARGIN_DB;
+    txPowerHold = 0u;
+    txPowerRssiValid = NO;
+}
+
+
+/*******************************************************************************
+* Function Name: TxPowerDisconnected
+********************************************************************************
+*
+* Summary:
+*  Leaves the customizer's TX power to the next connection.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TxPowerDisconnected(void)
+{
+    if(txPowerLevel != txPowerMax)
+    {
+        TxPowerSet(txPowerMax);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxPowerSample
+********************************************************************************
+*
+* Summary:
+*  Takes an RSSI sample and moves the TX power towards the lowest level that
+*  reaches the central with margin: up to it at once after a weak sample,
+*  down one level a sample as the average allows. Called once a
+*  notification period while connected.
+*
+* Parameters:
+*  None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TxPowerSample(void)
+{
+    int8 rssi = CyBle_GetRssi();
+    int16 pathLossDb;
+    uint8 target;
+
+    if((0u == ADAPTIVE_TX_POWER) || (TXPOWER_RSSI_INVALID == rssi))
+    {
+        return;
+    }
+
+    if(NO == txPowerRssiValid)
+    {
+        txPowerRssiAvg = (int16) rssi * TXPOWER_RSSI_SCALE;
+        txPowerRssiValid = YES;
+    }
+    else
+    {
+        txPowerRssiAvg += (int16) rssi - (txPowerRssiAvg / TXPOWER_RSSI_SCALE);
+    }
+    pathLossDb = TXPOWER_PEER_DBM - (txPowerRssiAvg / TXPOWER_RSSI_SCALE);
+
+    /* A weak sample counts at once, the body may have turned */
+    if((TXPOWER_PEER_DBM - (int16) rssi) > pathLossDb)
+    {
+        pathLossDb = TXPOWER_PEER_DBM - (int16) rssi;
+    }
+
+    /* Lowest level the central hears with margin */
+    target = CYBLE_LL_PWR_LVL_NEG_18_DBM;
+    while((target < txPowerMax) &&
+          (((int16) txPowerLevelDbm[target] - pathLossDb) < (TXPOWER_PEER_SENSITIVITY_DBM + txPowerMarginDb)))
+    {
+        target++;
+    }
+
+    if(target > txPowerLevel)
+    {
+        TxPowerSet(target);
+    }
+    else if((target < txPowerLevel) && (0u == txPowerHold))
+    {
+        TxPowerSet(txPowerLevel - 1u);
+    }
+    else
+    {
+        /* At the target, or held after a packet error */
+    }
+
+    if(0u != txPowerHold)
+    {
+        txPowerHold--;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxPowerNotificationFailed
+********************************************************************************
+*
+* Summary:
+*  Returns to the customizer's TX power when a notification found the stack's
+*  buffers full: the central didn't acknowledge the packets sent before. The
+*  session download fills the buffers on purpose and doesn't count.
+*
+* Parameters:
+*  apiResult: The error of the notification API.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void TxPowerNotificationFailed(CYBLE_API_RESULT_T apiResult)
+{
+    if((0u != ADAPTIVE_TX_POWER) && (CYBLE_ERROR_MEMORY_ALLOCATION_FAILED == apiResult) &&
+       (NO == TransferIsActive()))
+    {
+        txPowerErrors++;
+        txPowerHold = TXPOWER_HOLD_SAMPLES;
+        if((txPowerMarginDb + TXPOWER_BACKOFF_DB) <= TXPOWER_MARGIN_MAX_DB)
+        {
+            txPowerMarginDb += TXPOWER_BACKOFF_DB;
+        }
+        BINLOG_WARN(BINLOG_EVT_TXPOWER_ERROR, apiResult, txPowerMarginDb);
+        if(txPowerLevel != txPowerMax)
+        {
+            TxPowerSet(txPowerMax);
+        }
+    }
+}
+
+
+/* [] END OF FILE */
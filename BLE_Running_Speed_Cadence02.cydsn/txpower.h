@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: txpower.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the TX power controller.
+*  With ADAPTIVE_TX_POWER the connection channels start at the customizer's
+*  TX power and step down while the link has margin. A foot pod sits about a
+*  metre from the watch or the phone, where the lowest levels still reach it.
+*
+*  The RSSI of the central's packets is sampled once a notification period,
+*  when the device is awake anyway. Taking the central's TX power as
+*  TXPOWER_PEER_DBM and the link as symmetric, the RSSI gives the path loss,
+*  and the controller picks the lowest level that reaches the central
+*  TXPOWER_MARGIN_DB above its sensitivity. A weak sample raises the power to
+*  that level at once; the average of the samples lowers it by one level a
+*  sample.
+*
+*  The stack has no packet error counters. A notification that finds the
+*  stack's buffers still full of unacknowledged packets is the error signal:
+*  the power goes back to the customizer's level at once, the margin grows by
+*  TXPOWER_BACKOFF_DB and the power is held for TXPOWER_HOLD_SAMPLES.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* Assumed TX power of the central and sensitivity of its receiver */
+#define TXPOWER_PEER_DBM                    (0)
+#define TXPOWER_PEER_SENSITIVITY_DBM        (-90)
+
+/* Room left for fading and the body turning between the pod and the
+* central, and what every packet error adds to it
+*/
+#define TXPOWER_MARGIN_DB                   (20)
+#define TXPOWER_BACKOFF_DB                  (3)
+#define TXPOWER_MARGIN_MAX_DB               (35)
+
+/* Samples at the raised power after a packet error, about a minute */
+#define TXPOWER_HOLD_SAMPLES                (20u)
+
+/* The RSSI average weighs the new sample 1/TXPOWER_RSSI_SCALE */
+#define TXPOWER_RSSI_SCALE                  (4)
+
+/* CyBle_GetRssi() result without a received packet */
+#define TXPOWER_RSSI_INVALID                (127)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void TxPowerConnected(void);
+void TxPowerDisconnected(void);
+void TxPowerSample(void);
+void TxPowerNotificationFailed(CYBLE_API_RESULT_T apiResult);
+
+
+/***************************************
+* External data references
+***************************************/
+extern uint16                   txPowerChanges;
+extern uint16                   txPowerErrors;
+
+
+/* [] END OF FILE */
@@ -0,0 +1,749 @@
+/*******************************************************************************
+* File Name: workout.c
+*
+* Version: 1.0
+*
+* Description:
+*  This file contains the offline workout recorder: the record codec, the
+*  page buffer and the page ring in the flash rows below the odometer.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "common.h"
+#include "swtimer.h"
+#include "binlog.h"
+#include "kinematics.h"
+#include "stride.h"
+#include "odometer.h"
+#include "workout.h"
+
+#define DEBUG_MODULE_LEVEL      (MAIN_DEBUG_LEVEL)
+#include "debug.h"
+
+
+/***************************************
+*          Constants
+***************************************/
+#define WORKOUT_VARINT_MASK                 (0x7Fu)
+#define WORKOUT_VARINT_MORE                 (0x80u)
+#define WORKOUT_VARINT_SHIFT                (7u)
+
+#define WORKOUT_FIELD_MASK(bits)            ((uint32) ((1u << (bits)) - 1u))
+
+/* Change of each field, in the order of the tag bits */
+#define WORKOUT_FIELD_PERIOD                (0u)
+#define WORKOUT_FIELD_CADENCE               (1u)
+#define WORKOUT_FIELD_STRIDE                (2u)
+#define WORKOUT_FIELDS                      (3u)
+
+/* Samples per stride at the cadence, 0 at a cadence of 0 */
+#define WORKOUT_PREDICT_PERIOD(cadence)     ((uint32) KinDivide(STRIDE_CADENCE_NUMERATOR, (cadence)))
+
+
+/***************************************
+*        Global Variables
+***************************************/
+/* Newest workout and the totals of the one recorded now */
+uint16                  workoutId = 0u;
+uint16                  workoutPages = 0u;
+uint16                  workoutWriteErrors = 0u;
+uint32                  workoutStrides = 0u;
+uint32                  workoutBytes = 0u;
+
+static WORKOUT_PAGE_T   workoutPage;
+static WORKOUT_CODEC_T  workoutCodec;
+static uint8            workoutArmed = NO;
+static uint8            workoutActive = NO;
+static uint32           workoutStart;
+static uint32           workoutLastTicks;
+
+/* Rows of the pages, read through WORKOUT_PAGE(). Programming erases the
+* whole flash anyway.
+*/
+const uint8 CY_SECTION(".cy_workout_rows") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+                        workoutRows[WORKOUT_ROWS * CY_FLASH_SIZEOF_ROW] = {0u};
+
+/* Row the next page goes to and its sequence number */
+static uint16           workoutRow = 0u;
+static uint16           workoutSequence = 0u;
+
+
+/*******************************************************************************
+* Function Name: WorkoutZigZag
+********************************************************************************
+*
+* Summary:
+*  Maps a signed change to an unsigned value that is small when the change is
+*  small in either direction: 0, -1, 1, -2 become 0, 1, 2, 3.
+*
+*******************************************************************************/
+static uint32 WorkoutZigZag(int32 value)
+{
+    return((value < 0) ? ((((uint32) -(value + 1)) << 1u) | 1u) : ((uint32) value << 1u));
+}
+
+static int32 WorkoutUnZigZag(uint32 value)
+{
+    return((0u != (value & 1u)) ? (-(int32) (value >> 1u) - 1) : (int32) (value >> 1u));
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutPutVarint
+********************************************************************************
+*
+* Summary:
+*  Stores a value as an LEB128 varint and returns its size.
+*
+*******************************************************************************/
+static uint8 WorkoutPutVarint(uint8 *buff, uint32 value)
+{
+    uint8 size = 0u;
+
+    while(value > WORKOUT_VARINT_MASK)
+    {
+        buff[size++] = (uint8) ((value & WORKOUT_VARINT_MASK) | WORKOUT_VARINT_MORE);
+        value >>= WORKOUT_VARINT_SHIFT;
+    }
+    buff[size++] = (uint8) value;
+    return(size);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutGetVarint
+********************************************************************************
+*
+* Summary:
+*  Reads an LEB128 varint, returns the size read or 0 when it is truncated.
+*
+*******************************************************************************/
+static uint8 WorkoutGetVarint(const uint8 *buff, uint8 size, uint32 *value)
+{
+    uint8 pos = 0u;
+
+    *value = 0u;
+    while((pos < size) && (pos < WORKOUT_VARINT_MAX_SIZE))
+    {
+        *value |= (uint32) (buff[pos] & WORKOUT_VARINT_MASK) << (pos * WORKOUT_VARINT_SHIFT);
+        if(0u == (buff[pos++] & WORKOUT_VARINT_MORE))
+        {
+            return(pos);
+        }
+    }
+    return(0u);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutPack
+********************************************************************************
+*
+* Summary:
+*  Packs the three changes into bit fields of the given widths, returns NO
+*  when one doesn't fit.
+*
+*******************************************************************************/
+static uint8 WorkoutPack(const uint32 *delta, uint8 periodBits, uint8 cadenceBits, uint8 strideBits,
+    uint32 *bits)
+{
+    if((delta[WORKOUT_FIELD_PERIOD] > WORKOUT_FIELD_MASK(periodBits)) ||
+       (delta[WORKOUT_FIELD_CADENCE] > WORKOUT_FIELD_MASK(cadenceBits)) ||
+       (delta[WORKOUT_FIELD_STRIDE] > WORKOUT_FIELD_MASK(strideBits)))
+    {
+        return(NO);
+    }
+    *bits = delta[WORKOUT_FIELD_PERIOD] | (delta[WORKOUT_FIELD_CADENCE] << periodBits) |
+        (delta[WORKOUT_FIELD_STRIDE] << (periodBits + cadenceBits));
+    return(YES);
+}
+
+static void WorkoutUnpack(uint32 bits, uint8 periodBits, uint8 cadenceBits, uint8 strideBits, uint32 *delta)
+{
+    delta[WORKOUT_FIELD_PERIOD] = bits & WORKOUT_FIELD_MASK(periodBits);
+    delta[WORKOUT_FIELD_CADENCE] = (bits >> periodBits) & WORKOUT_FIELD_MASK(cadenceBits);
+    delta[WORKOUT_FIELD_STRIDE] = (bits >> (periodBits + cadenceBits)) & WORKOUT_FIELD_MASK(strideBits);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutCodecReset
+********************************************************************************
+*
+* Summary:
+*  Starts the codec state of a page.
+*
+* Parameters:
+*  codec: Codec state.
+*  time: The page time from the page header.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutCodecReset(WORKOUT_CODEC_T *codec, uint32 time)
+{
+    codec->time = time;
+    codec->cadence = 0u;
+    codec->strideCm = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutEncodeRecord
+********************************************************************************
+*
+* Summary:
+*  Encodes a stride against the previous one and moves the codec state on.
+*  The stride period is predicted from the cadence, which the pipeline
+*  averages over the last strides, so only the jitter is stored.
+*
+* Parameters:
+*  codec: Codec state.
+*  stride: The stride, not earlier than the previous one.
+*  buff: Receives up to WORKOUT_RECORD_MAX_SIZE bytes.
+*
+* Return:
+*  The size of the record in bytes.
+*
+*******************************************************************************/
+uint8 WorkoutEncodeRecord(WORKOUT_CODEC_T *codec, const WORKOUT_STRIDE_T *stride, uint8 *buff)
+{
+    uint32 period = stride->time - codec->time;
+    uint32 delta[WORKOUT_FIELDS];
+    uint32 bits;
+    uint8 size = 1u;
+    uint8 i;
+
+    delta[WORKOUT_FIELD_PERIOD] = WorkoutZigZag((int32) (period - WORKOUT_PREDICT_PERIOD(stride->cadence)));
+    delta[WORKOUT_FIELD_CADENCE] = WorkoutZigZag((int32) stride->cadence - (int32) codec->cadence);
+    delta[WORKOUT_FIELD_STRIDE] = WorkoutZigZag((int32) stride->strideCm - (int32) codec->strideCm);
+
+    codec->time = stride->time;
+    codec->cadence = stride->cadence;
+    codec->strideCm = stride->strideCm;
+
+    if(YES == WorkoutPack(delta, WORKOUT_COMPACT_PERIOD_BITS, WORKOUT_COMPACT_CADENCE_BITS,
+                          WORKOUT_COMPACT_STRIDE_BITS, &bits))
+    {
+        buff[0u] = (uint8) (WORKOUT_COMPACT_FLAG | bits);
+    }
+    else if(YES == WorkoutPack(delta, WORKOUT_MEDIUM_PERIOD_BITS, WORKOUT_MEDIUM_CADENCE_BITS,
+                               WORKOUT_MEDIUM_STRIDE_BITS, &bits))
+    {
+        buff[0u] = (uint8) (WORKOUT_MEDIUM_FLAG | (bits >> ONE_BYTE_SHIFT));
+        buff[1u] = (uint8) bits;
+        size = WORKOUT_MEDIUM_SIZE;
+    }
+    else
+    {
+        buff[0u] = 0u;
+        for(i = 0u; i < WORKOUT_FIELDS; i++)
+        {
+            if(0u != delta[i])
+            {
+                buff[0u] |= (uint8) (1u << i);
+                size += WorkoutPutVarint(&buff[size], delta[i]);
+            }
+        }
+    }
+    return(size);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutDecodeRecord
+********************************************************************************
+*
+* Summary:
+*  Decodes the next record of a page and moves the codec state on.
+*
+* Parameters:
+*  codec: Codec state.
+*  buff: The record.
+*  size: Bytes left in the page payload.
+*  stride: Receives the stride.
+*
+* Return:
+*  The size of the record in bytes, 0 when the record is malformed.
+*
+*******************************************************************************/
+uint8 WorkoutDecodeRecord(WORKOUT_CODEC_T *codec, const uint8 *buff, uint8 size, WORKOUT_STRIDE_T *stride)
+{
+    uint32 delta[WORKOUT_FIELDS] = {0u, 0u, 0u};
+    uint8 pos = 1u;
+    uint8 len;
+    uint8 i;
+
+    if(0u == size)
+    {
+        return(0u);
+    }
+
+    if(0u != (buff[0u] & WORKOUT_COMPACT_FLAG))
+    {
+        WorkoutUnpack(buff[0u], WORKOUT_COMPACT_PERIOD_BITS, WORKOUT_COMPACT_CADENCE_BITS,
+                      WORKOUT_COMPACT_STRIDE_BITS, delta);
+    }
+    else if(0u != (buff[0u] & WORKOUT_MEDIUM_FLAG))
+    {
+        if(size < WORKOUT_MEDIUM_SIZE)
+        {
+            return(0u);
+        }
+        WorkoutUnpack(((uint32) (buff[0u] & (uint8) ~WORKOUT_MEDIUM_FLAG) << ONE_BYTE_SHIFT) | buff[1u],
+                      WORKOUT_MEDIUM_PERIOD_BITS, WORKOUT_MEDIUM_CADENCE_BITS, WORKOUT_MEDIUM_STRIDE_BITS, delta);
+        pos = WORKOUT_MEDIUM_SIZE;
+    }
+    else if(0u == (buff[0u] & (uint8) ~WORKOUT_TAG_MASK))
+    {
+        for(i = 0u; i < WORKOUT_FIELDS; i++)
+        {
+            if(0u != (buff[0u] & (1u << i)))
+            {
+                len = WorkoutGetVarint(&buff[pos], size - pos, &delta[i]);
+                if(0u == len)
+                {
+                    return(0u);
+                }
+                pos += len;
+            }
+        }
+    }
+    else
+    {
+        return(0u);
+    }
+
+    codec->cadence += (uint8) WorkoutUnZigZag(delta[WORKOUT_FIELD_CADENCE]);
+    codec->strideCm += (uint16) WorkoutUnZigZag(delta[WORKOUT_FIELD_STRIDE]);
+    codec->time += WORKOUT_PREDICT_PERIOD(codec->cadence) + (uint32) WorkoutUnZigZag(delta[WORKOUT_FIELD_PERIOD]);
+
+    stride->time = codec->time;
+    stride->cadence = codec->cadence;
+    stride->strideCm = codec->strideCm;
+    return(pos);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutCrcByte
+********************************************************************************
+*
+* Summary:
+*  Moves a CRC-16/CCITT on by one byte.
+*
+*******************************************************************************/
+static uint16 WorkoutCrcByte(uint16 crc, uint8 data)
+{
+    uint8 bit;
+
+    crc ^= (uint16) ((uint16) data << ONE_BYTE_SHIFT);
+    for(bit = 0u; bit < ONE_BYTE_SHIFT; bit++)
+    {
+        crc = (0u != (crc & WORKOUT_CRC_MSB)) ? (uint16) ((crc << 1u) ^ WORKOUT_CRC_POLY) : (uint16) (crc << 1u);
+    }
+    return(crc);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutPageCheck
+********************************************************************************
+*
+* Summary:
+*  Computes the check of a page: the length, the header after the check and
+*  the records.
+*
+*******************************************************************************/
+static uint16 WorkoutPageCheck(const WORKOUT_PAGE_T *page)
+{
+    const uint8 *data = (const uint8 *) page;
+    uint16 crc = WorkoutCrcByte(WORKOUT_CRC_INIT, page->header.length);
+    uint8 i;
+
+    for(i = (uint8) offsetof(WORKOUT_PAGE_HEADER_T, sequence);
+        i < (sizeof(WORKOUT_PAGE_HEADER_T) + page->header.length); i++)
+    {
+        crc = WorkoutCrcByte(crc, data[i]);
+    }
+    return(crc);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutPageIsValid
+********************************************************************************
+*
+* Summary:
+*  Checks a page read from the flash. Erased rows, rows of an interrupted
+*  write and rows of another application fail the check.
+*
+* Parameters:
+*  page: The page.
+*
+* Return:
+*  YES if the page is valid, NO otherwise.
+*
+*******************************************************************************/
+uint8 WorkoutPageIsValid(const WORKOUT_PAGE_T *page)
+{
+    return(((WORKOUT_PAGE_MAGIC == page->header.magic) && (0u != page->header.length) &&
+            (page->header.length <= WORKOUT_PAYLOAD_SIZE) &&
+            (page->header.check == WorkoutPageCheck(page))) ? YES : NO);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutInit
+********************************************************************************
+*
+* Summary:
+*  Finds the newest page: the valid page that the next row doesn't carry on
+*  from. The next page goes to the row after it.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutInit(void)
+{
+    const WORKOUT_PAGE_T *page;
+    const WORKOUT_PAGE_T *next;
+    uint16 newest = WORKOUT_NO_ROW;
+    uint16 row;
+
+    for(row = 0u; row < WORKOUT_ROWS; row++)
+    {
+        page = WORKOUT_PAGE(row);
+        next = WORKOUT_PAGE((row + 1u) % WORKOUT_ROWS);
+        if((YES == WorkoutPageIsValid(page)) &&
+           ((NO == WorkoutPageIsValid(next)) ||
+            (next->header.sequence != (uint16) (page->header.sequence + 1u))))
+        {
+            /* A ring that wrapped cleanly has one such page. After a torn
+            * write the one with the highest sequence wins.
+            */
+            if((WORKOUT_NO_ROW == newest) ||
+               ((int16) (page->header.sequence - WORKOUT_PAGE(newest)->header.sequence) > 0))
+            {
+                newest = row;
+            }
+        }
+    }
+
+    workoutArmed = NO;
+    workoutActive = NO;
+    if(WORKOUT_NO_ROW == newest)
+    {
+        workoutRow = 0u;
+        workoutSequence = 0u;
+        workoutId = 0u;
+    }
+    else
+    {
+        page = WORKOUT_PAGE(newest);
+        workoutRow = (newest + 1u) % WORKOUT_ROWS;
+        workoutSequence = page->header.sequence + 1u;
+        workoutId = page->header.workout;
+    }
+    BINLOG_INFO(BINLOG_EVT_WORKOUT_RESTORED, workoutId, workoutRow);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutStartPage
+********************************************************************************
+*
+* Summary:
+*  Empties the page buffer for records from the given time on.
+*
+*******************************************************************************/
+static void WorkoutStartPage(uint32 time)
+{
+    memset(&workoutPage, 0, sizeof(workoutPage));
+    workoutPage.header.magic = WORKOUT_PAGE_MAGIC;
+    workoutPage.header.workout = workoutId;
+    workoutPage.header.time = time;
+    WorkoutCodecReset(&workoutCodec, time);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutWritePage
+********************************************************************************
+*
+* Summary:
+*  Writes the page buffer to the next row of the ring. The CPU is stalled
+*  while the row is erased and programmed.
+*
+*******************************************************************************/
+static void WorkoutWritePage(void)
+{
+    uint32 result;
+
+    workoutPage.header.sequence = workoutSequence;
+    workoutPage.header.check = WorkoutPageCheck(&workoutPage);
+
+    result = CySysFlashWriteRow(WORKOUT_FIRST_ROW + workoutRow, (const uint8 *) &workoutPage);
+    if(CY_SYS_FLASH_SUCCESS == result)
+    {
+        workoutPages++;
+    }
+    else
+    {
+        /* The page is lost, the next one goes to the row after */
+        workoutWriteErrors++;
+        BINLOG_ERROR(BINLOG_EVT_WORKOUT_ERROR, result);
+    }
+
+    workoutBytes += sizeof(WORKOUT_PAGE_HEADER_T) + workoutPage.header.length;
+    workoutSequence++;
+    workoutRow = (workoutRow + 1u) % WORKOUT_ROWS;
+    workoutPage.header.length = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutArm
+********************************************************************************
+*
+* Summary:
+*  Enables the recording while no Client is connected. A workout that is
+*  recorded when the recording is disabled is stored by WorkoutProcess().
+*
+* Parameters:
+*  armed: YES to record the strides, NO to stop.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutArm(uint8 armed)
+{
+    workoutArmed = armed;
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutRecordStride
+********************************************************************************
+*
+* Summary:
+*  Appends a stride to the page buffer. The first stride starts a workout; a
+*  stride that doesn't fit the page writes the page to the flash and starts
+*  the next one.
+*
+* Parameters:
+*  time: Time of the impact in samples of STRIDE_SAMPLE_RATE_HZ.
+*  cadence: Cadence in steps per minute.
+*  strideCm: Stride length in centimetres.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutRecordStride(uint32 time, uint8 cadence, uint16 strideCm)
+{
+    uint8 record[WORKOUT_RECORD_MAX_SIZE];
+    WORKOUT_STRIDE_T stride;
+    uint8 size;
+
+    if(NO == workoutArmed)
+    {
+        return;
+    }
+
+    if(NO == workoutActive)
+    {
+        workoutActive = YES;
+        workoutId++;
+        workoutStart = time;
+        workoutPages = 0u;
+        workoutStrides = 0u;
+        workoutBytes = 0u;
+        BINLOG_INFO(BINLOG_EVT_WORKOUT_STARTED, workoutId, workoutRow);
+    }
+
+    stride.time = time - workoutStart;
+    stride.cadence = cadence;
+    stride.strideCm = strideCm;
+
+    if(0u != workoutPage.header.length)
+    {
+        size = WorkoutEncodeRecord(&workoutCodec, &stride, record);
+        if((workoutPage.header.length + size) > WORKOUT_PAYLOAD_SIZE)
+        {
+            WorkoutWritePage();
+        }
+    }
+    if(0u == workoutPage.header.length)
+    {
+        /* The first record of a page is encoded against the header time */
+        WorkoutStartPage(stride.time);
+        size = WorkoutEncodeRecord(&workoutCodec, &stride, record);
+    }
+
+    memcpy(&workoutPage.payload[workoutPage.header.length], record, size);
+    workoutPage.header.length += size;
+    workoutStrides++;
+    workoutLastTicks = SwTimerGetTicks();
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutStop
+********************************************************************************
+*
+* Summary:
+*  Ends the workout and writes the partly filled page.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutStop(void)
+{
+    if(NO == workoutActive)
+    {
+        return;
+    }
+
+    if(0u != workoutPage.header.length)
+    {
+        WorkoutWritePage();
+    }
+    workoutActive = NO;
+    BINLOG_INFO(BINLOG_EVT_WORKOUT_STORED, workoutId, workoutStrides, workoutBytes, workoutPages);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutProcess
+********************************************************************************
+*
+* Summary:
+*  Ends the workout after WORKOUT_IDLE_MS without a stride, or once a Client
+*  connected. During a connection the last page is written only while the
+*  radio is idle, like the odometer rows.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void WorkoutProcess(void)
+{
+    CYBLE_BLESS_STATE_T blessState;
+
+    if((NO == workoutActive) ||
+       ((YES == workoutArmed) && ((SwTimerGetTicks() - workoutLastTicks) < SWTIMER_MS_TO_TICKS(WORKOUT_IDLE_MS))))
+    {
+        return;
+    }
+
+    if(CYBLE_STATE_CONNECTED == CyBle_GetState())
+    {
+        blessState = CyBle_GetBleSsState();
+        if((CYBLE_BLESS_STATE_EVENT_CLOSE != blessState) && (CYBLE_BLESS_STATE_ECO_ON != blessState) &&
+           (CYBLE_BLESS_STATE_DEEPSLEEP != blessState))
+        {
+            return;
+        }
+    }
+
+    WorkoutStop();
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutIsActive
+********************************************************************************
+*
+* Summary:
+*  Tells whether a workout is being recorded.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  YES while a workout is being recorded, NO otherwise.
+*
+*******************************************************************************/
+uint8 WorkoutIsActive(void)
+{
+    return(workoutActive);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutGetSequence
+********************************************************************************
+*
+* Summary:
+*  Tells the sequence number of the next page. The pages in the flash have
+*  the WORKOUT_ROWS numbers below it.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Sequence number the next page is written with.
+*
+*******************************************************************************/
+uint16 WorkoutGetSequence(void)
+{
+    return(workoutSequence);
+}
+
+
+/*******************************************************************************
+* Function Name: WorkoutFindPage
+********************************************************************************
+*
+* Summary:
+*  Finds a stored page by its sequence number. The pages are written to the
+*  rows in the order of their numbers, so the row follows from the distance
+*  to the next page.
+*
+* Parameters:
+*  sequence: Sequence number of the page.
+*
+* Return:
+*  The page in the flash, or NULL if it was overwritten, never written or
+*  fails the check.
+*
+*******************************************************************************/
+const WORKOUT_PAGE_T * WorkoutFindPage(uint16 sequence)
+{
+    const WORKOUT_PAGE_T *page = NULL;
+    uint16 age = workoutSequence - sequence;
+
+    if((0u != age) && (age <= WORKOUT_ROWS))
+    {
+        page = WORKOUT_PAGE((workoutRow + WORKOUT_ROWS - age) % WORKOUT_ROWS);
+        if((NO == WorkoutPageIsValid(page)) || (sequence != page->header.sequence))
+        {
+            page = NULL;
+        }
+    }
+    return(page);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,171 @@
+/*******************************************************************************
+* File Name: workout.h
+*
+* Version 1.0
+*
+* Description:
+*  Contains the function prototypes and constants of the offline workout
+*  recorder. While no Client is connected, every stride of the accelerometer
+*  pipeline is appended to a page buffer in RAM as a delta encoded record:
+*  time, cadence and stride length. A full page is written to the next of
+*  WORKOUT_ROWS flash rows in one row write, so an append takes constant time.
+*  The rows are used as a ring; the oldest pages are overwritten first.
+*
+*  A record holds the change of the cadence and of the stride length against
+*  the previous record, and how far the stride period is off the period
+*  the cadence gives. Small changes fit the single compact byte and most
+*  others the two byte medium record; the rest are stored as zigzag LEB128
+*  varints after a tag byte. Every page starts from the time in its header,
+*  so each page decodes on its own.
+*
+********************************************************************************
+* Copyright 2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <project.h>
+
+
+/***************************************
+*          Constants
+***************************************/
+
+/* The ring holds the longest workout whole, a marathon race of strides of
+* WORKOUT_STRIDE_MIN_CM or longer, at WORKOUT_STRIDE_BYTES_X100 / 100 flash
+* bytes per stride with the page headers. make workout-bench measures about
+* 1.46 and records a marathon of the synthetic traces.
+*/
+#define WORKOUT_MARATHON_M                  (42195u)
+#define WORKOUT_STRIDE_MIN_CM               (100u)
+#define WORKOUT_STRIDE_BYTES_X100           (150u)
+#define WORKOUT_CAPACITY_STRIDES            ((WORKOUT_MARATHON_M * 100u) / WORKOUT_STRIDE_MIN_CM)
+#define WORKOUT_ROWS                        ((((WORKOUT_CAPACITY_STRIDES * WORKOUT_STRIDE_BYTES_X100) / 100u) + \
+                                              CY_FLASH_SIZEOF_ROW - 1u) / CY_FLASH_SIZEOF_ROW)
+
+/* The pages take the rows below the odometer, include odometer.h first.
+* workoutRows reserves them in the flash image: the linker options of the
+* project place its section at WORKOUT_FIRST_ROW, 0x10480 with 495 rows, and
+* the link fails when the application grows into it.
+*/
+#define WORKOUT_FIRST_ROW                   (ODOMETER_FIRST_ROW - WORKOUT_ROWS)
+
+#define WORKOUT_PAGE_MAGIC                  (0xA7u)
+#define WORKOUT_NO_ROW                      (0xFFFFu)
+
+/* A workout ends after WORKOUT_IDLE_MS without a stride */
+#define WORKOUT_IDLE_MS                     (120000u)
+
+/* Compact record: WORKOUT_COMPACT_FLAG and the zigzag encoded changes of the
+* period, the cadence and the stride length in bit fields of the widths
+* below, from bit 0 up. The medium record is two bytes, big-endian, with
+* WORKOUT_MEDIUM_FLAG in the first one.
+*/
+#define WORKOUT_COMPACT_FLAG                (0x80u)
+#define WORKOUT_COMPACT_PERIOD_BITS         (3u)
+#define WORKOUT_COMPACT_CADENCE_BITS        (2u)
+#define WORKOUT_COMPACT_STRIDE_BITS         (2u)
+
+#define WORKOUT_MEDIUM_FLAG                 (0x40u)
+#define WORKOUT_MEDIUM_SIZE                 (2u)
+#define WORKOUT_MEDIUM_PERIOD_BITS          (6u)
+#define WORKOUT_MEDIUM_CADENCE_BITS         (4u)
+#define WORKOUT_MEDIUM_STRIDE_BITS          (4u)
+
+/* Long record: a tag byte with a bit for each of the changes that follow as
+* a varint. The changes that are zero are left out.
+*/
+#define WORKOUT_TAG_PERIOD                  (0x01u)
+#define WORKOUT_TAG_CADENCE                 (0x02u)
+#define WORKOUT_TAG_STRIDE                  (0x04u)
+#define WORKOUT_TAG_MASK                    (0x07u)
+
+#define WORKOUT_CRC_INIT                    (0xFFFFu)
+#define WORKOUT_CRC_POLY                    (0x1021u)
+#define WORKOUT_CRC_MSB                     (0x8000u)
+
+#define WORKOUT_VARINT_MAX_SIZE             (5u)
+#define WORKOUT_RECORD_MAX_SIZE             (1u + (3u * WORKOUT_VARINT_MAX_SIZE))
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* One stride as recorded */
+typedef struct
+{
+    /* Time of the impact since the start of the workout, in samples of
+    * STRIDE_SAMPLE_RATE_HZ
+    */
+    uint32 time;
+    uint8 cadence;
+    uint16 strideCm;
+} WORKOUT_STRIDE_T;
+
+/* The previous record that the next one is encoded against */
+typedef struct
+{
+    uint32 time;
+    uint8 cadence;
+    uint16 strideCm;
+} WORKOUT_CODEC_T;
+
+typedef struct
+{
+    uint8 magic;
+    /* Payload bytes taken by the records */
+    uint8 length;
+    /* CRC-16/CCITT of the rest of the header and of the payload */
+    uint16 check;
+    /* One up for every page written, it finds the newest page at startup */
+    uint16 sequence;
+    uint16 workout;
+    /* The records are encoded against this time */
+    uint32 time;
+} WORKOUT_PAGE_HEADER_T;
+
+#define WORKOUT_PAYLOAD_SIZE                (CY_FLASH_SIZEOF_ROW - sizeof(WORKOUT_PAGE_HEADER_T))
+
+/* Flash row image */
+typedef struct
+{
+    WORKOUT_PAGE_HEADER_T header;
+    uint8 payload[WORKOUT_PAYLOAD_SIZE];
+} WORKOUT_PAGE_T;
+
+#define WORKOUT_PAGE(row)                   ((const WORKOUT_PAGE_T *) (CY_FLASH_BASE + \
+                                             ((uint32) (WORKOUT_FIRST_ROW + (row)) * CY_FLASH_SIZEOF_ROW)))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+void WorkoutInit(void);
+void WorkoutArm(uint8 armed);
+void WorkoutRecordStride(uint32 time, uint8 cadence, uint16 strideCm);
+void WorkoutProcess(void);
+void WorkoutStop(void);
+uint8 WorkoutIsActive(void);
+uint16 WorkoutGetSequence(void);
+const WORKOUT_PAGE_T * WorkoutFindPage(uint16 sequence);
+
+void WorkoutCodecReset(WORKOUT_CODEC_T *codec, uint32 time);
+uint8 WorkoutEncodeRecord(WORKOUT_CODEC_T *codec, const WORKOUT_STRIDE_T *stride, uint8 *buff);
+uint8 WorkoutDecodeRecord(WORKOUT_CODEC_T *codec, const uint8 *buff, uint8 size, WORKOUT_STRIDE_T *stride);
+uint8 WorkoutPageIsValid(const WORKOUT_PAGE_T *page);
+
+
+/***************************************
+* External data references
+***************************************/
+extern const uint8              workoutRows[WORKOUT_ROWS * CY_FLASH_SIZEOF_ROW];
+extern uint16                   workoutId;
+extern uint16                   workoutPages;
+extern uint16                   workoutWriteErrors;
+extern uint32                   workoutStrides;
+extern uint32                   workoutBytes;
+
+
+/* [] END OF FILE */